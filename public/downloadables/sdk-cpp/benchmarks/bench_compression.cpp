@@ -0,0 +1,87 @@
+// Bytes on the wire and end-to-end latency of a response with and without
+// gzip transfer encoding. curl inflates responses with zlib as they stream
+// in; this runs the same inflate + parse on recorded payloads and adds the
+// transfer time of a link, so no server is needed.
+//
+// Usage: bench_compression [--mbps N] [--rtt-ms N] [name=path ...]
+
+#include "bench_util.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <zlib.h>
+
+namespace {
+
+std::string gzip(const std::string& input, int level) {
+    z_stream stream{};
+    deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+    std::string out(deflateBound(&stream, static_cast<uLong>(input.size())), '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    stream.avail_out = static_cast<uInt>(out.size());
+    deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return out;
+}
+
+// Inflates in 16 KiB pieces, the way curl hands decoded chunks to the parser
+std::string gunzip(const std::string& input) {
+    z_stream stream{};
+    inflateInit2(&stream, 15 + 16);
+    std::string out;
+    char chunk[16 * 1024];
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    int status = Z_OK;
+    while (status == Z_OK) {
+        stream.next_out = reinterpret_cast<Bytef*>(chunk);
+        stream.avail_out = sizeof(chunk);
+        status = inflate(&stream, Z_NO_FLUSH);
+        out.append(chunk, sizeof(chunk) - stream.avail_out);
+    }
+    inflateEnd(&stream);
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double mbps = 50.0;
+    double rttMs = 40.0;
+    std::vector<char*> rest{argv[0]};
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--mbps") == 0 && i + 1 < argc) {
+            mbps = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--rtt-ms") == 0 && i + 1 < argc) {
+            rttMs = std::atof(argv[++i]);
+        } else {
+            rest.push_back(argv[i]);
+        }
+    }
+    auto transferMs = [&](std::size_t bytes) { return rttMs + bytes * 8.0 / (mbps * 1000.0); };
+
+    std::printf("link: %.0f Mbit/s, %.0f ms RTT\n\n", mbps, rttMs);
+    std::printf("%-12s %12s %12s %7s %10s %10s %12s %12s\n", "payload", "identity B", "gzip B", "ratio",
+                "parse ms", "gunzip ms", "e2e plain", "e2e gzip");
+    for (const bench::Payload& payload : bench::payloads(static_cast<int>(rest.size()), rest.data())) {
+        std::string compressed = gzip(payload.text, Z_DEFAULT_COMPRESSION);
+        int iterations = payload.text.size() > (4 << 20) ? 5 : 20;
+
+        double parseMs = bench::millisPerRun([&] { bench::keep(bench::json::parse(payload.text).size()); }, iterations);
+        double inflateMs = bench::millisPerRun([&] { bench::keep(gunzip(compressed).size()); }, iterations);
+
+        std::printf("%-12s %12zu %12zu %6.1fx %10.2f %10.2f %10.1fms %10.1fms\n", payload.name.c_str(),
+                    payload.text.size(), compressed.size(), double(payload.text.size()) / compressed.size(),
+                    parseMs, inflateMs, transferMs(payload.text.size()) + parseMs,
+                    transferMs(compressed.size()) + inflateMs + parseMs);
+    }
+
+    // Request side: a Games::create body, gzip-encoded once it passes the threshold
+    std::string body = bench::syntheticGames(1)[0].dump();
+    double compressMs = bench::millisPerRun([&] { bench::keep(gzip(body, Z_DEFAULT_COMPRESSION).size()); }, 2000);
+    std::printf("\nGames::create body: %zu B, gzip %zu B in %.3f ms\n", body.size(),
+                gzip(body, Z_DEFAULT_COMPRESSION).size(), compressMs);
+    return 0;
+}
@@ -0,0 +1,71 @@
+// The InventoryTable kernels against the same loops over a
+// std::vector<InventoryItem>, on an /inventory payload.
+//
+// Usage: bench_inventory_table [inventory=path]
+
+#include "bench_util.hpp"
+#include <unordered_map>
+
+using namespace CroissantAPI;
+
+int main(int argc, char** argv) {
+    std::vector<bench::Payload> all = bench::payloads(argc, argv);
+    const bench::Payload* payload = &all.back();
+    for (const bench::Payload& candidate : all) {
+        if (candidate.name == "inventory") payload = &candidate;
+    }
+
+    bench::json body = bench::json::parse(payload->text);
+    const bench::json& rows = body.is_object() ? body["inventory"] : body;
+    std::vector<InventoryItem> items;
+    InventoryTable table;
+    items.reserve(rows.size());
+    table.reserve(rows.size());
+    for (const bench::json& row : rows) {
+        items.emplace_back(row);
+        table.append(items.back());
+    }
+    int iterations = 200;
+
+    auto report = [&](const char* kernel, double vectorMs, double tableMs) {
+        std::printf("%-22s %10.3f %10.3f %7.1fx\n", kernel, vectorMs, tableMs, vectorMs / tableMs);
+    };
+    std::printf("%zu rows\n\n%-22s %10s %10s %8s\n", items.size(), "kernel", "vector ms", "table ms", "speedup");
+
+    report("totalValue()",
+           bench::millisPerRun([&] {
+               double total = 0;
+               for (const InventoryItem& item : items) total += item.price * item.amount;
+               bench::keep(static_cast<std::size_t>(total));
+           }, iterations),
+           bench::millisPerRun([&] { bench::keep(static_cast<std::size_t>(table.totalValue())); }, iterations));
+
+    report("totalValue(true)",
+           bench::millisPerRun([&] {
+               double total = 0;
+               for (const InventoryItem& item : items) {
+                   if (item.showInStore) total += item.price * item.amount;
+               }
+               bench::keep(static_cast<std::size_t>(total));
+           }, iterations),
+           bench::millisPerRun([&] { bench::keep(static_cast<std::size_t>(table.totalValue(true))); }, iterations));
+
+    report("filterShowInStore",
+           bench::millisPerRun([&] {
+               std::vector<std::uint32_t> shown;
+               for (std::size_t i = 0; i < items.size(); ++i) {
+                   if (items[i].showInStore) shown.push_back(static_cast<std::uint32_t>(i));
+               }
+               bench::keep(shown.size());
+           }, iterations),
+           bench::millisPerRun([&] { bench::keep(table.filterShowInStore(true).size()); }, iterations));
+
+    report("valueByOwner",
+           bench::millisPerRun([&] {
+               std::unordered_map<std::string, double> byOwner;
+               for (const InventoryItem& item : items) byOwner[item.owner] += item.price * item.amount;
+               bench::keep(byOwner.size());
+           }, iterations),
+           bench::millisPerRun([&] { bench::keep(table.valueByOwner().size()); }, iterations));
+    return 0;
+}
@@ -0,0 +1,62 @@
+// Throughput of projected parsing (listAs<GamePrice>, getAs<ItemAmount>)
+// against full materialization (list(), get()). The full path parses the
+// whole document and converts every element; the projected path walks the
+// raw array and parses only the projection's fields, as collectProjected does.
+//
+// Usage: bench_projection [games=path] [inventory=path]
+
+#include "bench_util.hpp"
+
+using namespace CroissantAPI;
+
+namespace {
+
+template <typename Full, typename Projection>
+void compare(const std::string& name, const std::string& text, const std::string& arrayKey) {
+    std::string_view array = text;
+    if (!arrayKey.empty()) {
+        detail::forEachMember(text, [&](std::string_view key, std::string_view value) {
+            if (key == arrayKey) array = value;
+        });
+    }
+    int iterations = text.size() > (4 << 20) ? 5 : 20;
+
+    double fullMs = bench::millisPerRun([&] {
+        json document = json::parse(text);
+        const json& elements = arrayKey.empty() ? document : document[arrayKey];
+        std::vector<Full> values;
+        values.reserve(elements.size());
+        for (const json& element : elements) values.emplace_back(element);
+        bench::keep(values.size());
+    }, iterations);
+
+    std::size_t rows = 0;
+    double projectedMs = bench::millisPerRun([&] {
+        std::vector<Projection> values;
+        for (std::string_view element : detail::arrayElements(array)) {
+            Projection projected;
+            detail::readProjected(element, projected);
+            values.push_back(std::move(projected));
+        }
+        rows = values.size();
+        bench::keep(rows);
+    }, iterations);
+
+    double megabytes = text.size() / 1e6;
+    std::printf("%-12s %8zu rows  full %8.2f ms (%6.1f MB/s)  projected %8.2f ms (%6.1f MB/s)  %.1fx\n",
+                name.c_str(), rows, fullMs, megabytes / (fullMs / 1000), projectedMs,
+                megabytes / (projectedMs / 1000), fullMs / projectedMs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    for (const bench::Payload& payload : bench::payloads(argc, argv)) {
+        if (payload.name == "games") {
+            compare<Game, GamePrice>("games", payload.text, "");
+        } else if (payload.name == "inventory") {
+            compare<InventoryItem, ItemAmount>("inventory", payload.text, "inventory");
+        }
+    }
+    return 0;
+}
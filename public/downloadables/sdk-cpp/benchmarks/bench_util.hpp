@@ -0,0 +1,139 @@
+#pragma once
+// Shared helpers for the SDK benchmarks: timing, and the payloads they run on.
+// Every benchmark takes recorded response bodies as `name=path` arguments
+// (e.g. `games=games.json`, saved with `curl -o`); without arguments it runs
+// on synthetic payloads shaped like the API's responses.
+
+#include "croissant_api.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+using json = nlohmann::json;
+
+struct Payload {
+    std::string name;
+    std::string text;
+};
+
+// Average milliseconds per call of `run`, after one warm-up call
+template <typename F>
+double millisPerRun(F&& run, int iterations) {
+    run();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        run();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+inline volatile std::size_t sink;
+
+// Keeps the optimizer from dropping the work behind a result
+inline void keep(std::size_t value) {
+    sink = value;
+}
+
+inline std::string randomText(std::mt19937& rng, std::size_t length) {
+    static const char* words[] = {"craft", "quest", "pixel", "dragon", "forge", "ember", "rune", "castle",
+                                  "shadow", "legend", "croissant", "arena", "storm", "relic", "guild"};
+    std::string text;
+    while (text.size() < length) {
+        if (!text.empty()) text.push_back(' ');
+        text.append(words[rng() % 15]);
+    }
+    return text;
+}
+
+inline std::string hexId(std::mt19937& rng) {
+    static const char digits[] = "0123456789abcdef";
+    std::string id;
+    for (int i = 0; i < 32; ++i) {
+        id.push_back(digits[rng() % 16]);
+        if (i == 7 || i == 11 || i == 15 || i == 19) id.push_back('-');
+    }
+    return id;
+}
+
+// GET /games
+inline json syntheticGames(std::size_t count) {
+    std::mt19937 rng(1);
+    json games = json::array();
+    for (std::size_t i = 0; i < count; ++i) {
+        games.push_back({{"gameId", hexId(rng)}, {"name", randomText(rng, 20)},
+                         {"description", randomText(rng, 400)}, {"price", (rng() % 5000) / 100.0},
+                         {"owner_id", hexId(rng)}, {"showInStore", rng() % 2}, {"iconHash", hexId(rng)},
+                         {"bannerHash", hexId(rng)}, {"genre", randomText(rng, 8)},
+                         {"release_date", "2024-05-17"}, {"developer", randomText(rng, 12)},
+                         {"publisher", randomText(rng, 12)}, {"platforms", {"windows", "linux"}},
+                         {"rating", (rng() % 50) / 10.0}, {"website", "https://example.com"},
+                         {"trailer_link", nullptr}, {"multiplayer", rng() % 2}});
+    }
+    return games;
+}
+
+// GET /items
+inline json syntheticItems(std::size_t count) {
+    std::mt19937 rng(2);
+    json items = json::array();
+    for (std::size_t i = 0; i < count; ++i) {
+        items.push_back({{"itemId", hexId(rng)}, {"name", randomText(rng, 16)},
+                         {"description", randomText(rng, 160)}, {"owner", hexId(rng)},
+                         {"price", (rng() % 1000) / 10.0}, {"iconHash", hexId(rng)},
+                         {"showInStore", rng() % 2}, {"deleted", 0}});
+    }
+    return items;
+}
+
+// GET /inventory/:userId
+inline json syntheticInventory(std::size_t count) {
+    std::mt19937 rng(3);
+    std::vector<std::string> owners;
+    for (int i = 0; i < 32; ++i) owners.push_back(hexId(rng));
+    json inventory = json::array();
+    for (std::size_t i = 0; i < count; ++i) {
+        json row = {{"user_id", "user-1"}, {"item_id", hexId(rng)}, {"itemId", hexId(rng)},
+                    {"name", randomText(rng, 16)}, {"description", randomText(rng, 160)},
+                    {"amount", 1 + rng() % 50}, {"iconHash", hexId(rng)}, {"sellable", rng() % 2},
+                    {"purchasePrice", nullptr}, {"owner", owners[rng() % owners.size()]},
+                    {"price", (rng() % 1000) / 10.0}, {"showInStore", rng() % 2}};
+        if (rng() % 8 == 0) {
+            row["metadata"] = {{"_unique_id", hexId(rng)}, {"level", rng() % 100}};
+        }
+        inventory.push_back(std::move(row));
+    }
+    return json{{"user_id", "user-1"}, {"inventory", std::move(inventory)}};
+}
+
+// Recorded payloads named on the command line, or the synthetic set
+inline std::vector<Payload> payloads(int argc, char** argv) {
+    std::vector<Payload> out;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        auto equals = argument.find('=');
+        std::string path = equals == std::string::npos ? argument : argument.substr(equals + 1);
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "cannot read %s\n", path.c_str());
+            continue;
+        }
+        out.push_back({equals == std::string::npos ? path : argument.substr(0, equals),
+                       std::string(std::istreambuf_iterator<char>(file), {})});
+    }
+    if (out.empty()) {
+        out.push_back({"games", syntheticGames(2000).dump()});
+        out.push_back({"items", syntheticItems(5000).dump()});
+        out.push_back({"inventory", syntheticInventory(20000).dump()});
+    }
+    return out;
+}
+
+} // namespace bench
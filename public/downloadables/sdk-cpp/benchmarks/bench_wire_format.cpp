@@ -0,0 +1,26 @@
+// Size and decode time of each endpoint's response in JSON, MessagePack and
+// CBOR, the formats setWireFormat() negotiates. Binary bodies are produced
+// from the recorded JSON, as a server answering in them would send.
+//
+// Usage: bench_wire_format [name=path ...]
+
+#include "bench_util.hpp"
+
+int main(int argc, char** argv) {
+    std::printf("%-12s %10s %10s %10s %10s %10s %10s\n", "payload", "json B", "msgpack B", "cbor B",
+                "json ms", "msgpack ms", "cbor ms");
+    for (const bench::Payload& payload : bench::payloads(argc, argv)) {
+        bench::json document = bench::json::parse(payload.text);
+        std::vector<std::uint8_t> msgpack = bench::json::to_msgpack(document);
+        std::vector<std::uint8_t> cbor = bench::json::to_cbor(document);
+        int iterations = payload.text.size() > (4 << 20) ? 5 : 20;
+
+        double jsonMs = bench::millisPerRun([&] { bench::keep(bench::json::parse(payload.text).size()); }, iterations);
+        double msgpackMs = bench::millisPerRun([&] { bench::keep(bench::json::from_msgpack(msgpack).size()); }, iterations);
+        double cborMs = bench::millisPerRun([&] { bench::keep(bench::json::from_cbor(cbor).size()); }, iterations);
+
+        std::printf("%-12s %10zu %10zu %10zu %10.2f %10.2f %10.2f\n", payload.name.c_str(), payload.text.size(),
+                    msgpack.size(), cbor.size(), jsonMs, msgpackMs, cborMs);
+    }
+    return 0;
+}
@@ -1,1198 +1,6210 @@
-#include "croissant_api_new.hpp"
+#include "croissant_api.hpp"
 #include <stdexcept>
-#include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <thread>
+#include <curl/curl.h>
+#include <zlib.h>
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
 
 using namespace CroissantAPI;
 
-// Utility function for URL encoding
-std::string Client::urlEncode(const std::string& str) const {
-    std::ostringstream encoded;
-    for (char c : str) {
-        if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
-            encoded << c;
-        } else {
-            encoded << '%' << std::hex << std::uppercase << static_cast<unsigned char>(c);
-        }
+namespace {
+
+const char* mediaType(WireFormat format) {
+    switch (format) {
+        case WireFormat::MessagePack: return "application/msgpack";
+        case WireFormat::Cbor: return "application/cbor";
+        default: return "application/json";
     }
-    return encoded.str();
 }
 
-// Helper method to make HTTP requests
-APIResponse Client::makeRequest(const std::string& method, const std::string& endpoint, 
-                               const json& body, bool requireAuth) const {
-    if (requireAuth && token.empty()) {
-        throw std::runtime_error("Token is required for this operation");
-    }
+WireFormat formatOf(const std::string& contentType) {
+    if (contentType.find("msgpack") != std::string::npos) return WireFormat::MessagePack;
+    if (contentType.find("cbor") != std::string::npos) return WireFormat::Cbor;
+    return WireFormat::Json;
+}
 
-    std::string url = base_url + endpoint;
-    cpr::Header headers = {{"Content-Type", "application/json"}};
-    
-    if (!token.empty()) {
-        headers["Authorization"] = "Bearer " + token;
-    }
+} // namespace
 
-    cpr::Response response;
-    
-    if (method == "GET") {
-        response = cpr::Get(cpr::Url{url}, headers);
-    } else if (method == "POST") {
-        response = cpr::Post(cpr::Url{url}, headers, cpr::Body{body.dump()});
-    } else if (method == "PUT") {
-        response = cpr::Put(cpr::Url{url}, headers, cpr::Body{body.dump()});
-    } else if (method == "DELETE") {
-        response = cpr::Delete(cpr::Url{url}, headers);
-    } else if (method == "PATCH") {
-        response = cpr::Patch(cpr::Url{url}, headers, cpr::Body{body.dump()});
+namespace {
+
+// RFC 3986 unreserved characters, which percent-encoding leaves as they are
+constexpr std::array<bool, 256> unreservedTable = [] {
+    std::array<bool, 256> table{};
+    for (int c = '0'; c <= '9'; ++c) table[c] = true;
+    for (int c = 'A'; c <= 'Z'; ++c) table[c] = true;
+    for (int c = 'a'; c <= 'z'; ++c) table[c] = true;
+    table['-'] = table['_'] = table['.'] = table['~'] = true;
+    return table;
+}();
+
+#if defined(__SSE2__) || defined(_M_X64)
+// Bit i is set when byte i of `block` is unreserved. Bytes >= 0x80 compare
+// as negative and never fall inside the ranges.
+inline int unreservedMask(__m128i block) {
+    auto inRange = [block](char lo, char hi) {
+        return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                             _mm_cmplt_epi8(block, _mm_set1_epi8(static_cast<char>(hi + 1))));
+    };
+    __m128i keep = _mm_or_si128(_mm_or_si128(inRange('0', '9'), inRange('A', 'Z')), inRange('a', 'z'));
+    keep = _mm_or_si128(keep, _mm_cmpeq_epi8(block, _mm_set1_epi8('-')));
+    keep = _mm_or_si128(keep, _mm_cmpeq_epi8(block, _mm_set1_epi8('_')));
+    keep = _mm_or_si128(keep, _mm_cmpeq_epi8(block, _mm_set1_epi8('.')));
+    keep = _mm_or_si128(keep, _mm_cmpeq_epi8(block, _mm_set1_epi8('~')));
+    return _mm_movemask_epi8(keep);
+}
+#endif
+
+inline char* encodeByte(unsigned char c, char* out) {
+    static const char hex[] = "0123456789ABCDEF";
+    if (unreservedTable[c]) {
+        *out++ = static_cast<char>(c);
     } else {
-        return APIResponse(false, "Unsupported HTTP method");
+        *out++ = '%';
+        *out++ = hex[c >> 4];
+        *out++ = hex[c & 0xF];
     }
+    return out;
+}
 
-    bool success = response.status_code >= 200 && response.status_code < 300;
-    std::string message = success ? "Success" : "Request failed";
-    
-    json responseData = json::object();
-    if (!response.text.empty()) {
-        try {
-            responseData = json::parse(response.text);
-            if (responseData.contains("message")) {
-                message = responseData["message"];
-            }
-        } catch (const json::exception&) {
-            message = response.text;
+} // namespace
+
+void detail::percentEncode(std::string_view text, std::string& out) {
+    std::size_t start = out.size();
+    out.resize(start + text.size() * 3);
+    char* dst = &out[0] + start;
+    const char* src = text.data();
+    std::size_t n = text.size();
+    std::size_t i = 0;
+
+#if defined(__SSE2__) || defined(_M_X64)
+    // Runs of unreserved bytes (the common case for IDs and search terms) are
+    // copied 16 at a time
+    for (; i + 16 <= n; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        int mask = unreservedMask(block);
+        if (mask == 0xFFFF) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), block);
+            dst += 16;
+            continue;
+        }
+        for (std::size_t j = 0; j < 16; ++j) {
+            dst = encodeByte(static_cast<unsigned char>(src[i + j]), dst);
         }
     }
+#endif
 
-    return APIResponse(success, message, responseData);
+    for (; i < n; ++i) {
+        dst = encodeByte(static_cast<unsigned char>(src[i]), dst);
+    }
+    out.resize(static_cast<std::size_t>(dst - out.data()));
+}
+
+// Utility function for URL encoding
+std::string Client::urlEncode(const std::string& str) const {
+    std::string encoded;
+    detail::percentEncode(str, encoded);
+    return encoded;
 }
 
-// Struct constructors and converters
+// Common request headers, including the bearer token when one is set
+void Client::prepareHeaders() {
+    jsonHeaders = cpr::Header{{"Content-Type", "application/json"}};
+    if (!token.empty()) {
+        jsonHeaders["Authorization"] = "Bearer " + token;
+    }
 
-// LobbyUser
-LobbyUser::LobbyUser(const json& j) {
-    username = j.value("username", "");
-    user_id = j.value("user_id", "");
-    verified = j.value("verified", false);
-    
-    steam_username = j.contains("steam_username") && !j["steam_username"].is_null() 
-        ? std::optional<std::string>(j["steam_username"]) : std::nullopt;
-    steam_avatar_url = j.contains("steam_avatar_url") && !j["steam_avatar_url"].is_null()
-        ? std::optional<std::string>(j["steam_avatar_url"]) : std::nullopt;
-    steam_id = j.contains("steam_id") && !j["steam_id"].is_null()
-        ? std::optional<std::string>(j["steam_id"]) : std::nullopt;
+    negotiatedHeaders = jsonHeaders;
+    if (wireFormat != WireFormat::Json) {
+        negotiatedHeaders["Accept"] = std::string(mediaType(wireFormat)) + ", application/json;q=0.5";
+    }
 }
 
-json LobbyUser::to_json() const {
-    json j = {
-        {"username", username},
-        {"user_id", user_id},
-        {"verified", verified}
-    };
-    if (steam_username) j["steam_username"] = *steam_username;
-    if (steam_avatar_url) j["steam_avatar_url"] = *steam_avatar_url;
-    if (steam_id) j["steam_id"] = *steam_id;
-    return j;
+// Content codings to advertise; libcurl decodes them while the body streams in
+cpr::AcceptEncoding Client::acceptEncoding() const {
+    if (!acceptCompression) {
+        return cpr::AcceptEncoding{{"identity"}};
+    }
+
+    static const cpr::AcceptEncoding supported = [] {
+        const curl_version_info_data* info = curl_version_info(CURLVERSION_NOW);
+        bool brotli = false;
+        bool zstd = false;
+#ifdef CURL_VERSION_BROTLI
+        brotli = (info->features & CURL_VERSION_BROTLI) != 0;
+#endif
+#ifdef CURL_VERSION_ZSTD
+        zstd = (info->features & CURL_VERSION_ZSTD) != 0;
+#endif
+        if (zstd && brotli) return cpr::AcceptEncoding{{"zstd", "br", "gzip", "deflate"}};
+        if (zstd) return cpr::AcceptEncoding{{"zstd", "gzip", "deflate"}};
+        if (brotli) return cpr::AcceptEncoding{{"br", "gzip", "deflate"}};
+        return cpr::AcceptEncoding{{"gzip", "deflate"}};
+    }();
+    return supported;
 }
 
-// StudioUser
-StudioUser::StudioUser(const json& j) {
-    user_id = j.value("user_id", "");
-    username = j.value("username", "");
-    verified = j.value("verified", false);
-    admin = j.value("admin", false);
+namespace {
+
+std::string gzipCompress(std::string_view input) {
+    z_stream stream{};
+    // 15 window bits + 16 selects the gzip wrapper, which body parsers inflate natively
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("Failed to initialize gzip compression");
+    }
+
+    std::string output;
+    output.resize(deflateBound(&stream, static_cast<uLong>(input.size())));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+    stream.avail_out = static_cast<uInt>(output.size());
+
+    int result = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END) {
+        throw std::runtime_error("Failed to gzip request body");
+    }
+    output.resize(stream.total_out);
+    return output;
 }
 
-json StudioUser::to_json() const {
-    return {
-        {"user_id", user_id},
-        {"username", username},
-        {"verified", verified},
-        {"admin", admin}
-    };
+} // namespace
+
+std::string Client::encodeBody(const json& body, cpr::Header& headers, bool binary) const {
+    std::string payload;
+    if (binary && wireFormat == WireFormat::MessagePack) {
+        std::vector<std::uint8_t> bytes = json::to_msgpack(body);
+        payload.assign(bytes.begin(), bytes.end());
+    } else if (binary && wireFormat == WireFormat::Cbor) {
+        std::vector<std::uint8_t> bytes = json::to_cbor(body);
+        payload.assign(bytes.begin(), bytes.end());
+    } else {
+        payload = body.dump();
+    }
+    if (binary) {
+        headers["Content-Type"] = mediaType(wireFormat);
+    }
+
+    if (requestCompressionThreshold > 0 && payload.size() >= requestCompressionThreshold) {
+        headers["Content-Encoding"] = "gzip";
+        return gzipCompress(payload);
+    }
+    return payload;
 }
 
-// TradeItemDetail
-TradeItemDetail::TradeItemDetail(const json& j) {
-    itemId = j.value("itemId", "");
-    name = j.value("name", "");
-    description = j.value("description", "");
-    iconHash = j.value("iconHash", "");
-    amount = j.value("amount", 0);
+namespace {
+
+// Decodes a response body without throwing; false when it is malformed
+bool decodeBody(const std::string& text, const std::string& contentType, json& out) {
+    switch (formatOf(contentType)) {
+        case WireFormat::MessagePack:
+            out = json::from_msgpack(text, true, false);
+            break;
+        case WireFormat::Cbor:
+            out = json::from_cbor(text, true, false);
+            break;
+        default:
+            out = json::parse(text, nullptr, false);
+            break;
+    }
+    return !out.is_discarded();
 }
 
-json TradeItemDetail::to_json() const {
-    return {
-        {"itemId", itemId},
-        {"name", name},
-        {"description", description},
-        {"iconHash", iconHash},
-        {"amount", amount}
-    };
+const std::string* messageOf(const json& data) {
+    if (!data.is_object()) return nullptr;
+    auto it = data.find("message");
+    return it != data.end() && it->is_string() ? &it->get_ref<const std::string&>() : nullptr;
 }
 
-// TradeItem
-TradeItem::TradeItem(const json& j) {
-    itemId = j.value("itemId", "");
-    amount = j.value("amount", 0);
-    
-    if (j.contains("metadata") && !j["metadata"].is_null()) {
-        std::unordered_map<std::string, json> meta;
-        for (auto& [key, value] : j["metadata"].items()) {
-            meta[key] = value;
+// Outcome of a completed HTTP exchange for the try* style APIs
+Result<json> resultOf(long status, const std::string& text, const std::string& contentType) {
+    json data = json::object();
+    bool decoded = text.empty() || decodeBody(text, contentType, data);
+    if (status >= 200 && status < 300) {
+        if (!decoded) {
+            return Error{ErrorCode::Parse, status, "Malformed response body"};
         }
-        metadata = meta;
+        return Result<json>(std::move(data));
     }
+
+    ErrorCode code = status == 401 || status == 403 ? ErrorCode::Auth : ErrorCode::HttpStatus;
+    const std::string* serverMessage = decoded ? messageOf(data) : nullptr;
+    return Error{code, status, serverMessage ? *serverMessage : decoded ? "Request failed" : text};
 }
 
-json TradeItem::to_json() const {
-    json j = {
-        {"itemId", itemId},
-        {"amount", amount}
-    };
-    if (metadata) {
-        json metaJson = json::object();
-        for (const auto& [key, value] : *metadata) {
-            metaJson[key] = value;
+} // namespace
+
+// Turn a status code and raw body into an APIResponse
+APIResponse Client::buildResponse(long statusCode, const std::string& text, const std::string& contentType) {
+    bool success = statusCode >= 200 && statusCode < 300;
+    std::string message = success ? "Success" : "Request failed";
+    
+    json responseData = json::object();
+    if (!text.empty()) {
+        if (!decodeBody(text, contentType, responseData)) {
+            responseData = json::object();
+            message = text;
+        } else if (const std::string* serverMessage = messageOf(responseData)) {
+            message = *serverMessage;
         }
-        j["metadata"] = metaJson;
     }
-    return j;
+
+    return APIResponse(success, std::move(message), std::move(responseData));
 }
 
-// Game
-Game::Game(const json& j) {
-    gameId = j.value("gameId", "");
-    name = j.value("name", "");
-    description = j.value("description", "");
-    price = j.value("price", 0.0);
-    owner_id = j.value("owner_id", "");
-    showInStore = j.value("showInStore", false);
-    rating = j.value("rating", 0.0);
-    multiplayer = j.value("multiplayer", false);
-    
-    iconHash = j.contains("iconHash") && !j["iconHash"].is_null() 
-        ? std::optional<std::string>(j["iconHash"]) : std::nullopt;
-    splashHash = j.contains("splashHash") && !j["splashHash"].is_null()
-        ? std::optional<std::string>(j["splashHash"]) : std::nullopt;
-    bannerHash = j.contains("bannerHash") && !j["bannerHash"].is_null()
-        ? std::optional<std::string>(j["bannerHash"]) : std::nullopt;
-    genre = j.contains("genre") && !j["genre"].is_null()
-        ? std::optional<std::string>(j["genre"]) : std::nullopt;
-    release_date = j.contains("release_date") && !j["release_date"].is_null()
-        ? std::optional<std::string>(j["release_date"]) : std::nullopt;
-    developer = j.contains("developer") && !j["developer"].is_null()
-        ? std::optional<std::string>(j["developer"]) : std::nullopt;
-    publisher = j.contains("publisher") && !j["publisher"].is_null()
-        ? std::optional<std::string>(j["publisher"]) : std::nullopt;
-    website = j.contains("website") && !j["website"].is_null()
-        ? std::optional<std::string>(j["website"]) : std::nullopt;
-    trailer_link = j.contains("trailer_link") && !j["trailer_link"].is_null()
-        ? std::optional<std::string>(j["trailer_link"]) : std::nullopt;
-    download_link = j.contains("download_link") && !j["download_link"].is_null()
-        ? std::optional<std::string>(j["download_link"]) : std::nullopt;
-    
-    if (j.contains("platforms") && j["platforms"].is_array()) {
-        std::vector<std::string> plat;
-        for (const auto& platform : j["platforms"]) {
-            plat.push_back(platform);
-        }
-        platforms = plat;
+namespace {
+
+// Issues the request through cpr; false when the method is not supported.
+// `body` is a cpr::Body, or a cpr::ReadCallback for bodies cpr must not copy;
+// `options` are passed through to cpr (e.g. a cpr::WriteCallback).
+template <typename Body, typename... Options>
+bool dispatch(const std::string& method, const std::string& url, const cpr::Header& headers,
+              Body body, const cpr::AcceptEncoding& encoding, cpr::Response& response,
+              const Options&... options) {
+    if (method == "GET") {
+        response = cpr::Get(cpr::Url{url}, headers, encoding, options...);
+    } else if (method == "POST") {
+        response = cpr::Post(cpr::Url{url}, headers, std::move(body), encoding, options...);
+    } else if (method == "PUT") {
+        response = cpr::Put(cpr::Url{url}, headers, std::move(body), encoding, options...);
+    } else if (method == "DELETE") {
+        response = cpr::Delete(cpr::Url{url}, headers, encoding, options...);
+    } else if (method == "PATCH") {
+        response = cpr::Patch(cpr::Url{url}, headers, std::move(body), encoding, options...);
+    } else {
+        return false;
     }
+    return true;
 }
 
-json Game::to_json() const {
-    json j = {
-        {"gameId", gameId},
-        {"name", name},
-        {"description", description},
-        {"price", price},
-        {"owner_id", owner_id},
-        {"showInStore", showInStore},
-        {"rating", rating},
-        {"multiplayer", multiplayer}
-    };
-    
-    if (iconHash) j["iconHash"] = *iconHash;
-    if (splashHash) j["splashHash"] = *splashHash;
-    if (bannerHash) j["bannerHash"] = *bannerHash;
-    if (genre) j["genre"] = *genre;
-    if (release_date) j["release_date"] = *release_date;
-    if (developer) j["developer"] = *developer;
-    if (publisher) j["publisher"] = *publisher;
-    if (website) j["website"] = *website;
-    if (trailer_link) j["trailer_link"] = *trailer_link;
-    if (download_link) j["download_link"] = *download_link;
-    if (platforms) j["platforms"] = *platforms;
-    
-    return j;
-}
+// Streams a caller-owned body to curl, which then reads it in place instead
+// of from a copy held by cpr::Body
+struct BodyReader {
+    std::string_view body;
+    std::size_t sent = 0;
+};
 
-// User
-User::User(const json& j) {
-    userId = j.value("userId", "");
-    username = j.value("username", "");
-    verified = j.value("verified", false);
-    
-    email = j.contains("email") && !j["email"].is_null()
-        ? std::optional<std::string>(j["email"]) : std::nullopt;
-    verificationKey = j.contains("verificationKey") && !j["verificationKey"].is_null()
-        ? std::optional<std::string>(j["verificationKey"]) : std::nullopt;
-    steam_id = j.contains("steam_id") && !j["steam_id"].is_null()
-        ? std::optional<std::string>(j["steam_id"]) : std::nullopt;
-    steam_username = j.contains("steam_username") && !j["steam_username"].is_null()
-        ? std::optional<std::string>(j["steam_username"]) : std::nullopt;
-    steam_avatar_url = j.contains("steam_avatar_url") && !j["steam_avatar_url"].is_null()
-        ? std::optional<std::string>(j["steam_avatar_url"]) : std::nullopt;
-    google_id = j.contains("google_id") && !j["google_id"].is_null()
-        ? std::optional<std::string>(j["google_id"]) : std::nullopt;
-    discord_id = j.contains("discord_id") && !j["discord_id"].is_null()
-        ? std::optional<std::string>(j["discord_id"]) : std::nullopt;
-    
-    isStudio = j.contains("isStudio") ? std::optional<bool>(j["isStudio"]) : std::nullopt;
-    admin = j.contains("admin") ? std::optional<bool>(j["admin"]) : std::nullopt;
-    disabled = j.contains("disabled") ? std::optional<bool>(j["disabled"]) : std::nullopt;
-    haveAuthenticator = j.contains("haveAuthenticator") ? std::optional<bool>(j["haveAuthenticator"]) : std::nullopt;
-    balance = j.contains("balance") ? std::optional<double>(j["balance"]) : std::nullopt;
-    
-    // Note: Complex nested objects like studios, roles, inventory etc. would need 
-    // additional parsing logic here if needed
+cpr::ReadCallback readerOf(BodyReader& reader) {
+    // Capturing only a reference keeps the callback within std::function's inline storage
+    return cpr::ReadCallback{static_cast<cpr::cpr_off_t>(reader.body.size()),
+                             [&reader](char* buffer, size_t& size, intptr_t) {
+                                 size = std::min(size, reader.body.size() - reader.sent);
+                                 std::memcpy(buffer, reader.body.data() + reader.sent, size);
+                                 reader.sent += size;
+                                 return true;
+                             }};
 }
 
-json User::to_json() const {
-    json j = {
-        {"userId", userId},
-        {"username", username},
-        {"verified", verified}
-    };
-    
-    if (email) j["email"] = *email;
-    if (verificationKey) j["verificationKey"] = *verificationKey;
-    if (steam_id) j["steam_id"] = *steam_id;
-    if (steam_username) j["steam_username"] = *steam_username;
-    if (steam_avatar_url) j["steam_avatar_url"] = *steam_avatar_url;
-    if (google_id) j["google_id"] = *google_id;
-    if (discord_id) j["discord_id"] = *discord_id;
-    if (isStudio) j["isStudio"] = *isStudio;
-    if (admin) j["admin"] = *admin;
-    if (disabled) j["disabled"] = *disabled;
-    if (haveAuthenticator) j["haveAuthenticator"] = *haveAuthenticator;
-    if (balance) j["balance"] = *balance;
-    
-    return j;
+// Per-thread scratch buffer for request bodies written with detail::JsonWriter.
+// It is cleared on each use but keeps its capacity, so steady-state calls do
+// not allocate while serializing.
+std::string& requestBuffer() {
+    thread_local std::string buffer;
+    buffer.clear();
+    return buffer;
 }
 
-// Item
-Item::Item(const json& j) {
-    itemId = j.value("itemId", "");
-    name = j.value("name", "");
-    description = j.value("description", "");
-    owner = j.value("owner", "");
-    price = j.value("price", 0.0);
-    iconHash = j.value("iconHash", "");
-    
-    showInStore = j.contains("showInStore") ? std::optional<bool>(j["showInStore"]) : std::nullopt;
-    deleted = j.contains("deleted") ? std::optional<bool>(j["deleted"]) : std::nullopt;
-}
+} // namespace
 
-json Item::to_json() const {
-    json j = {
-        {"itemId", itemId},
-        {"name", name},
-        {"description", description},
-        {"owner", owner},
-        {"price", price},
-        {"iconHash", iconHash}
-    };
-    
-    if (showInStore) j["showInStore"] = *showInStore;
-    if (deleted) j["deleted"] = *deleted;
-    
-    return j;
-}
+// Helper method to make HTTP requests
+APIResponse Client::makeRequest(const std::string& method, const std::string& endpoint, 
+                               const json& body, bool requireAuth) const {
+    if (requireAuth && token.empty()) {
+        throw std::runtime_error("Token is required for this operation");
+    }
 
-// InventoryItem
-InventoryItem::InventoryItem(const json& j) {
-    amount = j.value("amount", 0);
-    itemId = j.value("itemId", "");
-    name = j.value("name", "");
-    description = j.value("description", "");
-    iconHash = j.value("iconHash", "");
-    price = j.value("price", 0.0);
-    owner = j.value("owner", "");
-    showInStore = j.value("showInStore", false);
-    
-    user_id = j.contains("user_id") && !j["user_id"].is_null()
-        ? std::optional<std::string>(j["user_id"]) : std::nullopt;
-    item_id = j.contains("item_id") && !j["item_id"].is_null()
-        ? std::optional<std::string>(j["item_id"]) : std::nullopt;
-    
-    if (j.contains("metadata") && !j["metadata"].is_null()) {
-        std::unordered_map<std::string, json> meta;
-        for (auto& [key, value] : j["metadata"].items()) {
-            meta[key] = value;
+    bool hasBody = method == "POST" || method == "PUT" || method == "PATCH";
+    bool binaryBody = hasBody && wireFormat != WireFormat::Json && binaryBodiesAccepted;
+    const cpr::Header* headers = &preparedHeaders(true);
+    cpr::Header bodyHeaders;
+    std::string payload;
+    if (hasBody) {
+        bodyHeaders = *headers;
+        payload = encodeBody(body, bodyHeaders, binaryBody);
+        headers = &bodyHeaders;
+    }
+
+    cpr::Response response;
+    if (!dispatch(method, base_url + endpoint, *headers, cpr::Body{std::move(payload)}, acceptEncoding(), response)) {
+        return APIResponse(false, "Unsupported HTTP method");
+    }
+
+    std::string contentType = response.header["Content-Type"];
+    if (wireFormat != WireFormat::Json) {
+        if (binaryBody && response.status_code == 415) {
+            // The server stopped accepting binary bodies: go back to JSON and retry once
+            binaryBodiesAccepted = false;
+            return makeRequest(method, endpoint, body, requireAuth);
+        }
+        if (formatOf(contentType) == wireFormat) {
+            binaryBodiesAccepted = true;
         }
-        metadata = meta;
     }
+
+    return buildResponse(response.status_code, response.text, contentType);
 }
 
-json InventoryItem::to_json() const {
-    json j = {
-        {"amount", amount},
-        {"itemId", itemId},
-        {"name", name},
-        {"description", description},
-        {"iconHash", iconHash},
-        {"price", price},
-        {"owner", owner},
-        {"showInStore", showInStore}
-    };
-    
-    if (user_id) j["user_id"] = *user_id;
-    if (item_id) j["item_id"] = *item_id;
-    if (metadata) {
-        json metaJson = json::object();
-        for (const auto& [key, value] : *metadata) {
-            metaJson[key] = value;
-        }
-        j["metadata"] = metaJson;
+// Pre-serialized bodies are always JSON, which the server accepts regardless
+// of the negotiated response format. They are read by curl where they are,
+// without being copied into a cpr::Body.
+bool Client::sendRaw(const std::string& method, const std::string& endpoint, std::string_view body,
+                     cpr::Response& response) const {
+    const cpr::Header* headers = &preparedHeaders(true);
+    cpr::Header compressedHeaders;
+    std::string compressed;
+    if (requestCompressionThreshold > 0 && body.size() >= requestCompressionThreshold) {
+        compressedHeaders = *headers;
+        compressedHeaders["Content-Encoding"] = "gzip";
+        headers = &compressedHeaders;
+        compressed = gzipCompress(body);
+        body = compressed;
     }
-    
-    return j;
+
+    BodyReader reader{body};
+    if (!dispatch(method, base_url + endpoint, *headers, readerOf(reader), acceptEncoding(), response)) {
+        return false;
+    }
+    if (wireFormat != WireFormat::Json && formatOf(response.header["Content-Type"]) == wireFormat) {
+        binaryBodiesAccepted = true;
+    }
+    return true;
 }
 
-// Lobby
-Lobby::Lobby(const json& j) {
-    lobbyId = j.value("lobbyId", "");
-    users.clear();
-    
-    if (j.contains("users") && j["users"].is_array()) {
-        for (const auto& userJson : j["users"]) {
-            users.emplace_back(userJson);
-        }
+APIResponse Client::makeRawRequest(const std::string& method, const std::string& endpoint,
+                                   std::string_view body, bool requireAuth) const {
+    if (requireAuth && token.empty()) {
+        throw std::runtime_error("Token is required for this operation");
     }
+
+    cpr::Response response;
+    if (!sendRaw(method, endpoint, body, response)) {
+        return APIResponse(false, "Unsupported HTTP method");
+    }
+    return buildResponse(response.status_code, response.text, response.header["Content-Type"]);
 }
 
-json Lobby::to_json() const {
-    json j = {
-        {"lobbyId", lobbyId}
-    };
-    
-    json usersArray = json::array();
-    for (const auto& user : users) {
-        usersArray.push_back(user.to_json());
+Result<json> Client::exchange(const std::string& method, const std::string& endpoint,
+                              std::string_view body, bool requireAuth) const {
+    if (requireAuth && token.empty()) {
+        return Error{ErrorCode::Auth, 0, "Token is required"};
     }
-    j["users"] = usersArray;
-    
-    return j;
+
+    cpr::Response response;
+    if (!sendRaw(method, endpoint, body, response)) {
+        return Error{ErrorCode::Transport, 0, "Unsupported HTTP method"};
+    }
+    if (response.error) {
+        return Error{ErrorCode::Transport, 0, response.error.message};
+    }
+    return resultOf(response.status_code, response.text, response.header["Content-Type"]);
 }
 
-// Studio
-Studio::Studio(const json& j) {
-    user_id = j.value("user_id", "");
-    username = j.value("username", "");
-    verified = j.value("verified", false);
-    admin_id = j.value("admin_id", "");
-    
-    isAdmin = j.contains("isAdmin") ? std::optional<bool>(j["isAdmin"]) : std::nullopt;
-    apiKey = j.contains("apiKey") && !j["apiKey"].is_null()
-        ? std::optional<std::string>(j["apiKey"]) : std::nullopt;
-    
-    if (j.contains("users") && j["users"].is_array()) {
-        std::vector<StudioUser> studioUsers;
-        for (const auto& userJson : j["users"]) {
-            studioUsers.emplace_back(userJson);
+bool detail::JsonArraySplitter::feed(std::string_view chunk) {
+    for (char c : chunk) {
+        if (!step(c)) {
+            return false;
         }
-        users = studioUsers;
     }
+    return true;
 }
 
-json Studio::to_json() const {
-    json j = {
-        {"user_id", user_id},
-        {"username", username},
-        {"verified", verified},
-        {"admin_id", admin_id}
-    };
-    
-    if (isAdmin) j["isAdmin"] = *isAdmin;
-    if (apiKey) j["apiKey"] = *apiKey;
-    if (users) {
-        json usersArray = json::array();
-        for (const auto& user : *users) {
-            usersArray.push_back(user.to_json());
-        }
-        j["users"] = usersArray;
+bool detail::JsonArraySplitter::step(char c) {
+    if (arrayDepth >= 0) {
+        return inElement ? elementChar(c) : betweenElements(c);
     }
-    
-    return j;
+    documentChar(c);
+    return true;
 }
 
-// Trade
-Trade::Trade(const json& j) {
-    id = j.value("id", "");
-    fromUserId = j.value("fromUserId", "");
-    toUserId = j.value("toUserId", "");
-    approvedFromUser = j.value("approvedFromUser", false);
-    approvedToUser = j.value("approvedToUser", false);
-    status = j.value("status", "");
-    createdAt = j.value("createdAt", "");
-    updatedAt = j.value("updatedAt", "");
-    
-    fromUserItems.clear();
-    if (j.contains("fromUserItems") && j["fromUserItems"].is_array()) {
-        for (const auto& itemJson : j["fromUserItems"]) {
-            fromUserItems.emplace_back(itemJson);
+bool detail::JsonArraySplitter::betweenElements(char c) {
+    if (c == ']') {
+        closeArray();
+    } else if (c != ',' && !std::isspace(static_cast<unsigned char>(c))) {
+        inElement = true;
+        element.clear();
+        return elementChar(c);
+    }
+    return true;
+}
+
+bool detail::JsonArraySplitter::elementChar(char c) {
+    if (inString) {
+        element.push_back(c);
+        if (escape) {
+            escape = false;
+        } else if (c == '\\') {
+            escape = true;
+        } else if (c == '"') {
+            inString = false;
         }
+        return true;
     }
-    
-    toUserItems.clear();
-    if (j.contains("toUserItems") && j["toUserItems"].is_array()) {
-        for (const auto& itemJson : j["toUserItems"]) {
-            toUserItems.emplace_back(itemJson);
+
+    if (depth == arrayDepth && (c == ',' || c == ']')) {
+        bool keepGoing = emit();
+        if (c == ']') {
+            closeArray();
         }
+        return keepGoing;
+    }
+
+    if (c == '"') {
+        inString = true;
+    } else if (c == '{' || c == '[') {
+        ++depth;
+    } else if (c == '}' || c == ']') {
+        --depth;
     }
+    element.push_back(c);
+    return true;
 }
 
-json Trade::to_json() const {
-    json j = {
-        {"id", id},
-        {"fromUserId", fromUserId},
-        {"toUserId", toUserId},
-        {"approvedFromUser", approvedFromUser},
-        {"approvedToUser", approvedToUser},
-        {"status", status},
-        {"createdAt", createdAt},
-        {"updatedAt", updatedAt}
-    };
-    
-    json fromItems = json::array();
-    for (const auto& item : fromUserItems) {
-        fromItems.push_back(item.to_json());
+void detail::JsonArraySplitter::documentChar(char c) {
+    if (inString) {
+        rest.push_back(c);
+        if (escape) {
+            escape = false;
+            current.push_back(c);
+        } else if (c == '\\') {
+            escape = true;
+            current.push_back(c);
+        } else if (c == '"') {
+            inString = false;
+            lastString = current;
+        } else {
+            current.push_back(c);
+        }
+        return;
     }
-    j["fromUserItems"] = fromItems;
-    
-    json toItems = json::array();
-    for (const auto& item : toUserItems) {
-        toItems.push_back(item.to_json());
+
+    rest.push_back(c);
+    switch (c) {
+        case '"':
+            inString = true;
+            current.clear();
+            break;
+        case ':':
+            if (depth == 1) pendingKey = lastString;
+            break;
+        case ',':
+            if (depth == 1) pendingKey.clear();
+            break;
+        case '[':
+            ++depth;
+            if (!found && (arrayKey.empty() ? depth == 1 : depth == 2 && pendingKey == arrayKey)) {
+                arrayDepth = depth;
+            }
+            break;
+        case '{':
+            ++depth;
+            break;
+        case '}':
+        case ']':
+            --depth;
+            break;
+        default:
+            break;
     }
-    j["toUserItems"] = toItems;
-    
-    return j;
 }
 
-// OAuth2App
-OAuth2App::OAuth2App(const json& j) {
-    client_id = j.value("client_id", "");
-    client_secret = j.value("client_secret", "");
-    name = j.value("name", "");
-    
-    redirect_urls.clear();
-    if (j.contains("redirect_urls") && j["redirect_urls"].is_array()) {
-        for (const auto& url : j["redirect_urls"]) {
-            redirect_urls.push_back(url);
+bool detail::JsonArraySplitter::emit() {
+    inElement = false;
+    try {
+        if (!onElement(std::string_view(element))) {
+            stop = true;
         }
+    } catch (...) {
+        error = std::current_exception();
+        stop = true;
     }
+    return !stop;
 }
 
-json OAuth2App::to_json() const {
-    return {
-        {"client_id", client_id},
-        {"client_secret", client_secret},
-        {"name", name},
-        {"redirect_urls", redirect_urls}
-    };
+void detail::JsonArraySplitter::closeArray() {
+    rest.push_back(']');
+    --depth;
+    arrayDepth = -1;
+    found = true;
 }
 
-// API Methods Implementation
+// Helper method to make HTTP requests whose array payload is parsed while downloading
+APIResponse Client::makeStreamingRequest(const std::string& method, const std::string& endpoint,
+                                         const std::string& arrayKey,
+                                         const std::function<bool(std::string_view)>& onElement,
+                                         bool requireAuth) const {
+    if (requireAuth && token.empty()) {
+        throw std::runtime_error("Token is required for this operation");
+    }
 
-// USERS namespace methods
-std::optional<User> Client::Users::getMe() const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+    detail::JsonArraySplitter splitter(arrayKey, onElement);
+    cpr::WriteCallback writer{[&splitter](std::string_view data, intptr_t) {
+        return splitter.feed(data);
+    }};
+
+    cpr::Response response;
+    BodyReader reader{};
+    if (!dispatch(method, base_url + endpoint, preparedHeaders(), readerOf(reader), acceptEncoding(), response,
+                  writer)) {
+        return APIResponse(false, "Unsupported HTTP method");
     }
-    
-    auto response = client.makeRequest("GET", "/users/@me", json::object(), true);
-    if (response.success) {
-        return User(response.data);
+
+    if (splitter.failure()) {
+        std::rethrow_exception(splitter.failure());
     }
-    return std::nullopt;
+    if (response.error && !splitter.stopped()) {
+        return APIResponse(false, response.error.message);
+    }
+
+    return buildResponse(response.status_code, splitter.remainder());
 }
 
-std::vector<User> Client::Users::search(const std::string& query) const {
-    std::string endpoint = "/users/search?q=" + client.urlEncode(query);
-    auto response = client.makeRequest("GET", endpoint);
-    
-    std::vector<User> users;
-    if (response.success && response.data.is_array()) {
-        for (const auto& userJson : response.data) {
-            users.emplace_back(userJson);
-        }
+// Raw body fetch backing the lazy views (always JSON)
+std::shared_ptr<const ResponseBody> Client::fetchBody(const std::string& endpoint, bool requireAuth) const {
+    if (requireAuth && token.empty()) {
+        throw std::runtime_error("Token is required for this operation");
     }
-    return users;
-}
 
-std::optional<User> Client::Users::getUser(const std::string& userId) const {
-    auto response = client.makeRequest("GET", "/users/" + userId);
-    if (response.success) {
-        return User(response.data);
+    cpr::Response response = cpr::Get(cpr::Url{base_url + endpoint}, preparedHeaders(), acceptEncoding());
+    if (response.status_code < 200 || response.status_code >= 300) {
+        return nullptr;
     }
-    return std::nullopt;
+
+    auto body = std::make_shared<ResponseBody>();
+    body->text = std::move(response.text);
+    return body;
 }
 
-APIResponse Client::Users::transferCredits(const std::string& targetUserId, double amount) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+std::vector<std::string_view> detail::arrayElements(std::string_view text) {
+    std::vector<std::string_view> elements;
+    std::size_t pos = skipWhitespace(text, 0);
+    if (pos >= text.size() || text[pos] != '[') {
+        return elements;
+    }
+    ++pos;
+    while (true) {
+        pos = skipWhitespace(text, pos);
+        if (pos >= text.size() || text[pos] == ']') {
+            return elements;
+        }
+        std::size_t end = skipValue(text, pos);
+        elements.push_back(text.substr(pos, end - pos));
+        pos = skipWhitespace(text, end);
+        if (pos >= text.size() || text[pos] != ',') {
+            return elements;
+        }
+        ++pos;
     }
-    
-    json body = {
-        {"targetUserId", targetUserId},
-        {"amount", amount}
-    };
-    
-    return client.makeRequest("POST", "/users/transfer-credits", body, true);
 }
 
-APIResponse Client::Users::verify(const std::string& userId, const std::string& verificationKey) const {
-    json body = {
-        {"userId", userId},
-        {"verificationKey", verificationKey}
-    };
-    
-    return client.makeRequest("POST", "/users/auth-verification", body);
+// ObjectView
+std::string_view ObjectView::raw(std::string_view key) const {
+    std::string_view found;
+    detail::forEachMember(text, [&](std::string_view memberKey, std::string_view value) {
+        if (found.empty() && memberKey == key) {
+            found = value;
+        }
+    });
+    return found;
 }
 
-APIResponse Client::Users::changeUsername(const std::string& username) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
-    }
-    
-    json body = {{"username", username}};
-    return client.makeRequest("POST", "/users/change-username", body, true);
+bool ObjectView::has(std::string_view key) const {
+    std::string_view value = raw(key);
+    return !value.empty() && value != "null";
 }
 
-APIResponse Client::Users::changePassword(const std::string& oldPassword, 
-                                         const std::string& newPassword, 
-                                         const std::string& confirmPassword) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+std::string_view ObjectView::string(std::string_view key) const {
+    std::string_view value = raw(key);
+    if (value.size() < 2 || value.front() != '"') {
+        return {};
+    }
+    std::string_view content = value.substr(1, value.size() - 2);
+    if (content.find('\\') == std::string_view::npos) {
+        return content;
     }
-    
-    json body = {
-        {"oldPassword", oldPassword},
-        {"newPassword", newPassword},
-        {"confirmPassword", confirmPassword}
-    };
-    
-    return client.makeRequest("POST", "/users/change-password", body, true);
-}
 
-// GAMES namespace methods
-std::vector<Game> Client::Games::list() const {
-    auto response = client.makeRequest("GET", "/games");
-    
-    std::vector<Game> games;
-    if (response.success && response.data.is_array()) {
-        for (const auto& gameJson : response.data) {
-            games.emplace_back(gameJson);
+    // Escaped strings are decoded once per value and kept alongside the body,
+    // keyed by where the value starts in it
+    std::size_t offset = static_cast<std::size_t>(value.data() - body->text.data());
+    {
+        std::lock_guard<std::mutex> lock(body->decodedMutex);
+        auto found = body->decodedAt.find(offset);
+        if (found != body->decodedAt.end()) {
+            return body->decoded[found->second];
         }
     }
-    return games;
+    std::string decoded = json::parse(value.begin(), value.end()).get<std::string>();
+    std::lock_guard<std::mutex> lock(body->decodedMutex);
+    auto [slot, inserted] = body->decodedAt.emplace(offset, body->decoded.size());
+    if (inserted) {
+        body->decoded.push_back(std::move(decoded));
+    }
+    return body->decoded[slot->second];
 }
 
-std::vector<Game> Client::Games::search(const std::string& query) const {
-    std::string endpoint = "/games/search?q=" + client.urlEncode(query);
-    auto response = client.makeRequest("GET", endpoint);
-    
-    std::vector<Game> games;
-    if (response.success && response.data.is_array()) {
-        for (const auto& gameJson : response.data) {
-            games.emplace_back(gameJson);
-        }
+std::optional<std::string_view> ObjectView::optionalString(std::string_view key) const {
+    if (!has(key)) {
+        return std::nullopt;
     }
-    return games;
+    return string(key);
 }
 
-std::vector<Game> Client::Games::getMyCreatedGames() const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
-    }
-    
-    auto response = client.makeRequest("GET", "/games/@mine", json::object(), true);
-    
-    std::vector<Game> games;
-    if (response.success && response.data.is_array()) {
-        for (const auto& gameJson : response.data) {
-            games.emplace_back(gameJson);
-        }
-    }
-    return games;
+double ObjectView::number(std::string_view key, double fallback) const {
+    return optionalNumber(key).value_or(fallback);
 }
 
-std::vector<Game> Client::Games::getMyOwnedGames() const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
-    }
-    
-    auto response = client.makeRequest("GET", "/games/list/@me", json::object(), true);
-    
-    std::vector<Game> games;
-    if (response.success && response.data.is_array()) {
-        for (const auto& gameJson : response.data) {
-            games.emplace_back(gameJson);
-        }
+std::optional<double> ObjectView::optionalNumber(std::string_view key) const {
+    std::string_view value = raw(key);
+    if (value.empty() || !(value.front() == '-' || std::isdigit(static_cast<unsigned char>(value.front())))) {
+        return std::nullopt;
     }
-    return games;
+    return json::parse(value.begin(), value.end()).get<double>();
 }
 
-std::optional<Game> Client::Games::get(const std::string& gameId) const {
-    auto response = client.makeRequest("GET", "/games/" + gameId);
-    if (response.success) {
-        return Game(response.data);
-    }
-    return std::nullopt;
+bool ObjectView::boolean(std::string_view key, bool fallback) const {
+    return optionalBoolean(key).value_or(fallback);
 }
 
-std::optional<Game> Client::Games::create(const Game& game) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
-    }
-    
-    auto response = client.makeRequest("POST", "/games", game.to_json(), true);
-    if (response.success) {
-        return Game(response.data);
+std::optional<bool> ObjectView::optionalBoolean(std::string_view key) const {
+    std::string_view value = raw(key);
+    if (value == "true") return true;
+    if (value == "false") return false;
+    // MySQL flags come back as 0/1
+    if (!value.empty() && (value.front() == '-' || std::isdigit(static_cast<unsigned char>(value.front())))) {
+        return json::parse(value.begin(), value.end()).get<double>() != 0;
     }
     return std::nullopt;
 }
 
-std::optional<Game> Client::Games::update(const std::string& gameId, const Game& game) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
-    }
-    
-    auto response = client.makeRequest("PUT", "/games/" + gameId, game.to_json(), true);
-    if (response.success) {
-        return Game(response.data);
+// Id / IdInterner
+Id::Id(std::string_view value) : value(IdInterner::global().intern(value)) {}
+
+std::string_view Id::str() const {
+    return IdInterner::global().lookup(value);
+}
+
+IdInterner& IdInterner::global() {
+    static IdInterner interner;
+    return interner;
+}
+
+IdInterner::IdInterner() {
+    for (auto& chunk : chunks) {
+        chunk.store(nullptr, std::memory_order_relaxed);
     }
-    return std::nullopt;
+    // Index 0 is the empty string
+    chunkFor(0)[0] = std::string_view();
 }
 
-APIResponse Client::Games::buy(const std::string& gameId) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+IdInterner::~IdInterner() {
+    for (auto& chunk : chunks) {
+        delete[] chunk.load(std::memory_order_relaxed);
     }
-    
-    return client.makeRequest("POST", "/games/" + gameId + "/buy", json::object(), true);
 }
 
-// INVENTORY namespace methods
-std::pair<std::string, std::vector<InventoryItem>> Client::Inventory::getMyInventory() const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+std::string_view* IdInterner::chunkFor(std::uint32_t index) {
+    std::size_t chunkIndex = index >> chunkBits;
+    if (chunkIndex >= maxChunks) {
+        throw std::length_error("IdInterner is full");
     }
-    
-    auto response = client.makeRequest("GET", "/inventory/@me", json::object(), true);
-    
-    std::string userId;
-    std::vector<InventoryItem> inventory;
-    
-    if (response.success) {
-        userId = response.data.value("user_id", "");
-        if (response.data.contains("inventory") && response.data["inventory"].is_array()) {
-            for (const auto& itemJson : response.data["inventory"]) {
-                inventory.emplace_back(itemJson);
-            }
+    std::string_view* chunk = chunks[chunkIndex].load(std::memory_order_acquire);
+    if (!chunk) {
+        std::lock_guard<std::mutex> lock(chunkMutex);
+        chunk = chunks[chunkIndex].load(std::memory_order_relaxed);
+        if (!chunk) {
+            chunk = new std::string_view[chunkSize];
+            chunks[chunkIndex].store(chunk, std::memory_order_release);
         }
     }
-    
-    return std::make_pair(userId, inventory);
+    return chunk;
 }
 
-std::pair<std::string, std::vector<InventoryItem>> Client::Inventory::get(const std::string& userId) const {
-    auto response = client.makeRequest("GET", "/inventory/" + userId);
-    
-    std::string returnedUserId;
-    std::vector<InventoryItem> inventory;
-    
-    if (response.success) {
-        returnedUserId = response.data.value("user_id", "");
-        if (response.data.contains("inventory") && response.data["inventory"].is_array()) {
-            for (const auto& itemJson : response.data["inventory"]) {
-                inventory.emplace_back(itemJson);
-            }
-        }
+std::string_view IdInterner::store(Shard& shard, std::string_view value) {
+    if (value.size() > blockSize / 4) {
+        // Oversized strings get an allocation of their own
+        shard.oversized.emplace_back(new char[value.size()]);
+        std::memcpy(shard.oversized.back().get(), value.data(), value.size());
+        return std::string_view(shard.oversized.back().get(), value.size());
     }
-    
-    return std::make_pair(returnedUserId, inventory);
+    if (shard.blockUsed + value.size() > blockSize) {
+        shard.blocks.emplace_back(new char[blockSize]);
+        shard.blockUsed = 0;
+    }
+    char* destination = shard.blocks.back().get() + shard.blockUsed;
+    std::memcpy(destination, value.data(), value.size());
+    shard.blockUsed += value.size();
+    return std::string_view(destination, value.size());
 }
 
-// ITEMS namespace methods
-std::vector<Item> Client::Items::list() const {
-    auto response = client.makeRequest("GET", "/items");
-    
-    std::vector<Item> items;
-    if (response.success && response.data.is_array()) {
-        for (const auto& itemJson : response.data) {
-            items.emplace_back(itemJson);
-        }
+std::uint32_t IdInterner::intern(std::string_view value) {
+    if (value.empty()) {
+        return 0;
     }
-    return items;
+
+    Shard& shard = shards[std::hash<std::string_view>()(value) % shardCount];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.indices.find(value);
+    if (found != shard.indices.end()) {
+        return found->second;
+    }
+
+    std::string_view stored = store(shard, value);
+    std::uint32_t index = next.fetch_add(1, std::memory_order_relaxed);
+    chunkFor(index)[index & (chunkSize - 1)] = stored;
+    shard.indices.emplace(stored, index);
+    return index;
 }
 
-std::vector<Item> Client::Items::getMyItems() const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+std::string_view IdInterner::lookup(std::uint32_t index) const {
+    std::string_view* chunk = chunks[index >> chunkBits].load(std::memory_order_acquire);
+    return chunk ? chunk[index & (chunkSize - 1)] : std::string_view();
+}
+
+// PackedStrings: [presence mask] + for each present field, a varint length and its bytes
+detail::PackedStrings::PackedStrings(std::initializer_list<const std::optional<std::string>*> fields) {
+    std::size_t total = 0;
+    for (const auto* field : fields) {
+        if (*field) total += field->value().size() + 5;
     }
-    
-    auto response = client.makeRequest("GET", "/items/@mine", json::object(), true);
-    
-    std::vector<Item> items;
-    if (response.success && response.data.is_array()) {
-        for (const auto& itemJson : response.data) {
-            items.emplace_back(itemJson);
+    data.reserve(total);
+
+    std::size_t slot = 0;
+    for (const auto* field : fields) {
+        if (*field) {
+            present |= 1u << slot;
+            std::size_t length = field->value().size();
+            while (length >= 0x80) {
+                data.push_back(static_cast<char>((length & 0x7F) | 0x80));
+                length >>= 7;
+            }
+            data.push_back(static_cast<char>(length));
+            data.append(field->value());
         }
+        ++slot;
     }
-    return items;
+    data.shrink_to_fit();
 }
 
-std::vector<Item> Client::Items::search(const std::string& query) const {
-    std::string endpoint = "/items/search?q=" + client.urlEncode(query);
-    auto response = client.makeRequest("GET", endpoint);
-    
-    std::vector<Item> items;
-    if (response.success && response.data.is_array()) {
-        for (const auto& itemJson : response.data) {
-            items.emplace_back(itemJson);
+std::optional<std::string_view> detail::PackedStrings::get(std::size_t slot) const {
+    if (!(present >> slot & 1u)) {
+        return std::nullopt;
+    }
+    std::size_t pos = 0;
+    for (std::size_t i = 0;; ++i) {
+        if (!(present >> i & 1u)) {
+            continue;
+        }
+        std::size_t length = 0;
+        for (int shift = 0;; shift += 7) {
+            auto byte = static_cast<unsigned char>(data[pos++]);
+            length |= static_cast<std::size_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) break;
+        }
+        if (i == slot) {
+            return std::string_view(data.data() + pos, length);
         }
+        pos += length;
     }
-    return items;
 }
 
-std::optional<Item> Client::Items::get(const std::string& itemId) const {
-    auto response = client.makeRequest("GET", "/items/" + itemId);
-    if (response.success) {
-        return Item(response.data);
-    }
-    return std::nullopt;
+namespace {
+
+std::size_t heapBytes(const std::string& value) {
+    // Short strings live inside the object (small string optimization)
+    return value.capacity() >= sizeof(std::string) ? value.capacity() : 0;
 }
 
-APIResponse Client::Items::create(const std::string& name, const std::string& description, 
-                                 double price, const std::string& iconHash, bool showInStore) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
-    }
-    
-    json body = {
-        {"name", name},
-        {"description", description},
-        {"price", price},
-        {"showInStore", showInStore}
-    };
-    
-    if (!iconHash.empty()) {
-        body["iconHash"] = iconHash;
+} // namespace
+
+// CompactUser
+CompactUser::CompactUser(const User& user)
+    : id(user.userId),
+      name(user.username),
+      strings({&user.email, &user.verificationKey, &user.steam_id, &user.steam_username,
+               &user.steam_avatar_url, &user.google_id, &user.discord_id}),
+      balanceValue(user.balance.value_or(0.0)) {
+    flags.set(Verified, user.verified);
+    flags.set(IsStudio, user.isStudio);
+    flags.set(Admin, user.admin);
+    flags.set(Disabled, user.disabled);
+    flags.set(HaveAuthenticator, user.haveAuthenticator);
+    flags.set(HasBalance, user.balance.has_value());
+    if (user.studios || user.roles || user.inventory || user.ownedItems || user.createdGames) {
+        collections = std::make_shared<const Collections>(
+            Collections{user.studios, user.roles, user.inventory, user.ownedItems, user.createdGames});
     }
-    
-    return client.makeRequest("POST", "/items/create", body, true);
 }
 
-APIResponse Client::Items::update(const std::string& itemId, const Item& item) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+User CompactUser::toUser() const {
+    User user;
+    user.userId = id;
+    user.username = name;
+    user.verified = verified();
+    user.email = strings.copy(Email);
+    user.verificationKey = strings.copy(VerificationKey);
+    user.steam_id = strings.copy(SteamId);
+    user.steam_username = strings.copy(SteamUsername);
+    user.steam_avatar_url = strings.copy(SteamAvatarUrl);
+    user.google_id = strings.copy(GoogleId);
+    user.discord_id = strings.copy(DiscordId);
+    user.isStudio = isStudio();
+    user.admin = admin();
+    user.disabled = disabled();
+    user.haveAuthenticator = haveAuthenticator();
+    user.balance = balance();
+    if (collections) {
+        user.studios = collections->studios;
+        user.roles = collections->roles;
+        user.inventory = collections->inventory;
+        user.ownedItems = collections->ownedItems;
+        user.createdGames = collections->createdGames;
     }
-    
-    return client.makeRequest("PUT", "/items/update/" + itemId, item.to_json(), true);
+    return user;
 }
 
-APIResponse Client::Items::deleteItem(const std::string& itemId) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
-    }
-    
-    return client.makeRequest("DELETE", "/items/delete/" + itemId, json::object(), true);
+std::size_t CompactUser::footprint() const {
+    return sizeof(*this) + heapBytes(id) + heapBytes(name) + strings.heapBytes() +
+           (collections ? sizeof(Collections) : 0);
 }
 
-APIResponse Client::Items::buy(const std::string& itemId, int amount) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+// CompactGame
+CompactGame::CompactGame(const Game& game)
+    : id(game.gameId),
+      title(game.name),
+      text(game.description),
+      owner(game.owner_id),
+      priceValue(game.price),
+      ratingValue(game.rating),
+      strings({&game.iconHash, &game.splashHash, &game.bannerHash, &game.genre, &game.release_date,
+               &game.developer, &game.publisher, &game.website, &game.trailer_link, &game.download_link}) {
+    flags.set(ShowInStore, game.showInStore);
+    flags.set(Multiplayer, game.multiplayer);
+    if (game.platforms) {
+        platformList = std::make_shared<const std::vector<std::string>>(*game.platforms);
     }
-    
-    json body = {{"amount", amount}};
-    return client.makeRequest("POST", "/items/buy/" + itemId, body, true);
 }
 
-APIResponse Client::Items::sell(const std::string& itemId, int amount) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+Game CompactGame::toGame() const {
+    Game game;
+    game.gameId = id;
+    game.name = title;
+    game.description = text;
+    game.price = priceValue;
+    game.owner_id = owner;
+    game.showInStore = showInStore();
+    game.iconHash = strings.copy(IconHash);
+    game.splashHash = strings.copy(SplashHash);
+    game.bannerHash = strings.copy(BannerHash);
+    game.genre = strings.copy(Genre);
+    game.release_date = strings.copy(ReleaseDate);
+    game.developer = strings.copy(Developer);
+    game.publisher = strings.copy(Publisher);
+    if (platformList) {
+        game.platforms = *platformList;
     }
-    
-    json body = {{"amount", amount}};
-    return client.makeRequest("POST", "/items/sell/" + itemId, body, true);
+    game.rating = ratingValue;
+    game.website = strings.copy(Website);
+    game.trailer_link = strings.copy(TrailerLink);
+    game.multiplayer = multiplayer();
+    game.download_link = strings.copy(DownloadLink);
+    return game;
 }
 
-APIResponse Client::Items::give(const std::string& itemId, int amount, const std::string& userId,
-                               const std::optional<std::unordered_map<std::string, json>>& metadata) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
-    }
-    
-    json body = {
-        {"amount", amount},
-        {"userId", userId}
-    };
-    
-    if (metadata) {
-        json metaJson = json::object();
-        for (const auto& [key, value] : *metadata) {
-            metaJson[key] = value;
+std::size_t CompactGame::footprint() const {
+    std::size_t bytes = sizeof(*this) + heapBytes(id) + heapBytes(title) + heapBytes(text) +
+                        heapBytes(owner) + strings.heapBytes();
+    if (platformList) {
+        bytes += sizeof(*platformList);
+        for (const auto& platform : *platformList) {
+            bytes += sizeof(platform) + heapBytes(platform);
         }
-        body["metadata"] = metaJson;
     }
-    
-    return client.makeRequest("POST", "/items/give/" + itemId, body, true);
+    return bytes;
 }
 
-APIResponse Client::Items::consume(const std::string& itemId, const std::string& userId,
-                                  const std::optional<int>& amount,
-                                  const std::optional<std::string>& uniqueId) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+// InventoryTable
+void InventoryTable::reserve(std::size_t rows) {
+    userColumn.reserve(rows);
+    itemColumn.reserve(rows);
+    ownerColumn.reserve(rows);
+    amountColumn.reserve(rows);
+    priceColumn.reserve(rows);
+    storeColumn.reserve(rows);
+}
+
+void InventoryTable::clear() {
+    userColumn.clear();
+    itemColumn.clear();
+    ownerColumn.clear();
+    amountColumn.clear();
+    priceColumn.clear();
+    storeColumn.clear();
+}
+
+void InventoryTable::append(const InventoryItem& item) {
+    userColumn.push_back(item.user_id ? Id(*item.user_id) : Id());
+    itemColumn.push_back(Id(item.itemId));
+    ownerColumn.push_back(Id(item.owner));
+    amountColumn.push_back(item.amount);
+    priceColumn.push_back(item.price);
+    storeColumn.push_back(item.showInStore ? 1 : 0);
+}
+
+void InventoryTable::append(const InternedInventoryItem& item) {
+    userColumn.push_back(item.user_id);
+    itemColumn.push_back(item.itemId);
+    ownerColumn.push_back(item.owner);
+    amountColumn.push_back(item.amount);
+    priceColumn.push_back(item.price);
+    storeColumn.push_back(item.showInStore ? 1 : 0);
+}
+
+double InventoryTable::totalValue() const {
+    const std::int32_t* amounts = amountColumn.data();
+    const double* prices = priceColumn.data();
+    std::size_t n = size();
+    std::size_t i = 0;
+    double total = 0.0;
+
+#if defined(__AVX2__)
+    __m256d sum = _mm256_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        __m256d amount = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(amounts + i)));
+        sum = _mm256_add_pd(sum, _mm256_mul_pd(amount, _mm256_loadu_pd(prices + i)));
     }
-    
-    json body = {{"userId", userId}};
-    
-    if (amount) {
-        body["amount"] = *amount;
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, sum);
+    total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128d sum = _mm_setzero_pd();
+    for (; i + 2 <= n; i += 2) {
+        __m128d amount = _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(amounts + i)));
+        sum = _mm_add_pd(sum, _mm_mul_pd(amount, _mm_loadu_pd(prices + i)));
     }
-    if (uniqueId) {
-        body["uniqueId"] = *uniqueId;
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, sum);
+    total = lanes[0] + lanes[1];
+#endif
+
+    for (; i < n; ++i) {
+        total += prices[i] * amounts[i];
     }
-    
-    return client.makeRequest("POST", "/items/consume/" + itemId, body, true);
+    return total;
 }
 
-APIResponse Client::Items::updateMetadata(const std::string& itemId, const std::string& uniqueId,
-                                         const std::unordered_map<std::string, json>& metadata) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+double InventoryTable::totalValue(bool shown) const {
+    const std::int32_t* amounts = amountColumn.data();
+    const double* prices = priceColumn.data();
+    const std::uint8_t* flags = storeColumn.data();
+    std::uint8_t wanted = shown ? 1 : 0;
+    std::size_t n = size();
+    std::size_t i = 0;
+    double total = 0.0;
+
+#if defined(__AVX2__)
+    __m256d sum = _mm256_setzero_pd();
+    const __m256i target = _mm256_set1_epi64x(wanted);
+    for (; i + 4 <= n; i += 4) {
+        std::int32_t packed;
+        std::memcpy(&packed, flags + i, sizeof(packed));
+        __m256i flag = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(packed));
+        __m256d keep = _mm256_castsi256_pd(_mm256_cmpeq_epi64(flag, target));
+        __m256d amount = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(amounts + i)));
+        __m256d value = _mm256_mul_pd(amount, _mm256_loadu_pd(prices + i));
+        sum = _mm256_add_pd(sum, _mm256_and_pd(value, keep));
     }
-    
-    json metaJson = json::object();
-    for (const auto& [key, value] : metadata) {
-        metaJson[key] = value;
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, sum);
+    total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+
+    // Branch-free tail (and portable fallback), which compilers auto-vectorize
+    for (; i < n; ++i) {
+        double keep = flags[i] == wanted ? 1.0 : 0.0;
+        total += keep * prices[i] * amounts[i];
     }
-    
-    json body = {
-        {"uniqueId", uniqueId},
-        {"metadata", metaJson}
-    };
-    
-    return client.makeRequest("PUT", "/items/update-metadata/" + itemId, body, true);
+    return total;
 }
 
-APIResponse Client::Items::drop(const std::string& itemId,
-                               const std::optional<int>& amount,
-                               const std::optional<std::string>& uniqueId) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
-    }
-    
-    json body = json::object();
-    
-    if (amount) {
-        body["amount"] = *amount;
+std::int64_t InventoryTable::totalAmount() const {
+    std::int64_t total = 0;
+    for (std::int32_t amount : amountColumn) {
+        total += amount;
     }
-    if (uniqueId) {
-        body["uniqueId"] = *uniqueId;
-    }
-    
-    return client.makeRequest("POST", "/items/drop/" + itemId, body, true);
+    return total;
 }
 
-// LOBBIES namespace methods
+#if defined(__SSE2__) || defined(_M_X64)
+namespace {
+
+// Index of the lowest set bit; mask must be non-zero
+unsigned lowestSetBit(unsigned mask) {
+#if defined(_MSC_VER)
+    unsigned long bit;
+    _BitScanForward(&bit, mask);
+    return static_cast<unsigned>(bit);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+} // namespace
+#endif
+
+std::vector<std::uint32_t> InventoryTable::filterShowInStore(bool shown) const {
+    std::vector<std::uint32_t> rows;
+    const std::uint8_t* flags = storeColumn.data();
+    std::size_t n = size();
+    std::size_t i = 0;
+
+#if defined(__SSE2__) || defined(_M_X64)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(flags + i));
+        // Bit j is set when flags[i + j] is 0
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero)));
+        if (shown) {
+            mask = ~mask & 0xFFFFu;
+        }
+        while (mask) {
+            rows.push_back(static_cast<std::uint32_t>(i + lowestSetBit(mask)));
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; i < n; ++i) {
+        if ((flags[i] != 0) == shown) {
+            rows.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    return rows;
+}
+
+std::unordered_map<Id, double> InventoryTable::valueByOwner() const {
+    std::unordered_map<Id, double> totals;
+    std::size_t n = size();
+    if (n == 0) {
+        return totals;
+    }
+
+    // Owners are usually few; accumulate into a dense array indexed by Id
+    // when the index range allows it, and fall back to hashing otherwise.
+    std::uint32_t lowest = ownerColumn[0].index();
+    std::uint32_t highest = lowest;
+    for (Id owner : ownerColumn) {
+        lowest = std::min(lowest, owner.index());
+        highest = std::max(highest, owner.index());
+    }
+
+    std::size_t range = static_cast<std::size_t>(highest - lowest) + 1;
+    if (range <= std::max<std::size_t>(n * 4, 1024)) {
+        std::vector<double> dense(range, 0.0);
+        std::vector<Id> seen(range);
+        std::vector<std::uint8_t> used(range, 0);
+        for (std::size_t i = 0; i < n; ++i) {
+            std::size_t slot = ownerColumn[i].index() - lowest;
+            dense[slot] += priceColumn[i] * amountColumn[i];
+            seen[slot] = ownerColumn[i];
+            used[slot] = 1;
+        }
+        totals.reserve(range);
+        for (std::size_t slot = 0; slot < range; ++slot) {
+            if (used[slot]) {
+                totals.emplace(seen[slot], dense[slot]);
+            }
+        }
+        return totals;
+    }
+
+    for (std::size_t i = 0; i < n; ++i) {
+        totals[ownerColumn[i]] += priceColumn[i] * amountColumn[i];
+    }
+    return totals;
+}
+
+// JsonWriter
+detail::JsonWriter& detail::JsonWriter::beginObject() {
+    separate();
+    out.push_back('{');
+    needComma = false;
+    return *this;
+}
+
+detail::JsonWriter& detail::JsonWriter::endObject() {
+    out.push_back('}');
+    needComma = true;
+    return *this;
+}
+
+detail::JsonWriter& detail::JsonWriter::beginArray() {
+    separate();
+    out.push_back('[');
+    needComma = false;
+    return *this;
+}
+
+detail::JsonWriter& detail::JsonWriter::endArray() {
+    out.push_back(']');
+    needComma = true;
+    return *this;
+}
+
+detail::JsonWriter& detail::JsonWriter::key(std::string_view name) {
+    separate();
+    writeString(name);
+    out.push_back(':');
+    needComma = false;
+    return *this;
+}
+
+detail::JsonWriter& detail::JsonWriter::write(std::string_view text) {
+    separate();
+    writeString(text);
+    needComma = true;
+    return *this;
+}
+
+detail::JsonWriter& detail::JsonWriter::write(bool flag) {
+    separate();
+    out.append(flag ? "true" : "false");
+    needComma = true;
+    return *this;
+}
+
+detail::JsonWriter& detail::JsonWriter::write(int number) {
+    char digits[16];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    writeNumber(digits, result.ptr);
+    return *this;
+}
+
+detail::JsonWriter& detail::JsonWriter::write(double number) {
+    // JSON has no NaN or infinity; nlohmann::json::dump() writes null as well
+    if (!std::isfinite(number)) return writeNull();
+    char digits[32];
+    char* end = std::to_chars(digits, digits + sizeof(digits) - 2, number).ptr;
+    // Keep integral values floating-point on the wire, as dump() does
+    if (std::find_if(digits, end, [](char c) { return c == '.' || c == 'e'; }) == end) {
+        *end++ = '.';
+        *end++ = '0';
+    }
+    writeNumber(digits, end);
+    return *this;
+}
+
+detail::JsonWriter& detail::JsonWriter::write(const json& j) {
+    switch (j.type()) {
+        case json::value_t::boolean:
+            return write(j.get<bool>());
+        case json::value_t::number_integer: {
+            char digits[24];
+            auto result = std::to_chars(digits, digits + sizeof(digits), j.get<std::int64_t>());
+            writeNumber(digits, result.ptr);
+            return *this;
+        }
+        case json::value_t::number_unsigned: {
+            char digits[24];
+            auto result = std::to_chars(digits, digits + sizeof(digits), j.get<std::uint64_t>());
+            writeNumber(digits, result.ptr);
+            return *this;
+        }
+        case json::value_t::number_float:
+            return write(j.get<double>());
+        case json::value_t::string:
+            return write(std::string_view(j.get_ref<const std::string&>()));
+        case json::value_t::array:
+            beginArray();
+            for (const auto& element : j) {
+                write(element);
+            }
+            return endArray();
+        case json::value_t::object:
+            beginObject();
+            for (auto it = j.begin(); it != j.end(); ++it) {
+                key(it.key());
+                write(it.value());
+            }
+            return endObject();
+        default:
+            return writeNull();
+    }
+}
+
+detail::JsonWriter& detail::JsonWriter::write(const Metadata& metadata) {
+    beginObject();
+    for (const auto& [name, value] : metadata) {
+        key(name);
+        write(value);
+    }
+    return endObject();
+}
+
+detail::JsonWriter& detail::JsonWriter::writeNull() {
+    separate();
+    out.append("null");
+    needComma = true;
+    return *this;
+}
+
+void detail::JsonWriter::writeNumber(const char* begin, const char* end) {
+    separate();
+    out.append(begin, end);
+    needComma = true;
+}
+
+void detail::JsonWriter::writeString(std::string_view text) {
+    static const char hex[] = "0123456789abcdef";
+    out.push_back('"');
+    std::size_t start = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        auto c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        out.append(text.data() + start, i - start);
+        start = i + 1;
+        switch (c) {
+            case '"': out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            case '\b': out.append("\\b"); break;
+            case '\f': out.append("\\f"); break;
+            default: {
+                char escape[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                out.append(escape, sizeof(escape));
+                break;
+            }
+        }
+    }
+    out.append(text.data() + start, text.size() - start);
+    out.push_back('"');
+}
+
+// Member values decoded in place by detail::readProjected
+namespace {
+
+// Reads the four hex digits of a \u escape starting at `pos`
+bool hexCode(std::string_view text, std::size_t pos, std::uint32_t& code) {
+    if (pos + 4 > text.size()) return false;
+    auto parsed = std::from_chars(text.data() + pos, text.data() + pos + 4, code, 16);
+    return parsed.ec == std::errc() && parsed.ptr == text.data() + pos + 4;
+}
+
+void appendUtf8(std::string& out, std::uint32_t code) {
+    if (code < 0x80) {
+        out.push_back(static_cast<char>(code));
+    } else if (code < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+}
+
+bool isNumberStart(std::string_view raw) {
+    return !raw.empty() && (raw.front() == '-' || (raw.front() >= '0' && raw.front() <= '9'));
+}
+
+} // namespace
+
+bool detail::readJsonString(std::string_view raw, std::string& out) {
+    if (raw.size() < 2 || raw.front() != '"' || raw.back() != '"') return false;
+    std::string_view text = raw.substr(1, raw.size() - 2);
+    std::size_t escape = text.find('\\');
+    if (escape == std::string_view::npos) {
+        out.assign(text);
+        return true;
+    }
+
+    out.assign(text.substr(0, escape));
+    for (std::size_t i = escape; i < text.size(); ++i) {
+        char c = text[i];
+        if (c != '\\') {
+            if (c == '"') return false;
+            out.push_back(c);
+            continue;
+        }
+        // A backslash right before the end escaped the closing quote
+        if (++i == text.size()) return false;
+        switch (text[i]) {
+            case '"': out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '/': out.push_back('/'); break;
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'n': out.push_back('\n'); break;
+            case 'r': out.push_back('\r'); break;
+            case 't': out.push_back('\t'); break;
+            case 'u': {
+                std::uint32_t code;
+                if (!hexCode(text, i + 1, code)) return false;
+                i += 4;
+                if (code >= 0xD800 && code < 0xDC00) {
+                    // High surrogate: must be followed by an escaped low one
+                    std::uint32_t low;
+                    if (text.substr(i + 1, 2) != "\\u" || !hexCode(text, i + 3, low) || low < 0xDC00 ||
+                        low >= 0xE000) {
+                        return false;
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                } else if (code >= 0xDC00 && code < 0xE000) {
+                    return false;
+                }
+                appendUtf8(out, code);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+bool detail::readJsonNumber(std::string_view raw, double& out) {
+    if (!isNumberStart(raw)) return false;
+    auto parsed = std::from_chars(raw.data(), raw.data() + raw.size(), out);
+    return parsed.ec == std::errc() && parsed.ptr == raw.data() + raw.size();
+}
+
+bool detail::readJsonNumber(std::string_view raw, int& out) {
+    if (!isNumberStart(raw)) return false;
+    auto parsed = std::from_chars(raw.data(), raw.data() + raw.size(), out);
+    if (parsed.ec == std::errc() && parsed.ptr == raw.data() + raw.size()) return true;
+    // Fractions, exponents and out-of-range values are truncated like json::get<int>
+    double number;
+    if (!readJsonNumber(raw, number)) return false;
+    constexpr double lowest = std::numeric_limits<int>::min();
+    constexpr double highest = std::numeric_limits<int>::max();
+    out = static_cast<int>(std::clamp(number, lowest, highest));
+    return true;
+}
+
+// Metadata
+namespace {
+
+bool keyLess(const Metadata::Entry& entry, std::string_view key) {
+    return std::string_view(entry.key) < key;
+}
+
+} // namespace
+
+Metadata::Metadata(std::initializer_list<std::pair<std::string_view, json>> values) {
+    entries.reserve(values.size());
+    for (const auto& [key, value] : values) {
+        entries.emplace_back(key, value);
+    }
+    normalize();
+}
+
+Metadata::Metadata(std::unordered_map<std::string, json> values, std::pmr::memory_resource* arena)
+    : entries(arena) {
+    entries.reserve(values.size());
+    for (auto& [key, value] : values) {
+        entries.emplace_back(key, std::move(value));
+    }
+    normalize();
+}
+
+Metadata Metadata::fromJson(const json& j, std::pmr::memory_resource* arena) {
+    Metadata metadata(arena);
+    if (!j.is_object()) return metadata;
+    metadata.entries.reserve(j.size());
+    for (auto it = j.begin(); it != j.end(); ++it) {
+        metadata.entries.emplace_back(it.key(), it.value());
+    }
+    metadata.normalize();
+    return metadata;
+}
+
+Metadata Metadata::fromJson(json&& j, std::pmr::memory_resource* arena) {
+    Metadata metadata(arena);
+    if (!j.is_object()) return metadata;
+    auto& object = j.get_ref<json::object_t&>();
+    metadata.entries.reserve(object.size());
+    for (auto& [key, value] : object) {
+        metadata.entries.emplace_back(key, std::move(value));
+    }
+    metadata.normalize();
+    return metadata;
+}
+
+json Metadata::toJson() const {
+    json result = json::object();
+    auto& object = result.get_ref<json::object_t&>();
+    for (const auto& entry : entries) {
+        object.emplace_hint(object.end(), std::string(entry.key), entry.value);
+    }
+    return result;
+}
+
+std::unordered_map<std::string, json> Metadata::toMap() const {
+    std::unordered_map<std::string, json> map;
+    map.reserve(entries.size());
+    for (const auto& entry : entries) {
+        map.emplace(std::string(entry.key), entry.value);
+    }
+    return map;
+}
+
+Metadata::const_iterator Metadata::find(std::string_view key) const {
+    auto it = std::lower_bound(entries.begin(), entries.end(), key, keyLess);
+    return it != entries.end() && it->key == key ? it : entries.end();
+}
+
+const json* Metadata::get(std::string_view key) const {
+    auto it = find(key);
+    return it != end() ? &it->value : nullptr;
+}
+
+std::pmr::vector<Metadata::Entry>::iterator Metadata::lowerBound(std::string_view key) {
+    return std::lower_bound(entries.begin(), entries.end(), key, keyLess);
+}
+
+json& Metadata::operator[](std::string_view key) {
+    auto it = lowerBound(key);
+    if (it == entries.end() || it->key != key) {
+        it = entries.emplace(it, key, json());
+    }
+    return it->value;
+}
+
+void Metadata::set(std::string_view key, json value) {
+    auto it = lowerBound(key);
+    if (it != entries.end() && it->key == key) {
+        it->value = std::move(value);
+    } else {
+        entries.emplace(it, key, std::move(value));
+    }
+}
+
+bool Metadata::erase(std::string_view key) {
+    auto it = lowerBound(key);
+    if (it == entries.end() || it->key != key) return false;
+    entries.erase(it);
+    return true;
+}
+
+bool Metadata::operator==(const Metadata& other) const {
+    return std::equal(entries.begin(), entries.end(), other.entries.begin(), other.entries.end(),
+                      [](const Entry& a, const Entry& b) { return a.key == b.key && a.value == b.value; });
+}
+
+void Metadata::normalize() {
+    auto byKey = [](const Entry& a, const Entry& b) { return a.key < b.key; };
+    if (std::is_sorted(entries.begin(), entries.end(), byKey) &&
+        std::adjacent_find(entries.begin(), entries.end(),
+                           [](const Entry& a, const Entry& b) { return a.key == b.key; }) == entries.end()) {
+        return;
+    }
+    std::stable_sort(entries.begin(), entries.end(), byKey);
+    // Keep the last of each run of equal keys
+    auto out = entries.begin();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        auto next = std::next(it);
+        if (next != entries.end() && next->key == it->key) continue;
+        if (out != it) *out = std::move(*it);
+        ++out;
+    }
+    entries.erase(out, entries.end());
+}
+
+// Struct constructors and converters, generated from the Reflect<T> field tables
+
+// LobbyUser
+LobbyUser::LobbyUser(const json& j) {
+    detail::readObject(j, *this);
+}
+
+json LobbyUser::to_json() const {
+    return detail::writeObject(*this);
+}
+
+// StudioUser
+StudioUser::StudioUser(const json& j) {
+    detail::readObject(j, *this);
+}
+
+json StudioUser::to_json() const {
+    return detail::writeObject(*this);
+}
+
+// TradeItemDetail
+TradeItemDetail::TradeItemDetail(const json& j) {
+    detail::readObject(j, *this);
+}
+
+json TradeItemDetail::to_json() const {
+    return detail::writeObject(*this);
+}
+
+// TradeItem
+TradeItem::TradeItem(const json& j) {
+    detail::readObject(j, *this);
+}
+
+json TradeItem::to_json() const {
+    return detail::writeObject(*this);
+}
+
+// Game
+Game::Game(const json& j) {
+    detail::readObject(j, *this);
+}
+
+json Game::to_json() const {
+    return detail::writeObject(*this);
+}
+
+// User
+User::User(const json& j) {
+    detail::readObject(j, *this);
+}
+
+json User::to_json() const {
+    return detail::writeObject(*this);
+}
+
+// Item
+Item::Item(const json& j) {
+    detail::readObject(j, *this);
+}
+
+json Item::to_json() const {
+    return detail::writeObject(*this);
+}
+
+// InventoryItem
+InventoryItem::InventoryItem(const json& j) {
+    detail::readObject(j, *this);
+}
+
+json InventoryItem::to_json() const {
+    return detail::writeObject(*this);
+}
+
+// Lobby
+Lobby::Lobby(const json& j) {
+    detail::readObject(j, *this);
+}
+
+json Lobby::to_json() const {
+    return detail::writeObject(*this);
+}
+
+// Studio
+Studio::Studio(const json& j) {
+    detail::readObject(j, *this);
+}
+
+json Studio::to_json() const {
+    return detail::writeObject(*this);
+}
+
+// Trade
+Trade::Trade(const json& j) {
+    detail::readObject(j, *this);
+}
+
+json Trade::to_json() const {
+    return detail::writeObject(*this);
+}
+
+// OAuth2App
+OAuth2App::OAuth2App(const json& j) {
+    detail::readObject(j, *this);
+}
+
+json OAuth2App::to_json() const {
+    return detail::writeObject(*this);
+}
+
+// MarketListing
+MarketListing::MarketListing(const json& j) {
+    detail::readObject(j, *this);
+}
+
+json MarketListing::to_json() const {
+    return detail::writeObject(*this);
+}
+
+// BuyOrder
+BuyOrder::BuyOrder(const json& j) {
+    detail::readObject(j, *this);
+}
+
+json BuyOrder::to_json() const {
+    return detail::writeObject(*this);
+}
+
+// API Methods Implementation
+
+namespace {
+
+// Request bodies shared by the throwing and the try* variants
+
+std::string& amountBody(int amount) {
+    std::string& body = requestBuffer();
+    detail::JsonWriter(body).beginObject().member("amount", amount).endObject();
+    return body;
+}
+
+std::string& giveBody(int amount, const std::string& userId, const std::optional<Metadata>& metadata) {
+    std::string& body = requestBuffer();
+    detail::JsonWriter writer(body);
+    writer.beginObject()
+        .member("amount", amount)
+        .member("userId", userId);
+    if (metadata) {
+        writer.member("metadata", *metadata);
+    }
+    writer.endObject();
+    return body;
+}
+
+std::string& instanceBody(const std::optional<std::string>& userId, const std::optional<int>& amount,
+                          const std::optional<std::string>& uniqueId) {
+    std::string& body = requestBuffer();
+    detail::JsonWriter writer(body);
+    writer.beginObject();
+    if (userId) {
+        writer.member("userId", *userId);
+    }
+    if (amount) {
+        writer.member("amount", *amount);
+    }
+    if (uniqueId) {
+        writer.member("uniqueId", *uniqueId);
+    }
+    writer.endObject();
+    return body;
+}
+
+std::string& metadataBody(const std::string& uniqueId, const Metadata& metadata) {
+    std::string& body = requestBuffer();
+    detail::JsonWriter(body).beginObject()
+        .member("uniqueId", uniqueId)
+        .member("metadata", metadata)
+        .endObject();
+    return body;
+}
+
+std::string& transferBody(const std::string& targetUserId, double amount) {
+    std::string& body = requestBuffer();
+    detail::JsonWriter(body).beginObject()
+        .member("targetUserId", targetUserId)
+        .member("amount", amount)
+        .endObject();
+    return body;
+}
+
+std::string& tradeItemBody(const TradeItem& tradeItem) {
+    std::string& body = requestBuffer();
+    detail::JsonWriter(body).beginObject().member("tradeItem", tradeItem).endObject();
+    return body;
+}
+
+std::string& listingBody(const InventoryItem& inventoryItem, double sellingPrice) {
+    std::string& body = requestBuffer();
+    detail::JsonWriter(body)
+        .beginObject()
+        .member("inventoryItem", inventoryItem)
+        .member("sellingPrice", sellingPrice)
+        .endObject();
+    return body;
+}
+
+std::string& buyOrderBody(const std::string& itemId, double price) {
+    std::string& body = requestBuffer();
+    detail::JsonWriter(body).beginObject().member("itemId", itemId).member("price", price).endObject();
+    return body;
+}
+
+// Decodes a response object, moving its strings and nested values out
+template <typename T>
+T objectOf(json&& data) {
+    T value;
+    detail::readObject(std::move(data), value);
+    return value;
+}
+
+template <typename T>
+std::vector<T> listOf(json&& data) {
+    std::vector<T> values;
+    detail::Codec<std::vector<T>>::read(std::move(data), values);
+    return values;
+}
+
+std::pair<std::string, std::vector<InventoryItem>> inventoryOf(json&& data) {
+    std::string userId = data.value("user_id", "");
+    auto it = data.find("inventory");
+    return std::make_pair(std::move(userId), it != data.end() ? listOf<InventoryItem>(std::move(*it))
+                                                              : std::vector<InventoryItem>());
+}
+
+} // namespace
+
+// USERS namespace methods
+std::optional<User> Client::Users::getMe() const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    auto response = client.makeRequest("GET", "/users/@me", json::object(), true);
+    if (response.success) {
+        return User(response.data);
+    }
+    return std::nullopt;
+}
+
+std::vector<User> Client::Users::search(const std::string& query) const {
+    std::string endpoint = detail::routes::userSearch.expand(query);
+    auto response = client.makeRequest("GET", endpoint);
+    
+    std::vector<User> users;
+    if (response.success && response.data.is_array()) {
+        for (const auto& userJson : response.data) {
+            users.emplace_back(userJson);
+        }
+    }
+    return users;
+}
+
+ListView<UserView> Client::Users::searchView(const std::string& query) const {
+    return client.fetchListView<UserView>(detail::routes::userSearch.expand(query));
+}
+
+std::optional<User> Client::Users::getUser(const std::string& userId) const {
+    auto response = client.makeRequest("GET", detail::routes::user.expand(userId));
+    if (response.success) {
+        return User(response.data);
+    }
+    return std::nullopt;
+}
+
+APIResponse Client::Users::transferCredits(const std::string& targetUserId, double amount) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    return client.makeRawRequest("POST", "/users/transfer-credits", transferBody(targetUserId, amount), true);
+}
+
+APIResponse Client::Users::verify(const std::string& userId, const std::string& verificationKey) const {
+    json body = {
+        {"userId", userId},
+        {"verificationKey", verificationKey}
+    };
+    
+    return client.makeRequest("POST", "/users/auth-verification", body);
+}
+
+APIResponse Client::Users::changeUsername(const std::string& username) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    json body = {{"username", username}};
+    return client.makeRequest("POST", "/users/change-username", body, true);
+}
+
+APIResponse Client::Users::changePassword(const std::string& oldPassword, 
+                                         const std::string& newPassword, 
+                                         const std::string& confirmPassword) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    json body = {
+        {"oldPassword", oldPassword},
+        {"newPassword", newPassword},
+        {"confirmPassword", confirmPassword}
+    };
+    
+    return client.makeRequest("POST", "/users/change-password", body, true);
+}
+
+Result<User> Client::Users::tryGetMe() const {
+    return client.exchange("GET", "/users/@me", {}, true).map(objectOf<User>);
+}
+
+Result<User> Client::Users::tryGetUser(const std::string& userId) const {
+    return client.exchange("GET", detail::routes::user.expand(userId)).map(objectOf<User>);
+}
+
+// GAMES namespace methods
+ListView<GameView> Client::Games::listView() const {
+    return client.fetchListView<GameView>("/games");
+}
+
+ListView<GameView> Client::Games::searchView(const std::string& query) const {
+    return client.fetchListView<GameView>(detail::routes::gameSearch.expand(query));
+}
+
+std::vector<Game> Client::Games::list() const {
+    auto response = client.makeRequest("GET", "/games");
+    
+    std::vector<Game> games;
+    if (response.success && response.data.is_array()) {
+        for (const auto& gameJson : response.data) {
+            games.emplace_back(gameJson);
+        }
+    }
+    return games;
+}
+
+std::vector<Game> Client::Games::search(const std::string& query) const {
+    std::string endpoint = detail::routes::gameSearch.expand(query);
+    auto response = client.makeRequest("GET", endpoint);
+    
+    std::vector<Game> games;
+    if (response.success && response.data.is_array()) {
+        for (const auto& gameJson : response.data) {
+            games.emplace_back(gameJson);
+        }
+    }
+    return games;
+}
+
+std::vector<Game> Client::Games::getMyCreatedGames() const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    auto response = client.makeRequest("GET", "/games/@mine", json::object(), true);
+    
+    std::vector<Game> games;
+    if (response.success && response.data.is_array()) {
+        for (const auto& gameJson : response.data) {
+            games.emplace_back(gameJson);
+        }
+    }
+    return games;
+}
+
+std::vector<Game> Client::Games::getMyOwnedGames() const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    auto response = client.makeRequest("GET", "/games/list/@me", json::object(), true);
+    
+    std::vector<Game> games;
+    if (response.success && response.data.is_array()) {
+        for (const auto& gameJson : response.data) {
+            games.emplace_back(gameJson);
+        }
+    }
+    return games;
+}
+
+APIResponse Client::Games::listStream(const StreamCallback<Game>& onGame) const {
+    return client.streamObjects<Game>("/games", "", onGame);
+}
+
+APIResponse Client::Games::searchStream(const std::string& query, const StreamCallback<Game>& onGame) const {
+    std::string endpoint = detail::routes::gameSearch.expand(query);
+    return client.streamObjects<Game>(endpoint, "", onGame);
+}
+
+std::optional<Game> Client::Games::get(const std::string& gameId) const {
+    auto response = client.makeRequest("GET", detail::routes::game.expand(gameId));
+    if (response.success) {
+        return Game(response.data);
+    }
+    return std::nullopt;
+}
+
+std::optional<Game> Client::Games::create(const Game& game) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    std::string& body = requestBuffer();
+    detail::JsonWriter(body).write(game);
+    auto response = client.makeRawRequest("POST", "/games", body, true);
+    if (response.success) {
+        return Game(response.data);
+    }
+    return std::nullopt;
+}
+
+std::optional<Game> Client::Games::update(const std::string& gameId, const Game& game) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    std::string& body = requestBuffer();
+    detail::JsonWriter(body).write(game);
+    auto response = client.makeRawRequest("PUT", detail::routes::game.expand(gameId), body, true);
+    if (response.success) {
+        return Game(response.data);
+    }
+    return std::nullopt;
+}
+
+APIResponse Client::Games::buy(const std::string& gameId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    return client.makeRequest("POST", detail::routes::gameBuy.expand(gameId), json::object(), true);
+}
+
+Result<std::vector<Game>> Client::Games::tryList() const {
+    return client.exchange("GET", "/games").map(listOf<Game>);
+}
+
+Result<Game> Client::Games::tryGet(const std::string& gameId) const {
+    return client.exchange("GET", detail::routes::game.expand(gameId)).map(objectOf<Game>);
+}
+
+Result<json> Client::Games::tryBuy(const std::string& gameId) const {
+    return client.exchange("POST", detail::routes::gameBuy.expand(gameId), "{}", true);
+}
+
+// INVENTORY namespace methods
+std::pair<std::string, std::vector<InventoryItem>> Client::Inventory::getMyInventory() const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    auto response = client.makeRequest("GET", "/inventory/@me", json::object(), true);
+    
+    std::string userId;
+    std::vector<InventoryItem> inventory;
+    
+    if (response.success) {
+        userId = response.data.value("user_id", "");
+        if (response.data.contains("inventory") && response.data["inventory"].is_array()) {
+            for (const auto& itemJson : response.data["inventory"]) {
+                inventory.emplace_back(itemJson);
+            }
+        }
+    }
+    
+    return std::make_pair(std::move(userId), std::move(inventory));
+}
+
+std::pair<std::string, std::vector<InventoryItem>> Client::Inventory::get(const std::string& userId) const {
+    auto response = client.makeRequest("GET", detail::routes::inventory.expand(userId));
+    
+    std::string returnedUserId;
+    std::vector<InventoryItem> inventory;
+    
+    if (response.success) {
+        returnedUserId = response.data.value("user_id", "");
+        if (response.data.contains("inventory") && response.data["inventory"].is_array()) {
+            for (const auto& itemJson : response.data["inventory"]) {
+                inventory.emplace_back(itemJson);
+            }
+        }
+    }
+    
+    return std::make_pair(std::move(returnedUserId), std::move(inventory));
+}
+
+APIResponse Client::Inventory::getMyInventoryStream(const StreamCallback<InventoryItem>& onItem) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    return client.streamObjects<InventoryItem>("/inventory/@me", "inventory", onItem, true);
+}
+
+APIResponse Client::Inventory::getStream(const std::string& userId, const StreamCallback<InventoryItem>& onItem) const {
+    return client.streamObjects<InventoryItem>(detail::routes::inventory.expand(userId), "inventory", onItem);
+}
+
+APIResponse Client::loadInventory(const std::string& endpoint, const std::string& userId,
+                                  InventoryTable& table, bool requireAuth) const {
+    std::size_t firstRow = table.size();
+    auto response = streamObjects<InternedInventoryItem>(endpoint, "inventory", [&table](InternedInventoryItem&& row) {
+        table.append(row);
+        return true;
+    }, requireAuth);
+
+    // Rows without their own user_id belong to the inventory's user
+    Id owner(userId.empty() ? response.data.value("user_id", "") : userId);
+    for (std::size_t row = firstRow; row < table.size(); ++row) {
+        if (table.userColumn[row].empty()) {
+            table.userColumn[row] = owner;
+        }
+    }
+    return response;
+}
+
+InventoryTable Client::Inventory::getTable(const std::string& userId) const {
+    InventoryTable table;
+    loadInto(userId, table);
+    return table;
+}
+
+InventoryTable Client::Inventory::getMyInventoryTable() const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    InventoryTable table;
+    client.loadInventory("/inventory/@me", "", table, true);
+    return table;
+}
+
+APIResponse Client::Inventory::loadInto(const std::string& userId, InventoryTable& table) const {
+    return client.loadInventory(detail::routes::inventory.expand(userId), userId, table, false);
+}
+
+Result<std::pair<std::string, std::vector<InventoryItem>>> Client::Inventory::tryGetMyInventory() const {
+    return client.exchange("GET", "/inventory/@me", {}, true).map(inventoryOf);
+}
+
+Result<std::pair<std::string, std::vector<InventoryItem>>> Client::Inventory::tryGet(const std::string& userId) const {
+    return client.exchange("GET", detail::routes::inventory.expand(userId)).map(inventoryOf);
+}
+
+// ITEMS namespace methods
+std::vector<Item> Client::Items::list() const {
+    auto response = client.makeRequest("GET", "/items");
+    
+    std::vector<Item> items;
+    if (response.success && response.data.is_array()) {
+        for (const auto& itemJson : response.data) {
+            items.emplace_back(itemJson);
+        }
+    }
+    return items;
+}
+
+ListView<ItemView> Client::Items::listView() const {
+    return client.fetchListView<ItemView>("/items");
+}
+
+ListView<ItemView> Client::Items::searchView(const std::string& query) const {
+    return client.fetchListView<ItemView>(detail::routes::itemSearch.expand(query));
+}
+
+APIResponse Client::Items::listStream(const StreamCallback<Item>& onItem) const {
+    return client.streamObjects<Item>("/items", "", onItem);
+}
+
+std::vector<Item> Client::Items::getMyItems() const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    auto response = client.makeRequest("GET", "/items/@mine", json::object(), true);
+    
+    std::vector<Item> items;
+    if (response.success && response.data.is_array()) {
+        for (const auto& itemJson : response.data) {
+            items.emplace_back(itemJson);
+        }
+    }
+    return items;
+}
+
+std::vector<Item> Client::Items::search(const std::string& query) const {
+    std::string endpoint = detail::routes::itemSearch.expand(query);
+    auto response = client.makeRequest("GET", endpoint);
+    
+    std::vector<Item> items;
+    if (response.success && response.data.is_array()) {
+        for (const auto& itemJson : response.data) {
+            items.emplace_back(itemJson);
+        }
+    }
+    return items;
+}
+
+std::optional<Item> Client::Items::get(const std::string& itemId) const {
+    auto response = client.makeRequest("GET", detail::routes::item.expand(itemId));
+    if (response.success) {
+        return Item(response.data);
+    }
+    return std::nullopt;
+}
+
+APIResponse Client::Items::create(const std::string& name, const std::string& description, 
+                                 double price, const std::string& iconHash, bool showInStore) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    std::string& body = requestBuffer();
+    detail::JsonWriter writer(body);
+    writer.beginObject()
+        .member("name", name)
+        .member("description", description)
+        .member("price", price)
+        .member("showInStore", showInStore);
+    
+    if (!iconHash.empty()) {
+        writer.member("iconHash", iconHash);
+    }
+    writer.endObject();
+    
+    return client.makeRawRequest("POST", "/items/create", body, true);
+}
+
+APIResponse Client::Items::update(const std::string& itemId, const Item& item) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    std::string& body = requestBuffer();
+    detail::JsonWriter(body).write(item);
+    return client.makeRawRequest("PUT", detail::routes::itemUpdate.expand(itemId), body, true);
+}
+
+APIResponse Client::Items::deleteItem(const std::string& itemId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    return client.makeRequest("DELETE", detail::routes::itemDelete.expand(itemId), json::object(), true);
+}
+
+APIResponse Client::Items::buy(const std::string& itemId, int amount) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    return client.makeRawRequest("POST", detail::routes::itemBuy.expand(itemId), amountBody(amount), true);
+}
+
+APIResponse Client::Items::sell(const std::string& itemId, int amount) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    return client.makeRawRequest("POST", detail::routes::itemSell.expand(itemId), amountBody(amount), true);
+}
+
+APIResponse Client::Items::give(const std::string& itemId, int amount, const std::string& userId,
+                               const std::optional<Metadata>& metadata) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    return client.makeRawRequest("POST", detail::routes::itemGive.expand(itemId), giveBody(amount, userId, metadata), true);
+}
+
+APIResponse Client::Items::consume(const std::string& itemId, const std::string& userId,
+                                  const std::optional<int>& amount,
+                                  const std::optional<std::string>& uniqueId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    return client.makeRawRequest("POST", detail::routes::itemConsume.expand(itemId), instanceBody(userId, amount, uniqueId), true);
+}
+
+APIResponse Client::Items::updateMetadata(const std::string& itemId, const std::string& uniqueId,
+                                         const Metadata& metadata) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    return client.makeRawRequest("PUT", detail::routes::itemUpdateMetadata.expand(itemId), metadataBody(uniqueId, metadata), true);
+}
+
+APIResponse Client::Items::drop(const std::string& itemId,
+                               const std::optional<int>& amount,
+                               const std::optional<std::string>& uniqueId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    return client.makeRawRequest("POST", detail::routes::itemDrop.expand(itemId), instanceBody(std::nullopt, amount, uniqueId), true);
+}
+
+Result<std::vector<Item>> Client::Items::tryList() const {
+    return client.exchange("GET", "/items").map(listOf<Item>);
+}
+
+Result<Item> Client::Items::tryGet(const std::string& itemId) const {
+    return client.exchange("GET", detail::routes::item.expand(itemId)).map(objectOf<Item>);
+}
+
+Result<json> Client::Items::tryBuy(const std::string& itemId, int amount) const {
+    return client.exchange("POST", detail::routes::itemBuy.expand(itemId), amountBody(amount), true);
+}
+
+Result<json> Client::Items::trySell(const std::string& itemId, int amount) const {
+    return client.exchange("POST", detail::routes::itemSell.expand(itemId), amountBody(amount), true);
+}
+
+Result<json> Client::Items::tryGive(const std::string& itemId, int amount, const std::string& userId,
+                                    const std::optional<Metadata>& metadata) const {
+    return client.exchange("POST", detail::routes::itemGive.expand(itemId), giveBody(amount, userId, metadata), true);
+}
+
+Result<json> Client::Items::tryConsume(const std::string& itemId, const std::string& userId,
+                                       const std::optional<int>& amount,
+                                       const std::optional<std::string>& uniqueId) const {
+    return client.exchange("POST", detail::routes::itemConsume.expand(itemId), instanceBody(userId, amount, uniqueId), true);
+}
+
+Result<json> Client::Items::tryDrop(const std::string& itemId,
+                                    const std::optional<int>& amount,
+                                    const std::optional<std::string>& uniqueId) const {
+    return client.exchange("POST", detail::routes::itemDrop.expand(itemId), instanceBody(std::nullopt, amount, uniqueId), true);
+}
+
+// LOBBIES namespace methods
 APIResponse Client::Lobbies::create() const {
     if (client.token.empty()) {
         throw std::runtime_error("Token is required");
     }
-    
-    return client.makeRequest("POST", "/lobbies", json::object(), true);
+    
+    return client.makeRequest("POST", "/lobbies", json::object(), true);
+}
+
+std::optional<Lobby> Client::Lobbies::get(const std::string& lobbyId) const {
+    auto response = client.makeRequest("GET", detail::routes::lobby.expand(lobbyId));
+    if (response.success) {
+        return Lobby(response.data);
+    }
+    return std::nullopt;
+}
+
+std::optional<Lobby> Client::Lobbies::getMyLobby() const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    auto response = client.makeRequest("GET", "/lobbies/user/@me", json::object(), true);
+    if (response.success) {
+        return Lobby(response.data);
+    }
+    return std::nullopt;
+}
+
+std::optional<Lobby> Client::Lobbies::getUserLobby(const std::string& userId) const {
+    auto response = client.makeRequest("GET", detail::routes::userLobby.expand(userId));
+    if (response.success) {
+        return Lobby(response.data);
+    }
+    return std::nullopt;
+}
+
+APIResponse Client::Lobbies::join(const std::string& lobbyId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    return client.makeRequest("POST", detail::routes::lobbyJoin.expand(lobbyId), json::object(), true);
+}
+
+APIResponse Client::Lobbies::leave(const std::string& lobbyId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    return client.makeRequest("POST", detail::routes::lobbyLeave.expand(lobbyId), json::object(), true);
+}
+
+// STUDIOS namespace methods
+APIResponse Client::Studios::create(const std::string& studioName) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    json body = {{"studioName", studioName}};
+    return client.makeRequest("POST", "/studios", body, true);
+}
+
+std::optional<Studio> Client::Studios::get(const std::string& studioId) const {
+    auto response = client.makeRequest("GET", detail::routes::studio.expand(studioId));
+    if (response.success) {
+        return Studio(response.data);
+    }
+    return std::nullopt;
+}
+
+std::vector<Studio> Client::Studios::getMyStudios() const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    auto response = client.makeRequest("GET", "/studios/user/@me", json::object(), true);
+    
+    std::vector<Studio> studios;
+    if (response.success && response.data.is_array()) {
+        for (const auto& studioJson : response.data) {
+            studios.emplace_back(studioJson);
+        }
+    }
+    return studios;
+}
+
+APIResponse Client::Studios::addUser(const std::string& studioId, const std::string& userId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    json body = {{"userId", userId}};
+    return client.makeRequest("POST", detail::routes::studioAddUser.expand(studioId), body, true);
+}
+
+APIResponse Client::Studios::removeUser(const std::string& studioId, const std::string& userId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    json body = {{"userId", userId}};
+    return client.makeRequest("POST", detail::routes::studioRemoveUser.expand(studioId), body, true);
+}
+
+// TRADES namespace methods
+std::optional<Trade> Client::Trades::startOrGetPending(const std::string& userId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    auto response = client.makeRequest("POST", detail::routes::tradeStartOrLatest.expand(userId), json::object(), true);
+    if (response.success) {
+        return Trade(response.data);
+    }
+    return std::nullopt;
+}
+
+std::optional<Trade> Client::Trades::get(const std::string& tradeId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    auto response = client.makeRequest("GET", detail::routes::trade.expand(tradeId), json::object(), true);
+    if (response.success) {
+        return Trade(response.data);
+    }
+    return std::nullopt;
+}
+
+std::vector<Trade> Client::Trades::getUserTrades(const std::string& userId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    auto response = client.makeRequest("GET", detail::routes::userTrades.expand(userId), json::object(), true);
+    
+    std::vector<Trade> trades;
+    if (response.success && response.data.is_array()) {
+        for (const auto& tradeJson : response.data) {
+            trades.emplace_back(tradeJson);
+        }
+    }
+    return trades;
+}
+
+APIResponse Client::Trades::addItem(const std::string& tradeId, const TradeItem& tradeItem) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    return client.makeRawRequest("POST", detail::routes::tradeAddItem.expand(tradeId), tradeItemBody(tradeItem), true);
+}
+
+APIResponse Client::Trades::removeItem(const std::string& tradeId, const TradeItem& tradeItem) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    return client.makeRawRequest("POST", detail::routes::tradeRemoveItem.expand(tradeId), tradeItemBody(tradeItem), true);
+}
+
+APIResponse Client::Trades::approve(const std::string& tradeId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    return client.makeRequest("PUT", detail::routes::tradeApprove.expand(tradeId), json::object(), true);
+}
+
+APIResponse Client::Trades::cancel(const std::string& tradeId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    return client.makeRequest("PUT", detail::routes::tradeCancel.expand(tradeId), json::object(), true);
+}
+
+Result<Trade> Client::Trades::tryGet(const std::string& tradeId) const {
+    return client.exchange("GET", detail::routes::trade.expand(tradeId), {}, true).map(objectOf<Trade>);
+}
+
+Result<json> Client::Trades::tryAddItem(const std::string& tradeId, const TradeItem& tradeItem) const {
+    return client.exchange("POST", detail::routes::tradeAddItem.expand(tradeId), tradeItemBody(tradeItem), true);
+}
+
+Result<json> Client::Trades::tryRemoveItem(const std::string& tradeId, const TradeItem& tradeItem) const {
+    return client.exchange("POST", detail::routes::tradeRemoveItem.expand(tradeId), tradeItemBody(tradeItem), true);
+}
+
+Result<json> Client::Trades::tryApprove(const std::string& tradeId) const {
+    return client.exchange("PUT", detail::routes::tradeApprove.expand(tradeId), "{}", true);
+}
+
+// OAUTH2 namespace methods
+std::optional<OAuth2App> Client::OAuth2::getApp(const std::string& client_id) const {
+    auto response = client.makeRequest("GET", detail::routes::oauth2App.expand(client_id));
+    if (response.success) {
+        return OAuth2App(response.data);
+    }
+    return std::nullopt;
+}
+
+std::optional<std::pair<std::string, std::string>> Client::OAuth2::createApp(
+    const std::string& name, const std::vector<std::string>& redirect_urls) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    json body = {
+        {"name", name},
+        {"redirect_urls", redirect_urls}
+    };
+    
+    auto response = client.makeRequest("POST", "/oauth2/app", body, true);
+    if (response.success) {
+        std::string client_id = response.data.value("client_id", "");
+        std::string client_secret = response.data.value("client_secret", "");
+        return std::make_pair(client_id, client_secret);
+    }
+    return std::nullopt;
+}
+
+std::vector<OAuth2App> Client::OAuth2::getMyApps() const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    auto response = client.makeRequest("GET", "/oauth2/apps", json::object(), true);
+    
+    std::vector<OAuth2App> apps;
+    if (response.success && response.data.is_array()) {
+        for (const auto& appJson : response.data) {
+            apps.emplace_back(appJson);
+        }
+    }
+    return apps;
+}
+
+APIResponse Client::OAuth2::updateApp(const std::string& client_id,
+                                     const std::optional<std::string>& name,
+                                     const std::optional<std::vector<std::string>>& redirect_urls) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    json body = json::object();
+    if (name) {
+        body["name"] = *name;
+    }
+    if (redirect_urls) {
+        body["redirect_urls"] = *redirect_urls;
+    }
+    
+    return client.makeRequest("PATCH", detail::routes::oauth2App.expand(client_id), body, true);
+}
+
+APIResponse Client::OAuth2::deleteApp(const std::string& client_id) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    return client.makeRequest("DELETE", detail::routes::oauth2App.expand(client_id), json::object(), true);
+}
+
+std::string Client::OAuth2::authorize(const std::string& client_id, const std::string& redirect_uri) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    
+    std::string endpoint = detail::routes::oauth2Authorize.expand(client_id, redirect_uri);
+    
+    auto response = client.makeRequest("GET", endpoint, json::object(), true);
+    if (response.success) {
+        return response.data.value("code", "");
+    }
+    return "";
+}
+
+std::optional<User> Client::OAuth2::getUserByCode(const std::string& code, const std::string& client_id) const {
+    std::string endpoint = detail::routes::oauth2User.expand(code, client_id);
+    
+    auto response = client.makeRequest("GET", endpoint);
+    if (response.success) {
+        return User(response.data);
+    }
+    return std::nullopt;
+}
+
+// MARKET namespace methods
+std::vector<MarketListing> Client::Market::list(int limit, int offset) const {
+    auto response = client.makeRequest("GET", detail::routes::marketListings.expand(limit, offset));
+    return response.success ? listOf<MarketListing>(std::move(response.data)) : std::vector<MarketListing>();
+}
+
+std::vector<MarketListing> Client::Market::search(const std::string& query, int limit) const {
+    auto response = client.makeRequest("GET", detail::routes::marketSearch.expand(query, limit));
+    return response.success ? listOf<MarketListing>(std::move(response.data)) : std::vector<MarketListing>();
+}
+
+std::optional<MarketListing> Client::Market::get(const std::string& listingId) const {
+    auto response = client.makeRequest("GET", detail::routes::marketListing.expand(listingId));
+    if (response.success) {
+        return MarketListing(response.data);
+    }
+    return std::nullopt;
+}
+
+std::vector<MarketListing> Client::Market::getForItem(const std::string& itemId) const {
+    auto response = client.makeRequest("GET", detail::routes::marketItem.expand(itemId));
+    return response.success ? listOf<MarketListing>(std::move(response.data)) : std::vector<MarketListing>();
+}
+
+std::vector<MarketListing> Client::Market::getByUser(const std::string& userId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+
+    auto response = client.makeRequest("GET", detail::routes::marketUser.expand(userId), json::object(), true);
+    return response.success ? listOf<MarketListing>(std::move(response.data)) : std::vector<MarketListing>();
+}
+
+std::optional<MarketListing> Client::Market::create(const InventoryItem& inventoryItem, double sellingPrice) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+
+    auto response = client.makeRawRequest("POST", "/market-listings", listingBody(inventoryItem, sellingPrice), true);
+    if (response.success) {
+        return MarketListing(response.data);
+    }
+    return std::nullopt;
+}
+
+APIResponse Client::Market::cancel(const std::string& listingId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+
+    return client.makeRequest("PUT", detail::routes::marketCancel.expand(listingId), json::object(), true);
+}
+
+APIResponse Client::Market::buy(const std::string& listingId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+
+    return client.makeRequest("POST", detail::routes::marketBuy.expand(listingId), json::object(), true);
+}
+
+Result<std::vector<MarketListing>> Client::Market::tryGetForItem(const std::string& itemId) const {
+    return client.exchange("GET", detail::routes::marketItem.expand(itemId)).map(listOf<MarketListing>);
+}
+
+Result<MarketListing> Client::Market::tryBuy(const std::string& listingId) const {
+    return client.exchange("POST", detail::routes::marketBuy.expand(listingId), "{}", true)
+        .map(objectOf<MarketListing>);
+}
+
+// BUY ORDERS namespace methods
+std::optional<BuyOrder> Client::BuyOrders::create(const std::string& itemId, double price) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+
+    auto response = client.makeRawRequest("POST", "/buy-orders", buyOrderBody(itemId, price), true);
+    if (response.success) {
+        return BuyOrder(response.data);
+    }
+    return std::nullopt;
+}
+
+APIResponse Client::BuyOrders::cancel(const std::string& orderId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+
+    return client.makeRequest("PUT", detail::routes::buyOrderCancel.expand(orderId), json::object(), true);
+}
+
+std::vector<BuyOrder> Client::BuyOrders::getForItem(const std::string& itemId) const {
+    auto response = client.makeRequest("GET", detail::routes::buyOrdersItem.expand(itemId));
+    return response.success ? listOf<BuyOrder>(std::move(response.data)) : std::vector<BuyOrder>();
+}
+
+std::vector<BuyOrder> Client::BuyOrders::getByUser(const std::string& userId) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+
+    auto response = client.makeRequest("GET", detail::routes::buyOrdersUser.expand(userId), json::object(), true);
+    return response.success ? listOf<BuyOrder>(std::move(response.data)) : std::vector<BuyOrder>();
+}
+
+Result<std::vector<BuyOrder>> Client::BuyOrders::tryGetForItem(const std::string& itemId) const {
+    return client.exchange("GET", detail::routes::buyOrdersItem.expand(itemId)).map(listOf<BuyOrder>);
+}
+
+// Global search method
+json Client::globalSearch(const std::string& query) const {
+    std::string endpoint = detail::routes::search.expand(query);
+    auto response = makeRequest("GET", endpoint);
+    
+    if (response.success) {
+        return response.data;
+    }
+    return json::object();
+}
+
+namespace {
+
+// Parses up to `limit` elements (0 for all) of the JSON array in `text` into
+// `out`; the rest of the array is skipped unparsed. An absent section (empty
+// text) is an empty array. False when the array or one of the parsed elements
+// is malformed.
+template <typename T>
+bool parseSection(std::string_view text, std::size_t limit, std::vector<T>& out) {
+    std::size_t pos = detail::skipWhitespace(text, 0);
+    if (pos >= text.size()) return true;
+    if (text[pos] != '[') return false;
+    pos = detail::skipWhitespace(text, pos + 1);
+    if (pos < text.size() && text[pos] == ']') return true;
+    while (limit == 0 || out.size() < limit) {
+        pos = detail::skipWhitespace(text, pos);
+        if (pos >= text.size()) return false;
+        std::size_t end = detail::skipValue(text, pos);
+        T result;
+        if (!detail::readProjected(text.substr(pos, end - pos), result)) return false;
+        out.push_back(std::move(result));
+        pos = detail::skipWhitespace(text, end);
+        if (pos < text.size() && text[pos] == ']') return true;
+        if (pos >= text.size() || text[pos] != ',') return false;
+        ++pos;
+    }
+    return true;
+}
+
+// Cuts the users, games and items sections out of a /search response and
+// parses each on its own; false when the response is malformed
+bool searchResultsOf(std::string_view text, const SearchOptions& options, SearchResults& results) {
+    // One pass over the top level to find each section; nothing is parsed yet
+    std::string_view users, games, items;
+    bool wellFormed = detail::forEachMember(text, [&](std::string_view key, std::string_view value) {
+        if (key == "users") users = value;
+        else if (key == "games") games = value;
+        else if (key == "items") items = value;
+    });
+    if (!wellFormed) return false;
+
+    std::size_t limit = options.maxPerSection;
+    if (text.size() < options.parallelThreshold || std::thread::hardware_concurrency() < 2) {
+        return parseSection(users, limit, results.users) && parseSection(games, limit, results.games) &&
+               parseSection(items, limit, results.items);
+    }
+    // Each thread fills its own vector of `results`
+    auto parsedUsers = std::async(std::launch::async, [users, limit, &results] {
+        return parseSection(users, limit, results.users);
+    });
+    auto parsedGames = std::async(std::launch::async, [games, limit, &results] {
+        return parseSection(games, limit, results.games);
+    });
+    bool itemsRead = parseSection(items, limit, results.items);
+    bool usersRead = parsedUsers.get();
+    bool gamesRead = parsedGames.get();
+    return itemsRead && usersRead && gamesRead;
+}
+
+} // namespace
+
+SearchResults Client::search(const std::string& query, const SearchOptions& options) const {
+    return trySearch(query, options).valueOr(SearchResults());
+}
+
+Result<SearchResults> Client::trySearch(const std::string& query, const SearchOptions& options) const {
+    cpr::Response response = cpr::Get(cpr::Url{base_url + detail::routes::search.expand(query)},
+                                      preparedHeaders(), acceptEncoding());
+    if (response.error) {
+        return Error{ErrorCode::Transport, 0, response.error.message};
+    }
+    long status = response.status_code;
+    if (status < 200 || status >= 300) {
+        return resultOf(status, response.text, response.header["Content-Type"]).error();
+    }
+
+    SearchResults results;
+    if (!searchResultsOf(response.text, options, results)) {
+        return Error{ErrorCode::Parse, status, "Malformed response body"};
+    }
+    return results;
+}
+
+// AssetCache
+namespace {
+
+// Hashes become file names, so anything but [A-Za-z0-9_-] is rejected
+bool validAssetHash(const std::string& hash) {
+    if (hash.empty() || hash.size() > 128) return false;
+    return std::all_of(hash.begin(), hash.end(), [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_';
+    });
+}
+
+const detail::Route<1>& assetRoute(AssetKind kind) {
+    switch (kind) {
+        case AssetKind::GameIcon: return detail::routes::gameIcon;
+        case AssetKind::Banner: return detail::routes::banner;
+        default: return detail::routes::itemIcon;
+    }
+}
+
+} // namespace
+
+AssetCache::AssetCache(const Client& client, std::filesystem::path directory, std::uint64_t maxBytes)
+    : client(client), directory(std::move(directory)), capacity(maxBytes) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(this->directory, ec);
+
+    struct Found {
+        fs::file_time_type time;
+        std::string hash;
+        std::uint64_t bytes;
+    };
+    std::vector<Found> found;
+    std::vector<fs::path> leftovers;
+    for (fs::recursive_directory_iterator it(this->directory, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code fileError;
+        if (!it->is_regular_file(fileError)) continue;
+        std::string name = it->path().filename().string();
+        if (!validAssetHash(name)) {
+            // Partial downloads from an interrupted run
+            if (name.find(".part") != std::string::npos) leftovers.push_back(it->path());
+            continue;
+        }
+        auto time = it->last_write_time(fileError);
+        auto bytes = it->file_size(fileError);
+        if (!fileError) found.push_back({time, std::move(name), bytes});
+    }
+    for (const auto& path : leftovers) {
+        fs::remove(path, ec);
+    }
+
+    std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.time > b.time; });
+    for (auto& file : found) {
+        recency.push_back(file.hash);
+        entries[std::move(file.hash)] = Entry{file.bytes, std::prev(recency.end())};
+        totalBytes += file.bytes;
+    }
+    evict("");
+}
+
+Asset AssetCache::load(const std::filesystem::path& path) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return Asset();
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return Asset();
+    }
+    auto size = static_cast<std::size_t>(info.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return Asset();
+    std::shared_ptr<const void> owner(mapped, [size](const void* address) {
+        ::munmap(const_cast<void*>(address), size);
+    });
+    return Asset(std::move(owner), std::string_view(static_cast<const char*>(mapped), size));
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return Asset();
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return bytes.empty() ? Asset() : hold(std::move(bytes));
+#endif
+}
+
+Asset AssetCache::hold(std::string bytes) {
+    auto owner = std::make_shared<const std::string>(std::move(bytes));
+    std::string_view view(*owner);
+    return Asset(std::move(owner), view);
+}
+
+std::filesystem::path AssetCache::pathOf(const std::string& hash) const {
+    // Two-character fan-out keeps directories small
+    return directory / hash.substr(0, 2) / hash;
+}
+
+Asset AssetCache::download(AssetKind kind, const std::string& hash, bool& stored) {
+    namespace fs = std::filesystem;
+    stored = false;
+    fs::path target = pathOf(hash);
+    std::error_code ec;
+    fs::create_directories(target.parent_path(), ec);
+    fs::path part = target;
+    part += ".part" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+    std::FILE* file = std::fopen(part.string().c_str(), "wb");
+    std::string memory;
+    cpr::WriteCallback writer{[&file, &memory](std::string_view data, intptr_t) {
+        if (!file) {
+            memory.append(data);
+            return true;
+        }
+        return std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    }};
+    cpr::Response response = cpr::Get(cpr::Url{client.base_url + assetRoute(kind).expand(hash)}, writer);
+
+    bool written = !file || std::fclose(file) == 0;
+    if (response.error || response.status_code != 200 || !written) {
+        if (file) fs::remove(part, ec);
+        return Asset();
+    }
+
+    // Unknown hashes get a generic placeholder, sent without Cache-Control
+    bool placeholder = response.header.count("Cache-Control") == 0;
+    if (!file || placeholder) {
+        if (!file) return hold(std::move(memory));
+        Asset asset = load(part);
+        fs::remove(part, ec);
+        return asset;
+    }
+
+    fs::rename(part, target, ec);
+    if (ec) {
+        Asset asset = load(part);
+        fs::remove(part, ec);
+        return asset;
+    }
+    Asset asset = load(target);
+    stored = static_cast<bool>(asset);
+    return asset;
+}
+
+Asset AssetCache::get(AssetKind kind, const std::string& hash) {
+    if (!validAssetHash(hash)) return Asset();
+
+    std::promise<Asset> promise;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto entry = entries.find(hash);
+        if (entry != entries.end()) {
+            recency.splice(recency.begin(), recency, entry->second.position);
+            lock.unlock();
+            std::filesystem::path path = pathOf(hash);
+            Asset asset = load(path);
+            if (asset) {
+                std::error_code ec;
+                std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+                return asset;
+            }
+            // The file vanished or cannot be read: forget it and download again
+            lock.lock();
+            entry = entries.find(hash);
+            if (entry != entries.end()) {
+                totalBytes -= entry->second.bytes;
+                recency.erase(entry->second.position);
+                entries.erase(entry);
+            }
+        }
+
+        auto pending = inflight.find(hash);
+        if (pending != inflight.end()) {
+            std::shared_future<Asset> future = pending->second;
+            lock.unlock();
+            return future.get();
+        }
+        inflight.emplace(hash, promise.get_future().share());
+    }
+
+    Asset asset;
+    bool stored = false;
+    try {
+        asset = download(kind, hash, stored);
+    } catch (...) {
+        asset = Asset();
+        stored = false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stored) {
+            insert(hash, asset.size());
+            evict(hash);
+        }
+        inflight.erase(hash);
+    }
+    promise.set_value(asset);
+    return asset;
+}
+
+std::shared_future<Asset> AssetCache::fetch(AssetKind kind, const std::string& hash) {
+    return std::async(std::launch::async, [this, kind, hash] { return get(kind, hash); }).share();
+}
+
+std::vector<Asset> AssetCache::getAll(AssetKind kind, const std::vector<std::string>& hashes,
+                                      std::size_t parallelism) {
+    std::vector<Asset> assets(hashes.size());
+    std::atomic<std::size_t> next{0};
+    auto worker = [&] {
+        for (std::size_t i = next++; i < hashes.size(); i = next++) {
+            assets[i] = get(kind, hashes[i]);
+        }
+    };
+
+    std::size_t threads = std::min(std::max<std::size_t>(parallelism, 1), hashes.size());
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    return assets;
+}
+
+void AssetCache::insert(const std::string& hash, std::uint64_t bytes) {
+    auto entry = entries.find(hash);
+    if (entry != entries.end()) {
+        totalBytes -= entry->second.bytes;
+        recency.erase(entry->second.position);
+        entries.erase(entry);
+    }
+    recency.push_front(hash);
+    entries[hash] = Entry{bytes, recency.begin()};
+    totalBytes += bytes;
+}
+
+void AssetCache::evict(const std::string& keep) {
+    while (totalBytes > capacity && !recency.empty()) {
+        const std::string& victim = recency.back();
+        if (victim == keep) break;
+        std::error_code ec;
+        std::filesystem::remove(pathOf(victim), ec);
+        auto entry = entries.find(victim);
+        totalBytes -= entry->second.bytes;
+        entries.erase(entry);
+        recency.pop_back();
+    }
+}
+
+bool AssetCache::contains(const std::string& hash) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.count(hash) != 0;
+}
+
+std::uint64_t AssetCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return totalBytes;
+}
+
+std::uint64_t AssetCache::maxSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return capacity;
+}
+
+void AssetCache::setMaxSize(std::uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = bytes;
+    evict("");
+}
+
+void AssetCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& hash : recency) {
+        std::error_code ec;
+        std::filesystem::remove(pathOf(hash), ec);
+    }
+    recency.clear();
+    entries.clear();
+    totalBytes = 0;
+}
+
+// Game downloads
+namespace {
+
+std::uint32_t rotr(std::uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+} // namespace
+
+void detail::Sha256::update(const char* data, std::size_t size) {
+    length += size;
+    while (size > 0) {
+        std::size_t take = std::min(size, sizeof(block) - used);
+        std::memcpy(block + used, data, take);
+        used += take;
+        data += take;
+        size -= take;
+        if (used == sizeof(block)) {
+            compress();
+            used = 0;
+        }
+    }
+}
+
+std::string detail::Sha256::hexDigest() {
+    std::uint64_t bits = length * 8;
+    const char one = static_cast<char>(0x80);
+    update(&one, 1);
+    const char zero = 0;
+    while (used != 56) update(&zero, 1);
+    for (int i = 7; i >= 0; --i) {
+        block[used++] = static_cast<unsigned char>(bits >> (i * 8));
+    }
+    compress();
+
+    static const char hex[] = "0123456789abcdef";
+    std::string digest;
+    for (std::uint32_t word : state) {
+        for (int shift = 28; shift >= 0; shift -= 4) {
+            digest.push_back(hex[(word >> shift) & 0xF]);
+        }
+    }
+    return digest;
+}
+
+void detail::Sha256::compress() {
+    static const std::uint32_t k[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+    std::uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = static_cast<std::uint32_t>(block[i * 4]) << 24 | static_cast<std::uint32_t>(block[i * 4 + 1]) << 16 |
+               static_cast<std::uint32_t>(block[i * 4 + 2]) << 8 | block[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; ++i) {
+        std::uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        std::uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    std::uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    std::uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; ++i) {
+        std::uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+        std::uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+namespace {
+
+// Positional reads and writes shared by all download threads
+class ChunkFile {
+public:
+    ChunkFile() = default;
+    ChunkFile(const ChunkFile&) = delete;
+    ChunkFile& operator=(const ChunkFile&) = delete;
+    ~ChunkFile() { close(); }
+
+    // Opens without truncating, creating the file when missing
+    bool open(const std::filesystem::path& path) {
+#ifndef _WIN32
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        return fd >= 0;
+#else
+        file = std::fopen(path.string().c_str(), "r+b");
+        if (!file) file = std::fopen(path.string().c_str(), "w+b");
+        return file != nullptr;
+#endif
+    }
+
+    bool resize(std::uint64_t size) {
+#ifndef _WIN32
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) return false;
+#if defined(__linux__)
+        // Reserve the blocks up front; sparse files are fine where this is unsupported
+        if (size > 0) ::posix_fallocate(fd, 0, static_cast<off_t>(size));
+#endif
+        return true;
+#else
+        std::lock_guard<std::mutex> lock(mutex);
+        return _chsize_s(_fileno(file), static_cast<long long>(size)) == 0;
+#endif
+    }
+
+    bool writeAt(std::uint64_t offset, const char* data, std::size_t size) {
+#ifndef _WIN32
+        while (size > 0) {
+            ssize_t written = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+            if (written <= 0) return false;
+            data += written;
+            size -= static_cast<std::size_t>(written);
+            offset += static_cast<std::uint64_t>(written);
+        }
+        return true;
+#else
+        std::lock_guard<std::mutex> lock(mutex);
+        return _fseeki64(file, static_cast<long long>(offset), SEEK_SET) == 0 &&
+               std::fwrite(data, 1, size, file) == size;
+#endif
+    }
+
+    std::size_t readAt(std::uint64_t offset, char* data, std::size_t size) {
+#ifndef _WIN32
+        std::size_t total = 0;
+        while (total < size) {
+            ssize_t got = ::pread(fd, data + total, size - total, static_cast<off_t>(offset + total));
+            if (got <= 0) break;
+            total += static_cast<std::size_t>(got);
+        }
+        return total;
+#else
+        std::lock_guard<std::mutex> lock(mutex);
+        if (_fseeki64(file, static_cast<long long>(offset), SEEK_SET) != 0) return 0;
+        return std::fread(data, 1, size, file);
+#endif
+    }
+
+    void close() {
+#ifndef _WIN32
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#else
+        if (file) std::fclose(file);
+        file = nullptr;
+#endif
+    }
+
+private:
+#ifndef _WIN32
+    int fd = -1;
+#else
+    std::FILE* file = nullptr;
+    std::mutex mutex;
+#endif
+};
+
+// Status and the headers a download cares about, parsed as they arrive.
+// A new status line (e.g. after a redirect) starts over.
+struct ResponseHead {
+    long status = 0;
+    std::uint64_t rangeStart = 0;
+    std::optional<std::uint64_t> total;
+    std::optional<std::uint64_t> contentLength;
+    std::string validator;
+
+    void parse(std::string_view line) {
+        while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) line.remove_suffix(1);
+        if (line.substr(0, 5) == "HTTP/") {
+            *this = ResponseHead();
+            auto space = line.find(' ');
+            if (space != std::string_view::npos) {
+                std::from_chars(line.data() + space + 1, line.data() + line.size(), status);
+            }
+            return;
+        }
+        auto colon = line.find(':');
+        if (colon == std::string_view::npos) return;
+        std::string name(line.substr(0, colon));
+        std::transform(name.begin(), name.end(), name.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        std::string_view value = line.substr(colon + 1);
+        while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+
+        if (name == "content-range") {
+            // bytes <first>-<last>/<total>
+            auto dash = value.find('-');
+            auto slash = value.find('/');
+            auto digits = value.find_first_of("0123456789");
+            if (dash == std::string_view::npos || slash == std::string_view::npos || digits > dash) return;
+            std::from_chars(value.data() + digits, value.data() + dash, rangeStart);
+            std::uint64_t length = 0;
+            auto parsed = std::from_chars(value.data() + slash + 1, value.data() + value.size(), length);
+            if (parsed.ec == std::errc()) total = length;
+        } else if (name == "content-length") {
+            std::uint64_t length = 0;
+            if (std::from_chars(value.data(), value.data() + value.size(), length).ec == std::errc()) {
+                contentLength = length;
+            }
+        } else if (name == "etag" || (name == "last-modified" && validator.empty())) {
+            validator = std::string(value);
+        }
+    }
+};
+
+class GameDownload {
+public:
+    GameDownload(std::string url, cpr::Header headers, std::string apiOrigin,
+                 std::filesystem::path destination, const DownloadOptions& options)
+        : url(std::move(url)), headers(std::move(headers)), apiOrigin(std::move(apiOrigin)),
+          destination(std::move(destination)), statePath(this->destination), options(options) {
+        statePath += ".download";
+        chunkSize = std::max<std::size_t>(options.chunkSize, 64 * 1024);
+    }
+
+    DownloadResult run() {
+        DownloadResult result;
+        loadState();
+        if (!file.open(destination)) {
+            result.message = "Cannot open " + destination.string();
+            return result;
+        }
+
+        // A fully recorded earlier attempt still needs one request to confirm
+        // the file has not changed on the server
+        std::size_t first = 0;
+        while (first < chunkCrcs.size() && chunkCrcs[first]) ++first;
+        if (first == chunkCrcs.size()) first = 0;
+
+        std::thread hashing([this] { hashLoop(); });
+        if (probe(first) && ranged) {
+            std::size_t threads = std::max<std::size_t>(1, std::min(options.connections, ready.size()));
+            std::vector<std::thread> workers;
+            for (std::size_t i = 1; i < threads; ++i) {
+                workers.emplace_back([this] { workLoop(); });
+            }
+            workLoop();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+        finish();
+        hashing.join();
+        file.close();
+
+        result.bytes = total;
+        result.resumedBytes = resumedBytes;
+        if (failed || hashedBytes != total) {
+            result.message = failure.empty() ? "Download incomplete" : failure;
+            return result;
+        }
+
+        result.sha256 = sha.hexDigest();
+        std::error_code ec;
+        std::filesystem::remove(statePath, ec);
+        if (options.expectedSha256 && *options.expectedSha256 != result.sha256) {
+            result.message = "SHA-256 mismatch";
+            return result;
+        }
+        result.success = true;
+        result.message = "Success";
+        return result;
+    }
+
+private:
+    // --- resume state ---
+
+    void loadState() {
+        std::ifstream in(statePath);
+        if (!in) return;
+        json state = json::parse(in, nullptr, false);
+        if (!state.is_object()) return;
+        savedTotal = state.value("total", std::uint64_t{0});
+        savedValidator = state.value("validator", "");
+        chunkSize = state.value("chunkSize", chunkSize);
+        auto crcs = state.find("crc");
+        if (crcs == state.end() || !crcs->is_array()) return;
+        for (const auto& crc : *crcs) {
+            chunkCrcs.push_back(crc.is_number_unsigned() ? std::optional<std::uint32_t>(crc.get<std::uint32_t>())
+                                                         : std::nullopt);
+        }
+    }
+
+    // Caller holds `mutex`
+    void saveState() {
+        json crcs = json::array();
+        for (const auto& crc : chunkCrcs) {
+            crcs.push_back(crc ? json(*crc) : json());
+        }
+        json state = {{"total", total}, {"chunkSize", chunkSize}, {"validator", validator}, {"crc", crcs}};
+
+        std::filesystem::path temporary = statePath;
+        temporary += ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::trunc);
+            out << state.dump();
+            if (!out) return;
+        }
+        std::error_code ec;
+        std::filesystem::rename(temporary, statePath, ec);
+    }
+
+    // --- transfers ---
+
+    // The first request doubles as capability probe: a 206 answer means the
+    // remaining chunks can be fetched in parallel, a 200 answer carries the
+    // whole file and is streamed to disk as is.
+    bool probe(std::size_t chunk) {
+        ResponseHead head;
+        std::uint64_t offset = 0;
+        std::uint64_t received = 0;
+        std::uint32_t crc = static_cast<std::uint32_t>(crc32(0L, Z_NULL, 0));
+        bool started = false;
+
+        cpr::Session session;
+        cpr::Header request = headers;
+        request["Range"] = rangeOf(chunk);
+        session.SetUrl(cpr::Url{url});
+        session.SetHeader(request);
+        session.SetHeaderCallback(cpr::HeaderCallback{[&head](std::string_view line, intptr_t) {
+            head.parse(line);
+            return true;
+        }});
+        session.SetWriteCallback(cpr::WriteCallback{[&](std::string_view data, intptr_t) {
+            if (!started) {
+                started = true;
+                if (!begin(head, chunk, offset)) return false;
+            }
+            if (!file.writeAt(offset + received, data.data(), data.size())) {
+                fail("Cannot write " + destination.string());
+                return false;
+            }
+            crc = static_cast<std::uint32_t>(
+                crc32(crc, reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size())));
+            received += data.size();
+            if (!ranged) {
+                std::lock_guard<std::mutex> lock(mutex);
+                contiguousBytes = received;
+                advanced.notify_all();
+            }
+            return progress(data.size());
+        }});
+        cpr::Response response = session.Get();
+
+        if (!started) {
+            // No body: either an error answer or an empty file
+            if (!begin(head, chunk, offset)) return false;
+            if (response.error) return fail(response.error.message);
+        }
+        if (failed) return false;
+        if (response.error) return fail(response.error.message);
+
+        effectiveUrl = response.url.str();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!ranged) {
+            total = received;
+            file.resize(total);
+            contiguousBytes = total;
+            advanced.notify_all();
+            return true;
+        }
+        if (received != chunkLength(chunk)) return fail("Truncated range response");
+        chunkCrcs[chunk] = crc;
+        ready[chunk] = true;
+        claimed[chunk] = true;
+        advanceFrontier();
+        saveState();
+        return true;
+    }
+
+    // Sets the download up from the probe's status and headers
+    bool begin(const ResponseHead& head, std::size_t chunk, std::uint64_t& offset) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (head.status == 206 && head.total) {
+            ranged = true;
+            total = *head.total;
+            validator = head.validator;
+            std::size_t count = static_cast<std::size_t>((total + chunkSize - 1) / chunkSize);
+            if (savedTotal != total || savedValidator != validator || chunkCrcs.size() != count) {
+                if (chunk != 0) {
+                    std::error_code ec;
+                    std::filesystem::remove(statePath, ec);
+                    return fail("File changed on the server, retry the download");
+                }
+                chunkCrcs.assign(count, std::nullopt);
+            }
+            chunkCrcs[chunk].reset();
+            ready.assign(count, false);
+            claimed.assign(count, false);
+            offset = static_cast<std::uint64_t>(chunk) * chunkSize;
+            if (!file.resize(total)) return fail("Cannot allocate " + destination.string());
+            return true;
+        }
+        if (head.status == 200) {
+            ranged = false;
+            chunkCrcs.clear();
+            std::error_code ec;
+            std::filesystem::remove(statePath, ec);
+            total = head.contentLength.value_or(0);
+            offset = 0;
+            if (!file.resize(total)) return fail("Cannot allocate " + destination.string());
+            return true;
+        }
+        return fail("Download failed with HTTP status " + std::to_string(head.status));
+    }
+
+    void workLoop() {
+        cpr::Session session;
+        session.SetUrl(cpr::Url{effectiveUrl});
+        for (;;) {
+            std::size_t chunk;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (failed) return;
+                while (nextChunk < claimed.size() && claimed[nextChunk]) ++nextChunk;
+                if (nextChunk == claimed.size()) return;
+                chunk = nextChunk;
+                claimed[chunk] = true;
+            }
+
+            bool done = verifyChunk(chunk);
+            for (int attempt = 0; !done && attempt < 3 && !failed; ++attempt) {
+                done = fetchChunk(session, chunk);
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!done) {
+                fail("Failed to download bytes " + rangeOf(chunk).substr(6));
+                return;
+            }
+            ready[chunk] = true;
+            advanceFrontier();
+            saveState();
+        }
+    }
+
+    // A chunk recorded by an earlier attempt is kept when its CRC still matches
+    bool verifyChunk(std::size_t chunk) {
+        std::optional<std::uint32_t> expected;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            expected = chunkCrcs[chunk];
+        }
+        if (!expected) return false;
+
+        std::vector<char> buffer(1 << 20);
+        std::uint64_t offset = static_cast<std::uint64_t>(chunk) * chunkSize;
+        std::uint64_t remaining = chunkLength(chunk);
+        uLong crc = crc32(0L, Z_NULL, 0);
+        while (remaining > 0) {
+            std::size_t want = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, buffer.size()));
+            std::size_t got = file.readAt(offset, buffer.data(), want);
+            if (got != want) return false;
+            crc = crc32(crc, reinterpret_cast<const Bytef*>(buffer.data()), static_cast<uInt>(got));
+            offset += got;
+            remaining -= got;
+        }
+        if (static_cast<std::uint32_t>(crc) != *expected) return false;
+
+        resumedBytes += chunkLength(chunk);
+        return progress(chunkLength(chunk));
+    }
+
+    bool fetchChunk(cpr::Session& session, std::size_t chunk) {
+        ResponseHead head;
+        std::uint64_t offset = static_cast<std::uint64_t>(chunk) * chunkSize;
+        std::uint64_t expected = chunkLength(chunk);
+        std::uint64_t received = 0;
+        uLong crc = crc32(0L, Z_NULL, 0);
+
+        cpr::Header request = headersFor(effectiveUrl);
+        request["Range"] = rangeOf(chunk);
+        session.SetHeader(request);
+        session.SetHeaderCallback(cpr::HeaderCallback{[&head](std::string_view line, intptr_t) {
+            head.parse(line);
+            return true;
+        }});
+        session.SetWriteCallback(cpr::WriteCallback{[&](std::string_view data, intptr_t) {
+            if (head.status != 206 || head.rangeStart != offset || received + data.size() > expected) return false;
+            if (!file.writeAt(offset + received, data.data(), data.size())) return false;
+            crc = crc32(crc, reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size()));
+            received += data.size();
+            return progress(data.size());
+        }});
+        cpr::Response response = session.Get();
+        if (response.error || received != expected) {
+            progress(0, received);
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        chunkCrcs[chunk] = static_cast<std::uint32_t>(crc);
+        return true;
+    }
+
+    // Runs next to the transfers, hashing the file as its contiguous prefix grows
+    void hashLoop() {
+        std::vector<char> buffer(1 << 20);
+        for (;;) {
+            std::uint64_t limit;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                advanced.wait(lock, [this] { return contiguousBytes > hashedBytes || finished; });
+                if (contiguousBytes <= hashedBytes) return;
+                limit = contiguousBytes;
+            }
+            while (hashedBytes < limit) {
+                std::size_t want = static_cast<std::size_t>(std::min<std::uint64_t>(limit - hashedBytes, buffer.size()));
+                std::size_t got = file.readAt(hashedBytes, buffer.data(), want);
+                if (got == 0) return;
+                sha.update(buffer.data(), got);
+                hashedBytes += got;
+            }
+        }
+    }
+
+    // --- bookkeeping ---
+
+    // Caller holds `mutex`
+    void advanceFrontier() {
+        while (frontier < ready.size() && ready[frontier]) ++frontier;
+        contiguousBytes = std::min<std::uint64_t>(static_cast<std::uint64_t>(frontier) * chunkSize, total);
+        advanced.notify_all();
+    }
+
+    void finish() {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+        advanced.notify_all();
+    }
+
+    // Records the first failure; always returns false. Caller holds `mutex`
+    // once the worker threads are running.
+    bool fail(const std::string& message) {
+        if (!failed) failure = message;
+        failed = true;
+        advanced.notify_all();
+        return false;
+    }
+
+    // Reports `added` new bytes (and takes back `discarded` ones from a failed attempt)
+    bool progress(std::uint64_t added, std::uint64_t discarded = 0) {
+        std::lock_guard<std::mutex> lock(progressMutex);
+        doneBytes += added;
+        doneBytes -= std::min(doneBytes, discarded);
+        if (options.onProgress && !options.onProgress(doneBytes, total)) {
+            std::lock_guard<std::mutex> state(mutex);
+            fail("Download cancelled");
+            return false;
+        }
+        return true;
+    }
+
+    std::uint64_t chunkLength(std::size_t chunk) const {
+        std::uint64_t start = static_cast<std::uint64_t>(chunk) * chunkSize;
+        return std::min<std::uint64_t>(chunkSize, total - start);
+    }
+
+    std::string rangeOf(std::size_t chunk) const {
+        std::uint64_t start = static_cast<std::uint64_t>(chunk) * chunkSize;
+        return "bytes=" + std::to_string(start) + "-" + std::to_string(start + chunkSize - 1);
+    }
+
+    // The bearer token only goes back to the API itself, never to the host a
+    // redirect pointed at
+    cpr::Header headersFor(const std::string& target) const {
+        if (target.compare(0, apiOrigin.size(), apiOrigin) == 0) return headers;
+        cpr::Header anonymous = headers;
+        anonymous.erase("Authorization");
+        return anonymous;
+    }
+
+    std::string url;
+    cpr::Header headers;
+    std::string apiOrigin;
+    std::filesystem::path destination;
+    std::filesystem::path statePath;
+    const DownloadOptions& options;
+    std::size_t chunkSize;
+
+    ChunkFile file;
+    std::string effectiveUrl;
+    std::uint64_t savedTotal = 0;
+    std::string savedValidator;
+
+    std::mutex mutex;
+    std::condition_variable advanced;
+    bool ranged = false;
+    bool finished = false;
+    std::atomic<bool> failed{false};
+    std::string failure;
+    std::uint64_t total = 0;
+    std::string validator;
+    std::vector<std::optional<std::uint32_t>> chunkCrcs;
+    std::vector<bool> ready;
+    std::vector<bool> claimed;
+    std::size_t nextChunk = 0;
+    std::size_t frontier = 0;
+    std::uint64_t contiguousBytes = 0;
+    std::atomic<std::uint64_t> resumedBytes{0};
+
+    std::mutex progressMutex;
+    std::uint64_t doneBytes = 0;
+
+    // Owned by the hashing thread until it is joined
+    detail::Sha256 sha;
+    std::uint64_t hashedBytes = 0;
+};
+
+// Scheme and host of `url`, e.g. "https://croissant-api.fr/"
+std::string originOf(const std::string& url) {
+    auto scheme = url.find("://");
+    if (scheme == std::string::npos) return url;
+    auto path = url.find('/', scheme + 3);
+    return path == std::string::npos ? url + "/" : url.substr(0, path + 1);
+}
+
+} // namespace
+
+DownloadResult Client::Games::download(const std::string& gameId, const std::filesystem::path& destination,
+                                       const DownloadOptions& options) const {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+
+    GameDownload download(client.base_url + detail::routes::gameDownload.expand(gameId), client.preparedHeaders(),
+                          originOf(client.base_url), destination, options);
+    return download.run();
+}
+
+// OrderBook
+namespace {
+
+template <typename Levels>
+std::size_t countAt(const Levels& levels, double price) {
+    auto it = levels.find(price);
+    return it == levels.end() ? 0 : it->second.size();
+}
+
+template <typename Levels>
+std::vector<PriceLevel> topLevels(const Levels& levels, std::size_t count) {
+    std::vector<PriceLevel> top;
+    top.reserve(std::min(count, levels.size()));
+    for (auto it = levels.begin(); it != levels.end() && top.size() < count; ++it) {
+        top.push_back(it->second);
+    }
+    return top;
+}
+
+// False when the order is not resting at `price`
+template <typename Levels>
+bool removeFrom(Levels& levels, double price, const std::string& orderId) {
+    auto level = levels.find(price);
+    if (level == levels.end()) return false;
+    auto& ids = level->second.orderIds;
+    auto id = std::find(ids.begin(), ids.end(), orderId);
+    if (id == ids.end()) return false;
+    ids.erase(id);
+    if (ids.empty()) levels.erase(level);
+    return true;
+}
+
+bool isActive(const MarketListing& listing) { return listing.status == "active"; }
+bool isActive(const BuyOrder& order) { return order.status == "active"; }
+
+} // namespace
+
+OrderBook::OrderBook(const Client& client, std::string itemId) : client(&client), item(std::move(itemId)) {}
+
+OrderBook::OrderBook(std::string itemId) : item(std::move(itemId)) {}
+
+bool OrderBook::refresh() {
+    if (!client) return false;
+    auto listings = client->market.tryGetForItem(item);
+    auto buyOrders = client->buyOrders.tryGetForItem(item);
+    if (listings) applyListings(*listings);
+    if (buyOrders) applyBuyOrders(*buyOrders);
+    return listings.ok() && buyOrders.ok();
+}
+
+std::size_t OrderBook::applyListings(const std::vector<MarketListing>& listings) {
+    return applySide(listings, false);
+}
+
+std::size_t OrderBook::applyBuyOrders(const std::vector<BuyOrder>& buyOrders) {
+    return applySide(buyOrders, true);
+}
+
+// Marks every order of the snapshot with a fresh generation, repricing or
+// placing the ones that changed; orders of that side left on an older
+// generation were filled or cancelled since the last snapshot.
+template <typename Order>
+std::size_t OrderBook::applySide(const std::vector<Order>& snapshot, bool bid) {
+    std::size_t changes = 0;
+    ++generation;
+    for (const auto& order : snapshot) {
+        if (order.item_id != item || !isActive(order)) continue;
+        auto it = orders.find(order.id);
+        if (it == orders.end()) {
+            place(order.id, bid, order.price);
+            ++changes;
+        } else if (it->second.bid != bid || it->second.price != order.price) {
+            Resting previous = it->second;
+            unplace(order.id, previous);
+            place(order.id, bid, order.price);
+            ++changes;
+        }
+        orders[order.id].generation = generation;
+    }
+
+    for (auto it = orders.begin(); it != orders.end();) {
+        if (it->second.bid == bid && it->second.generation != generation) {
+            unplace(it->first, it->second);
+            it = orders.erase(it);
+            ++changes;
+        } else {
+            ++it;
+        }
+    }
+    return changes;
+}
+
+bool OrderBook::erase(const std::string& orderId) {
+    auto it = orders.find(orderId);
+    if (it == orders.end()) return false;
+    unplace(orderId, it->second);
+    orders.erase(it);
+    return true;
+}
+
+void OrderBook::clear() {
+    asks.clear();
+    bids.clear();
+    orders.clear();
+    askCount = 0;
+    bidCount = 0;
+}
+
+std::optional<double> OrderBook::spread() const {
+    if (asks.empty() || bids.empty()) return std::nullopt;
+    return asks.begin()->first - bids.begin()->first;
+}
+
+std::size_t OrderBook::asksAt(double price) const {
+    return countAt(asks, price);
+}
+
+std::size_t OrderBook::bidsAt(double price) const {
+    return countAt(bids, price);
+}
+
+std::vector<PriceLevel> OrderBook::askDepth(std::size_t levels) const {
+    return topLevels(asks, levels);
+}
+
+std::vector<PriceLevel> OrderBook::bidDepth(std::size_t levels) const {
+    return topLevels(bids, levels);
+}
+
+void OrderBook::place(const std::string& orderId, bool bid, double price) {
+    PriceLevel& level = bid ? bids[price] : asks[price];
+    level.price = price;
+    level.orderIds.push_back(orderId);
+    ++(bid ? bidCount : askCount);
+    orders[orderId] = Resting{bid, price, generation};
+}
+
+void OrderBook::unplace(const std::string& orderId, const Resting& resting) {
+    if (resting.bid) {
+        if (removeFrom(bids, resting.price, orderId)) --bidCount;
+    } else {
+        if (removeFrom(asks, resting.price, orderId)) --askCount;
+    }
+}
+
+// MarketBuyer
+struct MarketBuyer::Connection {
+    CURL* handle = nullptr;
+    curl_socket_t socket = CURL_SOCKET_BAD;
+    // host:port:address of the first successful connection, so reconnects
+    // skip DNS and land on the same server
+    curl_slist* resolve = nullptr;
+    std::chrono::steady_clock::time_point lastUsed;
+
+    ~Connection() {
+        if (handle) curl_easy_cleanup(handle);
+        curl_slist_free_all(resolve);
+    }
+};
+
+namespace {
+
+// Waits until `socket` is readable (or writable); false on timeout
+bool waitSocket(curl_socket_t socket, bool forRead, std::chrono::milliseconds timeout) {
+#ifndef _WIN32
+    pollfd fd{socket, static_cast<short>(forRead ? POLLIN : POLLOUT), 0};
+    return ::poll(&fd, 1, static_cast<int>(timeout.count())) > 0;
+#else
+    fd_set set;
+    FD_ZERO(&set);
+    FD_SET(socket, &set);
+    timeval tv{static_cast<long>(timeout.count() / 1000), static_cast<long>(timeout.count() % 1000 * 1000)};
+    return ::select(0, forRead ? &set : nullptr, forRead ? nullptr : &set, nullptr, &tv) > 0;
+#endif
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+    });
+}
+
+// Walks a chunked body. Returns false while it is incomplete; once the last
+// chunk is in and `decode` is set, the chunk payloads are moved together at
+// the start of `data` and `length` receives their total size.
+bool dechunk(char* data, std::size_t size, bool decode, std::size_t& length) {
+    std::size_t in = 0;
+    std::size_t out = 0;
+    for (;;) {
+        auto lineEnd = std::string_view(data + in, size - in).find("\r\n");
+        if (lineEnd == std::string_view::npos) return false;
+        std::size_t chunk = 0;
+        auto parsed = std::from_chars(data + in, data + in + lineEnd, chunk, 16);
+        if (parsed.ptr == data + in) return false;
+        in += lineEnd + 2;
+        if (chunk == 0) {
+            // Optional trailers, then an empty line
+            auto end = std::string_view(data + in, size - in).find("\r\n");
+            while (end != std::string_view::npos && end != 0) {
+                in += end + 2;
+                end = std::string_view(data + in, size - in).find("\r\n");
+            }
+            if (end == std::string_view::npos) return false;
+            length = out;
+            return true;
+        }
+        if (size - in < chunk + 2) return false;
+        if (decode) std::memmove(data + out, data + in, chunk);
+        out += chunk;
+        in += chunk + 2;
+    }
+}
+
+} // namespace
+
+MarketBuyer::MarketBuyer(const Client& client, std::size_t maxListingIdLength)
+    : connection(std::make_unique<Connection>()), maxIdLength(maxListingIdLength) {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+
+    // https://host[:port]/prefix -> origin, authority and path prefix
+    const std::string& base = client.base_url;
+    auto authorityStart = base.find("://");
+    authorityStart = authorityStart == std::string::npos ? 0 : authorityStart + 3;
+    auto pathStart = std::min(base.find('/', authorityStart), base.size());
+    origin = base.substr(0, pathStart);
+    std::string authority = base.substr(authorityStart, pathStart - authorityStart);
+    std::string prefix = base.substr(pathStart);
+
+    const auto& route = detail::routes::marketBuy;
+    std::string head = "POST " + prefix + std::string(route.segment(0));
+    requestTail = std::string(route.segment(1)) + " HTTP/1.1\r\nHost: " + authority +
+                  "\r\nAuthorization: Bearer " + client.token +
+                  "\r\nContent-Type: application/json\r\nContent-Length: 2\r\nConnection: keep-alive\r\n\r\n{}";
+    warmRequest = "OPTIONS " + prefix + "/market-listings HTTP/1.1\r\nHost: " + authority + "\r\nOrigin: " + origin +
+                  "\r\nAccess-Control-Request-Method: POST\r\nConnection: keep-alive\r\n\r\n";
+
+    idOffset = head.size();
+    request.resize(head.size() + maxIdLength * 3 + requestTail.size());
+    std::memcpy(request.data(), head.data(), head.size());
+    response.resize(64 * 1024);
+
+    connect();
+}
+
+MarketBuyer::~MarketBuyer() = default;
+
+bool MarketBuyer::connected() const {
+    return connection->handle != nullptr;
+}
+
+bool MarketBuyer::connect() {
+    disconnect();
+    CURL* handle = curl_easy_init();
+    if (!handle) return false;
+
+    curl_easy_setopt(handle, CURLOPT_URL, origin.c_str());
+    curl_easy_setopt(handle, CURLOPT_CONNECT_ONLY, 1L);
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_1_1));
+    curl_easy_setopt(handle, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(responseTimeout.count()));
+    if (connection->resolve) {
+        curl_easy_setopt(handle, CURLOPT_RESOLVE, connection->resolve);
+    }
+
+    curl_socket_t socket = CURL_SOCKET_BAD;
+    if (curl_easy_perform(handle) != CURLE_OK ||
+        curl_easy_getinfo(handle, CURLINFO_ACTIVESOCKET, &socket) != CURLE_OK || socket == CURL_SOCKET_BAD) {
+        curl_easy_cleanup(handle);
+        return false;
+    }
+
+    if (!connection->resolve) {
+        char* address = nullptr;
+        char* host = nullptr;
+        long port = 0;
+        curl_easy_getinfo(handle, CURLINFO_PRIMARY_IP, &address);
+        curl_easy_getinfo(handle, CURLINFO_PRIMARY_PORT, &port);
+        CURLU* url = curl_url();
+        if (address && *address && url && curl_url_set(url, CURLUPART_URL, origin.c_str(), 0) == CURLUE_OK &&
+            curl_url_get(url, CURLUPART_HOST, &host, 0) == CURLUE_OK) {
+            std::string ip = address;
+            if (ip.find(':') != std::string::npos) ip = "[" + ip + "]";
+            std::string entry = std::string(host) + ":" + std::to_string(port) + ":" + ip;
+            connection->resolve = curl_slist_append(nullptr, entry.c_str());
+        }
+        curl_free(host);
+        curl_url_cleanup(url);
+    }
+
+    connection->handle = handle;
+    connection->socket = socket;
+    connection->lastUsed = std::chrono::steady_clock::now();
+    return true;
+}
+
+void MarketBuyer::disconnect() {
+    if (connection->handle) curl_easy_cleanup(connection->handle);
+    connection->handle = nullptr;
+    connection->socket = CURL_SOCKET_BAD;
+}
+
+bool MarketBuyer::warm() {
+    auto idle = std::chrono::steady_clock::now() - connection->lastUsed;
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if ((!connected() || idle >= idleTimeout || attempt > 0) && !connect()) return false;
+        BuyAttempt probe;
+        if (sendAll(warmRequest.data(), warmRequest.size()) &&
+            readResponse(probe, std::chrono::steady_clock::now())) {
+            return true;
+        }
+        // The server may have dropped the idle connection; the preflight is
+        // safe to repeat on a fresh one
+        disconnect();
+    }
+    return false;
+}
+
+BuyAttempt MarketBuyer::buy(std::string_view listingId) {
+    using Clock = std::chrono::steady_clock;
+    BuyAttempt attempt;
+    auto start = Clock::now();
+    auto finish = [&](std::string_view error) {
+        attempt.error = error;
+        attempt.timing.total = Clock::now() - start;
+        return attempt;
+    };
+    if (listingId.size() > maxIdLength) {
+        return finish("Listing ID too long");
+    }
+
+    attempt.timing.reusedConnection = connected() && start - connection->lastUsed < idleTimeout;
+    if (!attempt.timing.reusedConnection && !connect()) {
+        attempt.timing.connect = Clock::now() - start;
+        return finish("Cannot connect");
+    }
+    auto ready = Clock::now();
+    attempt.timing.connect = ready - start;
+
+    char* out = request.data() + idOffset;
+    for (char c : listingId) {
+        out = encodeByte(static_cast<unsigned char>(c), out);
+    }
+    std::memcpy(out, requestTail.data(), requestTail.size());
+    out += requestTail.size();
+    auto prepared = Clock::now();
+    attempt.timing.prepare = prepared - ready;
+
+    if (!sendAll(request.data(), static_cast<std::size_t>(out - request.data()))) {
+        disconnect();
+        attempt.timing.send = Clock::now() - prepared;
+        return finish("Send failed");
+    }
+    auto sent = Clock::now();
+    attempt.timing.send = sent - prepared;
+
+    if (!readResponse(attempt, sent)) {
+        disconnect();
+        return finish(attempt.status ? "Malformed response" : "No response");
+    }
+    attempt.success = attempt.status >= 200 && attempt.status < 300;
+    return finish({});
+}
+
+bool MarketBuyer::sendAll(const char* data, std::size_t size) {
+    auto deadline = std::chrono::steady_clock::now() + responseTimeout;
+    while (size > 0) {
+        std::size_t written = 0;
+        CURLcode code = curl_easy_send(connection->handle, data, size, &written);
+        if (code == CURLE_AGAIN) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if (left.count() <= 0 || !waitSocket(connection->socket, false, left)) return false;
+            continue;
+        }
+        if (code != CURLE_OK) return false;
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool MarketBuyer::readResponse(BuyAttempt& attempt, std::chrono::steady_clock::time_point sent) {
+    using Clock = std::chrono::steady_clock;
+    auto deadline = sent + responseTimeout;
+    Clock::time_point first;
+    char* data = response.data();
+    std::size_t used = 0;
+    std::size_t headerEnd = 0;
+    std::optional<std::size_t> contentLength;
+    bool chunked = false;
+    bool close = false;
+
+    for (;;) {
+        std::size_t received = 0;
+        CURLcode code = used == response.size()
+                            ? CURLE_OUT_OF_MEMORY
+                            : curl_easy_recv(connection->handle, data + used, response.size() - used, &received);
+        if (code == CURLE_AGAIN) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+            if (left.count() <= 0 || !waitSocket(connection->socket, true, left)) return false;
+            continue;
+        }
+        if (code != CURLE_OK) return false;
+        if (used == 0 && received > 0) {
+            first = Clock::now();
+            attempt.timing.firstByte = first - sent;
+        }
+
+        bool eof = received == 0;
+        used += received;
+
+        if (headerEnd == 0) {
+            auto end = std::string_view(data, used).find("\r\n\r\n");
+            if (end == std::string_view::npos) {
+                if (eof) return false;
+                continue;
+            }
+            headerEnd = end + 4;
+
+            std::string_view head(data, end);
+            auto lineEnd = head.find("\r\n");
+            std::string_view statusLine = head.substr(0, lineEnd);
+            auto space = statusLine.find(' ');
+            if (space == std::string_view::npos) return false;
+            std::from_chars(statusLine.data() + space + 1, statusLine.data() + statusLine.size(), attempt.status);
+
+            while (lineEnd != std::string_view::npos) {
+                head.remove_prefix(lineEnd + 2);
+                lineEnd = head.find("\r\n");
+                std::string_view line = head.substr(0, lineEnd);
+                auto colon = line.find(':');
+                if (colon == std::string_view::npos) continue;
+                std::string_view name = line.substr(0, colon);
+                std::string_view value = line.substr(colon + 1);
+                while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+                if (equalsIgnoreCase(name, "content-length")) {
+                    std::size_t length = 0;
+                    std::from_chars(value.data(), value.data() + value.size(), length);
+                    contentLength = length;
+                } else if (equalsIgnoreCase(name, "transfer-encoding")) {
+                    chunked = equalsIgnoreCase(value, "chunked");
+                } else if (equalsIgnoreCase(name, "connection")) {
+                    close = equalsIgnoreCase(value, "close");
+                }
+            }
+            if (attempt.status == 204 || attempt.status == 304 || attempt.status / 100 == 1) {
+                contentLength = 0;
+            }
+        }
+
+        std::size_t bodyLength = 0;
+        bool complete = false;
+        if (chunked) {
+            complete = dechunk(data + headerEnd, used - headerEnd, false, bodyLength);
+            if (complete) dechunk(data + headerEnd, used - headerEnd, true, bodyLength);
+        } else if (contentLength) {
+            complete = used - headerEnd >= *contentLength;
+            bodyLength = *contentLength;
+        } else {
+            // Body delimited by the end of the connection
+            complete = eof;
+            bodyLength = used - headerEnd;
+            close = true;
+        }
+
+        if (complete) {
+            attempt.body = std::string_view(data + headerEnd, bodyLength);
+            attempt.timing.receive = Clock::now() - first;
+            connection->lastUsed = Clock::now();
+            if (close || eof) disconnect();
+            return true;
+        }
+        if (eof) return false;
+    }
+}
+
+// GameViewAggregator
+GameViewAggregator::GameViewAggregator(const Client& client, TelemetryOptions options)
+    : client(client), options(options), queue(options.queueCapacity) {
+    pending.reserve(options.maxPendingViews);
+    worker = std::thread([this] { run(); });
+}
+
+GameViewAggregator::~GameViewAggregator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void GameViewAggregator::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    std::uint64_t ticket = ++flushRequested;
+    wake.notify_one();
+    flushed.wait(lock, [&] { return flushCompleted >= ticket; });
+}
+
+TelemetryStats GameViewAggregator::stats() const {
+    TelemetryStats stats;
+    stats.recorded = recorded.load(std::memory_order_relaxed);
+    stats.dropped = dropped.load(std::memory_order_relaxed);
+    stats.coalesced = coalesced.load(std::memory_order_relaxed);
+    stats.sent = sent.load(std::memory_order_relaxed);
+    stats.failed = failed.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void GameViewAggregator::run() {
+    using Clock = std::chrono::steady_clock;
+    // Producers only signal once the queue is half full, so it is also
+    // drained on this period to keep it short
+    const auto poll = std::min<std::chrono::milliseconds>(options.flushInterval, std::chrono::milliseconds(50));
+    cpr::Session session;
+    auto nextFlush = Clock::now() + options.flushInterval;
+
+    for (;;) {
+        bool full = !drain();
+        std::uint64_t ticket;
+        bool stop;
+        bool requested;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ticket = flushRequested;
+            stop = stopping;
+            requested = flushRequested != flushCompleted;
+        }
+
+        if (full || requested || stop || Clock::now() >= nextFlush) {
+            // Everything queued before the request (or shutdown) goes out now
+            while (!drain()) {
+                send(session);
+            }
+            send(session);
+            nextFlush = Clock::now() + options.flushInterval;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                flushCompleted = ticket;
+            }
+            flushed.notify_all();
+            if (stop) return;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait_until(lock, std::min(nextFlush, Clock::now() + poll), [this] {
+            return stopping || flushRequested != flushCompleted || wakeRequested.load();
+        });
+        wakeRequested = false;
+    }
+}
+
+bool GameViewAggregator::drain() {
+    View view;
+    while (pending.size() < options.maxPendingViews && queue.pop(view)) {
+        std::uint64_t key = keyOf(view);
+        if (counted.count(key)) {
+            coalesced.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        Pending& entry = pending[key];
+        entry.view = view;
+        ++entry.views;
+    }
+    queue.publishHead();
+    return pending.size() < options.maxPendingViews;
+}
+
+void GameViewAggregator::send(cpr::Session& session) {
+    auto minutes = std::chrono::duration_cast<std::chrono::minutes>(
+                       std::chrono::system_clock::now().time_since_epoch()) + options.serverUtcOffset;
+    auto day = minutes.count() / (24 * 60);
+    // The server's "already viewed" window is its calendar day; the set is
+    // also capped so a long-running process with many viewers stays bounded
+    if (day != countedDay || counted.size() > options.maxPendingViews * 64) {
+        counted.clear();
+        countedDay = day;
+    }
+
+    for (auto it = pending.begin(); it != pending.end();) {
+        Pending& entry = it->second;
+        bool anonymous = entry.view.viewer.empty();
+        cpr::Header headers = client.preparedHeaders();
+        if (!anonymous) {
+            headers["Cookie"] = "viewer_id=" + std::string(entry.view.viewer.str());
+        }
+        session.SetUrl(cpr::Url{client.base_url + detail::routes::gameView.expand(entry.view.game.str())});
+        session.SetHeader(headers);
+        session.SetBody(cpr::Body{"{}"});
+
+        // Each anonymous view is a new viewer to the server, so it needs its own POST
+        bool delivered = true;
+        for (std::uint64_t posts = anonymous ? entry.views : 1; posts > 0; --posts) {
+            cpr::Response response = session.Post();
+            // cpr keeps curl's cookie engine on, which would replay the
+            // viewer_id the server just assigned on every later request
+            curl_easy_setopt(session.GetCurlHolder()->handle, CURLOPT_COOKIELIST, "ALL");
+            if (response.error || response.status_code < 200 || response.status_code >= 300) {
+                delivered = false;
+                break;
+            }
+            sent.fetch_add(1, std::memory_order_relaxed);
+            if (anonymous) {
+                --entry.views;
+            }
+        }
+
+        if (delivered) {
+            if (!anonymous) {
+                coalesced.fetch_add(entry.views - 1, std::memory_order_relaxed);
+                counted.insert(it->first);
+            }
+            it = pending.erase(it);
+        } else if (++entry.attempts >= options.maxAttempts) {
+            failed.fetch_add(entry.views, std::memory_order_relaxed);
+            it = pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// MutationQueue
+namespace {
+
+// A mutation on the wire: the easy handle's buffers live here until it completes
+struct MutationTransfer {
+    explicit MutationTransfer(CURL* handle = curl_easy_init()) : handle(handle, &curl_easy_cleanup) {}
+
+    std::unique_ptr<CURL, decltype(&curl_easy_cleanup)> handle;
+    std::uint64_t ticket = 0;
+    MutationKind kind = MutationKind::Give;
+    std::string url;
+    std::string body;
+    std::string response;
+};
+
+size_t collectResponse(char* data, size_t size, size_t count, void* userdata) {
+    static_cast<std::string*>(userdata)->append(data, size * count);
+    return size * count;
+}
+
+// Configures the transfer's handle; `headers` must outlive it
+void prepareTransfer(MutationTransfer& transfer, const char* method, curl_slist* headers,
+                     std::chrono::milliseconds timeout) {
+    CURL* handle = transfer.handle.get();
+    curl_easy_setopt(handle, CURLOPT_URL, transfer.url.c_str());
+    curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, method);
+    curl_easy_setopt(handle, CURLOPT_POSTFIELDS, transfer.body.data());
+    curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, static_cast<long>(transfer.body.size()));
+    curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "");
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, collectResponse);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &transfer.response);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, static_cast<long>(timeout.count()));
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+}
+
+Result<json> transferResult(CURLcode code, MutationTransfer& transfer) {
+    if (code != CURLE_OK) {
+        return Error{ErrorCode::Transport, 0, curl_easy_strerror(code)};
+    }
+    long status = 0;
+    char* contentType = nullptr;
+    curl_easy_getinfo(transfer.handle.get(), CURLINFO_RESPONSE_CODE, &status);
+    curl_easy_getinfo(transfer.handle.get(), CURLINFO_CONTENT_TYPE, &contentType);
+    return resultOf(status, transfer.response, contentType ? contentType : "");
+}
+
+} // namespace
+
+struct MutationQueue::Transport {
+    std::unique_ptr<CURLM, decltype(&curl_multi_cleanup)> multi{curl_multi_init(), &curl_multi_cleanup};
+};
+
+MutationQueue::MutationQueue(const Client& client, MutationQueueOptions options)
+    : options(options), baseUrl(client.base_url), submissions(options.capacity), completions(options.capacity),
+      transport(std::make_unique<Transport>()) {
+    if (client.token.empty()) {
+        throw std::runtime_error("Token is required");
+    }
+    authorization = "Authorization: Bearer " + client.token;
+    this->options.maxInFlight = std::max<std::size_t>(1, options.maxInFlight);
+    curl_multi_setopt(transport->multi.get(), CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(transport->multi.get(), CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(this->options.maxInFlight));
+    dispatcher = std::thread([this] { run(); });
+}
+
+MutationQueue::~MutationQueue() {
+    stopping = true;
+    curl_multi_wakeup(transport->multi.get());
+    dispatcher.join();
+    MutationResult* result;
+    while (completions.pop(result)) {
+        delete result;
+    }
+}
+
+std::uint64_t MutationQueue::give(const std::string& itemId, int amount, const std::string& userId,
+                                  const std::optional<Metadata>& metadata) {
+    return submit(MutationKind::Give, "POST", detail::routes::itemGive.expand(itemId), giveBody(amount, userId, metadata));
+}
+
+std::uint64_t MutationQueue::consume(const std::string& itemId, const std::string& userId,
+                                     const std::optional<int>& amount, const std::optional<std::string>& uniqueId) {
+    return submit(MutationKind::Consume, "POST", detail::routes::itemConsume.expand(itemId),
+                  instanceBody(userId, amount, uniqueId));
+}
+
+std::uint64_t MutationQueue::updateMetadata(const std::string& itemId, const std::string& uniqueId,
+                                            const Metadata& metadata) {
+    return submit(MutationKind::UpdateMetadata, "PUT", detail::routes::itemUpdateMetadata.expand(itemId),
+                  metadataBody(uniqueId, metadata));
+}
+
+std::uint64_t MutationQueue::transferCredits(const std::string& targetUserId, double amount) {
+    return submit(MutationKind::TransferCredits, "POST", "/users/transfer-credits", transferBody(targetUserId, amount));
+}
+
+std::uint64_t MutationQueue::submit(MutationKind kind, const char* method, std::string endpoint, const std::string& body) {
+    std::uint64_t ticket = nextTicket.fetch_add(1, std::memory_order_relaxed);
+    auto mutation = std::make_unique<Mutation>(Mutation{ticket, kind, method, std::move(endpoint), body});
+    if (!submissions.push(mutation.get())) {
+        return 0;
+    }
+    mutation.release();
+    submitted.fetch_add(1, std::memory_order_relaxed);
+    curl_multi_wakeup(transport->multi.get());
+    return ticket;
 }
 
-std::optional<Lobby> Client::Lobbies::get(const std::string& lobbyId) const {
-    auto response = client.makeRequest("GET", "/lobbies/" + lobbyId);
-    if (response.success) {
-        return Lobby(response.data);
+bool MutationQueue::poll(MutationResult& out) {
+    MutationResult* result;
+    if (!completions.pop(result)) {
+        return false;
     }
-    return std::nullopt;
+    completions.publishHead();
+    out = std::move(*result);
+    delete result;
+    return true;
 }
 
-std::optional<Lobby> Client::Lobbies::getMyLobby() const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+void MutationQueue::run() {
+    CURLM* multi = transport->multi.get();
+
+    curl_slist* headers = curl_slist_append(nullptr, "Content-Type: application/json");
+    headers = curl_slist_append(headers, authorization.c_str());
+    std::unique_ptr<curl_slist, decltype(&curl_slist_free_all)> headerList(headers, &curl_slist_free_all);
+
+    std::unordered_map<CURL*, std::unique_ptr<MutationTransfer>> running;
+    // Results waiting for room in the completion queue
+    std::deque<MutationResult*> overflow;
+
+    auto deliver = [&](MutationResult* result) {
+        if (!overflow.empty() || !completions.push(result)) {
+            overflow.push_back(result);
+        } else {
+            completed.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    for (;;) {
+        while (!overflow.empty() && completions.push(overflow.front())) {
+            overflow.pop_front();
+            completed.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Mutation* next;
+        while (running.size() < options.maxInFlight && submissions.pop(next)) {
+            std::unique_ptr<Mutation> mutation(next);
+            auto transfer = std::make_unique<MutationTransfer>();
+            transfer->ticket = mutation->ticket;
+            transfer->kind = mutation->kind;
+            transfer->url = baseUrl + mutation->endpoint;
+            transfer->body = std::move(mutation->body);
+
+            prepareTransfer(*transfer, mutation->method, headers, options.requestTimeout);
+            CURL* handle = transfer->handle.get();
+            curl_multi_add_handle(multi, handle);
+            running.emplace(handle, std::move(transfer));
+        }
+        submissions.publishHead();
+
+        int active = 0;
+        curl_multi_perform(multi, &active);
+
+        int queued = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi, &queued)) {
+            if (message->msg != CURLMSG_DONE) continue;
+            auto it = running.find(message->easy_handle);
+            if (it == running.end()) continue;
+            MutationTransfer& transfer = *it->second;
+
+            auto result = std::make_unique<MutationResult>();
+            result->ticket = transfer.ticket;
+            result->kind = transfer.kind;
+            result->result = transferResult(message->data.result, transfer);
+            curl_multi_remove_handle(multi, message->easy_handle);
+            running.erase(it);
+            deliver(result.release());
+        }
+
+        // Nobody polls during shutdown, so results still in overflow are dropped below
+        if (stopping && running.empty() && submissions.sizeApprox() == 0) {
+            break;
+        }
+        // Sleeps until socket activity, a curl timer, or a wakeup from submit()
+        // or the destructor. Nothing signals when the game polls results out
+        // of a full completion queue, so overflow is retried every frame.
+        auto wait = overflow.empty() ? options.idleWait : std::min(options.idleWait, std::chrono::milliseconds(16));
+        curl_multi_poll(multi, nullptr, 0, static_cast<int>(wait.count()), nullptr);
     }
-    
-    auto response = client.makeRequest("GET", "/lobbies/user/@me", json::object(), true);
-    if (response.success) {
-        return Lobby(response.data);
+    for (MutationResult* result : overflow) {
+        delete result;
     }
-    return std::nullopt;
 }
 
-std::optional<Lobby> Client::Lobbies::getUserLobby(const std::string& userId) const {
-    auto response = client.makeRequest("GET", "/lobbies/user/" + userId);
-    if (response.success) {
-        return Lobby(response.data);
+// MutationJournal
+namespace {
+
+// File header; bump the last digits if the record layout changes
+const char journalMagic[8] = {'C', 'R', 'J', 'R', 'N', 'L', '0', '1'};
+// Every record starts with its payload length, a CRC-32 of type and payload, and its type
+constexpr std::size_t journalRecordHeader = 9;
+constexpr std::size_t journalKeyLength = 32;
+
+enum class JournalRecord : std::uint8_t {
+    Append = 1,  // the mutation, written before it is first sent
+    Sent = 2,    // a request went out; the server may have applied it
+    Unsent = 3,  // the last request never reached the server
+    Settled = 4  // answered, or resolved by the caller; carries the status
+};
+
+enum class JournalOutcome {
+    Acknowledged,
+    Rejected,
+    Unsent,
+    Uncertain
+};
+
+JournalOutcome outcomeOf(CURLcode code, long status) {
+    switch (code) {
+        case CURLE_OK:
+            break;
+        // Failed before any byte of the request was delivered
+        case CURLE_COULDNT_RESOLVE_PROXY:
+        case CURLE_COULDNT_RESOLVE_HOST:
+        case CURLE_COULDNT_CONNECT:
+        case CURLE_SSL_CONNECT_ERROR:
+            return JournalOutcome::Unsent;
+        default:
+            return JournalOutcome::Uncertain;
     }
-    return std::nullopt;
+    if (status >= 200 && status < 300) return JournalOutcome::Acknowledged;
+    // Turned away without being processed
+    if (status == 408 || status == 429) return JournalOutcome::Unsent;
+    if (status >= 400 && status < 500) return JournalOutcome::Rejected;
+    return JournalOutcome::Uncertain;
 }
 
-APIResponse Client::Lobbies::join(const std::string& lobbyId) const {
+void putU32(std::string& out, std::uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xff));
+    }
+}
+
+std::uint32_t getU32(const char* data) {
+    std::uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) {
+        value = (value << 8) | static_cast<unsigned char>(data[i]);
+    }
+    return value;
+}
+
+void putField(std::string& out, std::string_view field) {
+    putU32(out, static_cast<std::uint32_t>(field.size()));
+    out.append(field);
+}
+
+bool takeField(std::string_view& in, std::string& out) {
+    if (in.size() < 4) return false;
+    std::uint32_t length = getU32(in.data());
+    if (length > in.size() - 4) return false;
+    out.assign(in.data() + 4, length);
+    in.remove_prefix(4 + length);
+    return true;
+}
+
+std::uint32_t journalChecksum(const char* typeAndPayload, std::size_t size) {
+    uLong crc = crc32(0L, Z_NULL, 0);
+    return static_cast<std::uint32_t>(crc32(crc, reinterpret_cast<const Bytef*>(typeAndPayload), static_cast<uInt>(size)));
+}
+
+void putRecord(std::string& out, JournalRecord type, std::string_view payload) {
+    std::size_t start = out.size();
+    putU32(out, static_cast<std::uint32_t>(payload.size()));
+    putU32(out, 0);
+    out.push_back(static_cast<char>(type));
+    out.append(payload);
+    std::uint32_t crc = journalChecksum(out.data() + start + 8, payload.size() + 1);
+    for (int i = 0; i < 4; ++i) {
+        out[start + 4 + i] = static_cast<char>((crc >> (8 * i)) & 0xff);
+    }
+}
+
+// The Append record, plus Sent when the entry is uncertain; returns the bytes written
+std::size_t putEntry(std::string& out, const JournalEntry& entry) {
+    std::size_t start = out.size();
+    std::string payload = entry.key;
+    payload.push_back(static_cast<char>(entry.kind));
+    putField(payload, entry.method);
+    putField(payload, entry.endpoint);
+    putField(payload, entry.body);
+    putRecord(out, JournalRecord::Append, payload);
+    if (entry.uncertain) {
+        putRecord(out, JournalRecord::Sent, entry.key);
+    }
+    return out.size() - start;
+}
+
+bool parseEntry(std::string_view payload, JournalEntry& entry) {
+    if (payload.size() < journalKeyLength + 1) return false;
+    entry.key.assign(payload.data(), journalKeyLength);
+    auto kind = static_cast<unsigned char>(payload[journalKeyLength]);
+    if (kind > static_cast<unsigned char>(MutationKind::Buy)) return false;
+    entry.kind = static_cast<MutationKind>(kind);
+    payload.remove_prefix(journalKeyLength + 1);
+    return takeField(payload, entry.method) && takeField(payload, entry.endpoint) && takeField(payload, entry.body);
+}
+
+// Append-only log file. Memory-mapped on POSIX, so an append is a memcpy and
+// only sync() touches the disk; plain stdio elsewhere.
+class JournalFile {
+public:
+    JournalFile() = default;
+    JournalFile(const JournalFile&) = delete;
+    JournalFile& operator=(const JournalFile&) = delete;
+    ~JournalFile() { close(); }
+
+    // Opens without truncating, creating the file when missing
+    bool open(const std::filesystem::path& path, std::size_t growBy) {
+        close();
+        step = std::max<std::size_t>(growBy, 4096);
+#ifndef _WIN32
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) return false;
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            close();
+            return false;
+        }
+        fileSize = opened = used = synced = static_cast<std::size_t>(info.st_size);
+        if (!map(roundUp(std::max<std::size_t>(used, 1)))) {
+            close();
+            return false;
+        }
+        return true;
+#else
+        file = std::fopen(path.string().c_str(), "r+b");
+        if (!file) file = std::fopen(path.string().c_str(), "w+b");
+        if (!file) return false;
+        char buffer[65536];
+        std::size_t got;
+        while ((got = std::fread(buffer, 1, sizeof buffer, file)) > 0) {
+            loaded.append(buffer, got);
+        }
+        used = synced = loaded.size();
+        return true;
+#endif
+    }
+
+    // What the file held when opened; valid until truncate() or append()
+    std::string_view contents() const {
+#ifndef _WIN32
+        return std::string_view(mapped, opened);
+#else
+        return loaded;
+#endif
+    }
+
+    // Drops everything from `size` on, such as a record torn by a crash
+    bool truncate(std::size_t size) {
+#ifndef _WIN32
+        if (!mapped) return false;
+        if (size < used) std::memset(mapped + size, 0, used - size);
+        used = std::min(used, size);
+        synced = std::min(synced, used);
+        opened = 0;
+        return true;
+#else
+        loaded.clear();
+        if (!file || std::fflush(file) != 0 || _chsize_s(_fileno(file), static_cast<long long>(size)) != 0) return false;
+        used = synced = size;
+        return true;
+#endif
+    }
+
+    bool append(std::string_view data) {
+#ifndef _WIN32
+        if (!mapped) return false;
+        if (data.size() > mappedSize - used && !map(roundUp(used + data.size()))) return false;
+        std::memcpy(mapped + used, data.data(), data.size());
+#else
+        if (!file || _fseeki64(file, static_cast<long long>(used), SEEK_SET) != 0 ||
+            std::fwrite(data.data(), 1, data.size(), file) != data.size()) {
+            return false;
+        }
+#endif
+        used += data.size();
+        return true;
+    }
+
+    // Makes every appended byte durable
+    bool sync() {
+        if (synced == used) return true;
+#ifndef _WIN32
+        static const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        std::size_t start = synced / page * page;
+        if (::msync(mapped + start, used - start, MS_SYNC) != 0) return false;
+#else
+        if (std::fflush(file) != 0 || _commit(_fileno(file)) != 0) return false;
+#endif
+        synced = used;
+        return true;
+    }
+
+    void close() {
+#ifndef _WIN32
+        if (mapped) {
+            sync();
+            ::munmap(mapped, mappedSize);
+            // Drop the unused tail of the last growth step
+            if (::ftruncate(fd, static_cast<off_t>(used)) != 0) {}
+        }
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+        mapped = nullptr;
+        mappedSize = 0;
+#else
+        if (file) {
+            sync();
+            std::fclose(file);
+        }
+        file = nullptr;
+        loaded.clear();
+#endif
+        used = synced = 0;
+    }
+
+    std::size_t size() const { return used; }
+
+private:
+#ifndef _WIN32
+    std::size_t roundUp(std::size_t size) const { return (size + step - 1) / step * step; }
+
+    bool map(std::size_t length) {
+        if (mapped) {
+            ::munmap(mapped, mappedSize);
+            mapped = nullptr;
+            mappedSize = 0;
+        }
+        if (length > fileSize) {
+            if (::ftruncate(fd, static_cast<off_t>(length)) != 0) return false;
+            fileSize = length;
+        }
+        void* address = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED) return false;
+        mapped = static_cast<char*>(address);
+        mappedSize = length;
+        return true;
+    }
+
+    int fd = -1;
+    char* mapped = nullptr;
+    std::size_t mappedSize = 0;
+    std::size_t fileSize = 0;
+    std::size_t opened = 0;
+#else
+    std::FILE* file = nullptr;
+    std::string loaded;
+#endif
+    std::size_t step = 0;
+    std::size_t used = 0;
+    std::size_t synced = 0;
+};
+
+} // namespace
+
+struct MutationJournal::Impl {
+    struct Live {
+        JournalEntry entry;
+        std::size_t bytes = 0; // size of this entry's records in the log
+        bool sending = false;  // a request for it is on the wire right now
+    };
+
+    // One request on the wire, with its own Idempotency-Key header
+    struct Transfer {
+        explicit Transfer(CURL* handle = curl_easy_init()) : transfer(handle) {}
+
+        MutationTransfer transfer;
+        std::unique_ptr<curl_slist, decltype(&curl_slist_free_all)> headers{nullptr, &curl_slist_free_all};
+        std::string key;
+    };
+
+    ~Impl() {
+        for (CURL* handle : idle) {
+            curl_easy_cleanup(handle);
+        }
+    }
+
+    void load();
+    void apply(JournalRecord type, std::string_view payload, std::size_t size);
+    std::string newKey();
+    bool write(const std::string& records);
+    bool begin(const std::string& key, std::string& records);
+    void finish(const std::string& key, JournalOutcome outcome, long status);
+    void prepare(Transfer& transfer, const JournalEntry& entry);
+    void maybeCompact();
+    void compact();
+
+    JournalOptions options;
+    std::filesystem::path path;
+    std::string baseUrl;
+    std::string authorization;
+    JournalFile file;
+    std::mutex mutex;
+    std::list<Live> entries;
+    std::unordered_map<std::string, std::list<Live>::iterator> byKey;
+    // Bytes of records that no longer describe an unsettled entry
+    std::size_t garbage = 0;
+    std::random_device entropy;
+    // Easy handles kept for their open connections
+    std::vector<CURL*> idle;
+};
+
+void MutationJournal::Impl::load() {
+    std::string_view data = file.contents();
+    if (data.empty()) {
+        file.append(std::string_view(journalMagic, sizeof journalMagic));
+        file.sync();
+        return;
+    }
+    if (data.size() < sizeof journalMagic || data.compare(0, sizeof journalMagic, std::string_view(journalMagic, sizeof journalMagic)) != 0) {
+        throw std::runtime_error("Not a mutation journal: " + path.string());
+    }
+
+    std::size_t offset = sizeof journalMagic;
+    while (data.size() - offset >= journalRecordHeader) {
+        const char* record = data.data() + offset;
+        std::uint32_t length = getU32(record);
+        if (length > data.size() - offset - journalRecordHeader) break;
+        // The first bad record marks where a crash cut the log short
+        if (journalChecksum(record + 8, length + 1) != getU32(record + 4)) break;
+        apply(static_cast<JournalRecord>(record[8]), std::string_view(record + journalRecordHeader, length),
+              journalRecordHeader + length);
+        offset += journalRecordHeader + length;
+    }
+    file.truncate(offset);
+}
+
+void MutationJournal::Impl::apply(JournalRecord type, std::string_view payload, std::size_t size) {
+    if (type == JournalRecord::Append) {
+        Live live;
+        live.bytes = size;
+        if (!parseEntry(payload, live.entry) || byKey.count(live.entry.key)) {
+            garbage += size;
+            return;
+        }
+        entries.push_back(std::move(live));
+        byKey.emplace(entries.back().entry.key, std::prev(entries.end()));
+        return;
+    }
+
+    auto it = payload.size() >= journalKeyLength ? byKey.find(std::string(payload.substr(0, journalKeyLength))) : byKey.end();
+    if (it == byKey.end()) {
+        garbage += size;
+        return;
+    }
+    Live& live = *it->second;
+    switch (type) {
+        case JournalRecord::Sent:
+        case JournalRecord::Unsent:
+            live.entry.uncertain = type == JournalRecord::Sent;
+            live.bytes += size;
+            break;
+        case JournalRecord::Settled:
+            garbage += live.bytes + size;
+            entries.erase(it->second);
+            byKey.erase(it);
+            break;
+        default:
+            garbage += size;
+    }
+}
+
+std::string MutationJournal::Impl::newKey() {
+    // 128 random bits, so keys from different processes never collide
+    char key[journalKeyLength + 1];
+    std::snprintf(key, sizeof key, "%08x%08x%08x%08x", entropy(), entropy(), entropy(), entropy());
+    return std::string(key, journalKeyLength);
+}
+
+bool MutationJournal::Impl::write(const std::string& records) {
+    if (records.empty()) return true;
+    if (!file.append(records)) return false;
+    return !options.syncEveryAppend || file.sync();
+}
+
+// Marks an entry as being sent, recording that the server may see it
+bool MutationJournal::Impl::begin(const std::string& key, std::string& records) {
+    auto it = byKey.find(key);
+    if (it == byKey.end() || it->second->sending) return false;
+    Live& live = *it->second;
+    live.sending = true;
+    if (!live.entry.uncertain) {
+        std::size_t before = records.size();
+        putRecord(records, JournalRecord::Sent, key);
+        live.bytes += records.size() - before;
+        live.entry.uncertain = true;
+    }
+    return true;
+}
+
+void MutationJournal::Impl::finish(const std::string& key, JournalOutcome outcome, long status) {
+    auto it = byKey.find(key);
+    // Resolved by the caller while the request was out
+    if (it == byKey.end()) return;
+    Live& live = *it->second;
+    live.sending = false;
+
+    std::string records;
+    switch (outcome) {
+        case JournalOutcome::Uncertain:
+            // The Sent record already says so
+            return;
+        case JournalOutcome::Unsent:
+            putRecord(records, JournalRecord::Unsent, key);
+            live.entry.uncertain = false;
+            live.bytes += records.size();
+            break;
+        default: {
+            std::string payload = key;
+            putU32(payload, static_cast<std::uint32_t>(status));
+            putRecord(records, JournalRecord::Settled, payload);
+            garbage += live.bytes + records.size();
+            entries.erase(it->second);
+            byKey.erase(it);
+        }
+    }
+    // A lost write only means the entry comes back as uncertain after a restart
+    file.append(records);
+    maybeCompact();
+}
+
+void MutationJournal::Impl::prepare(Transfer& transfer, const JournalEntry& entry) {
+    transfer.key = entry.key;
+    transfer.transfer.url = baseUrl + entry.endpoint;
+    transfer.transfer.body = entry.body;
+    curl_slist* headers = curl_slist_append(nullptr, "Content-Type: application/json");
+    headers = curl_slist_append(headers, authorization.c_str());
+    headers = curl_slist_append(headers, ("Idempotency-Key: " + entry.key).c_str());
+    transfer.headers.reset(headers);
+    prepareTransfer(transfer.transfer, entry.method.c_str(), headers, options.requestTimeout);
+}
+
+void MutationJournal::Impl::maybeCompact() {
+    // The file grows in whole steps, so compacting a smaller log frees nothing
+    if (file.size() >= options.growBy && garbage > options.compactRatio * static_cast<double>(file.size())) {
+        compact();
+    }
+}
+
+void MutationJournal::Impl::compact() {
+    namespace fs = std::filesystem;
+    fs::path staging = path;
+    staging += ".compact";
+    std::error_code ec;
+    fs::remove(staging, ec);
+
+    std::string records(journalMagic, sizeof journalMagic);
+    std::vector<std::size_t> sizes;
+    sizes.reserve(entries.size());
+    for (const Live& live : entries) {
+        sizes.push_back(putEntry(records, live.entry));
+    }
+    {
+        JournalFile next;
+        if (!next.open(staging, options.growBy) || !next.append(records) || !next.sync()) {
+            next.close();
+            fs::remove(staging, ec);
+            return;
+        }
+    }
+
+    // Until the rename lands, the old log is still complete
+    file.close();
+    fs::rename(staging, path, ec);
+    if (ec) {
+        fs::remove(staging, ec);
+    } else {
+        garbage = 0;
+        std::size_t i = 0;
+        for (Live& live : entries) {
+            live.bytes = sizes[i++];
+        }
+    }
+    // Reopened only to append; the records are already in memory
+    if (file.open(path, options.growBy)) {
+        file.truncate(file.size());
+    }
+}
+
+MutationJournal::MutationJournal(const Client& client, const std::filesystem::path& path, JournalOptions options)
+    : impl(std::make_unique<Impl>()) {
     if (client.token.empty()) {
         throw std::runtime_error("Token is required");
     }
-    
-    return client.makeRequest("POST", "/lobbies/" + lobbyId + "/join", json::object(), true);
+    impl->options = options;
+    impl->options.replayBatch = std::max<std::size_t>(1, options.replayBatch);
+    impl->path = path;
+    impl->baseUrl = client.base_url;
+    impl->authorization = "Authorization: Bearer " + client.token;
+    if (!impl->file.open(path, options.growBy)) {
+        throw std::runtime_error("Cannot open mutation journal: " + path.string());
+    }
+    impl->load();
+    impl->maybeCompact();
+}
+
+MutationJournal::~MutationJournal() = default;
+
+Result<json> MutationJournal::give(const std::string& itemId, int amount, const std::string& userId,
+                                   const std::optional<Metadata>& metadata) {
+    return record(MutationKind::Give, "POST", detail::routes::itemGive.expand(itemId), giveBody(amount, userId, metadata));
+}
+
+Result<json> MutationJournal::consume(const std::string& itemId, const std::string& userId,
+                                      const std::optional<int>& amount, const std::optional<std::string>& uniqueId) {
+    return record(MutationKind::Consume, "POST", detail::routes::itemConsume.expand(itemId),
+                  instanceBody(userId, amount, uniqueId));
+}
+
+Result<json> MutationJournal::buy(const std::string& itemId, int amount) {
+    return record(MutationKind::Buy, "POST", detail::routes::itemBuy.expand(itemId), amountBody(amount));
+}
+
+Result<json> MutationJournal::record(MutationKind kind, const char* method, std::string endpoint, std::string body) {
+    JournalEntry entry;
+    entry.kind = kind;
+    entry.method = method;
+    entry.endpoint = std::move(endpoint);
+    entry.body = std::move(body);
+    entry.uncertain = true;
+
+    CURL* handle = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(impl->mutex);
+        entry.key = impl->newKey();
+        // Journaled as sent up front: if the process dies mid-request, the server may have it
+        std::string records;
+        std::size_t bytes = putEntry(records, entry);
+        if (!impl->write(records)) {
+            return Error{ErrorCode::Transport, 0, "Could not write to the mutation journal"};
+        }
+        impl->entries.push_back(Impl::Live{entry, bytes, true});
+        impl->byKey.emplace(entry.key, std::prev(impl->entries.end()));
+        if (!impl->idle.empty()) {
+            handle = impl->idle.back();
+            impl->idle.pop_back();
+            curl_easy_reset(handle);
+        }
+    }
+
+    Impl::Transfer transfer(handle ? handle : curl_easy_init());
+    impl->prepare(transfer, entry);
+    CURLcode code = curl_easy_perform(transfer.transfer.handle.get());
+    long status = 0;
+    curl_easy_getinfo(transfer.transfer.handle.get(), CURLINFO_RESPONSE_CODE, &status);
+    Result<json> result = transferResult(code, transfer.transfer);
+
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    impl->idle.push_back(transfer.transfer.handle.release());
+    impl->finish(entry.key, outcomeOf(code, status), status);
+    if (impl->options.syncEveryAppend) impl->file.sync();
+    return result;
+}
+
+JournalReplay MutationJournal::replay() {
+    JournalReplay summary;
+    std::vector<JournalEntry> queue;
+    {
+        std::lock_guard<std::mutex> lock(impl->mutex);
+        for (const Impl::Live& live : impl->entries) {
+            if (!live.sending && (!live.entry.uncertain || impl->options.replayUncertain)) {
+                queue.push_back(live.entry);
+            }
+        }
+    }
+
+    std::unique_ptr<CURLM, decltype(&curl_multi_cleanup)> multi(curl_multi_init(), &curl_multi_cleanup);
+    curl_multi_setopt(multi.get(), CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    std::unordered_map<CURL*, std::unique_ptr<Impl::Transfer>> running;
+    std::size_t next = 0;
+    bool writable = true;
+
+    while ((writable && next < queue.size()) || !running.empty()) {
+        if (writable && next < queue.size() && running.size() < impl->options.replayBatch) {
+            std::vector<std::unique_ptr<Impl::Transfer>> starting;
+            {
+                std::lock_guard<std::mutex> lock(impl->mutex);
+                std::string records;
+                while (next < queue.size() && running.size() + starting.size() < impl->options.replayBatch) {
+                    const JournalEntry& entry = queue[next++];
+                    if (!impl->begin(entry.key, records)) continue;
+                    auto transfer = std::make_unique<Impl::Transfer>();
+                    impl->prepare(*transfer, entry);
+                    starting.push_back(std::move(transfer));
+                }
+                // Never send what could not be journaled as sent
+                if (!impl->write(records)) {
+                    writable = false;
+                    for (auto& transfer : starting) {
+                        impl->finish(transfer->key, JournalOutcome::Unsent, 0);
+                    }
+                    starting.clear();
+                }
+            }
+            for (auto& transfer : starting) {
+                CURL* handle = transfer->transfer.handle.get();
+                curl_multi_add_handle(multi.get(), handle);
+                running.emplace(handle, std::move(transfer));
+            }
+        }
+
+        int active = 0;
+        curl_multi_perform(multi.get(), &active);
+
+        int queued = 0;
+        bool finished = false;
+        while (CURLMsg* message = curl_multi_info_read(multi.get(), &queued)) {
+            if (message->msg != CURLMSG_DONE) continue;
+            auto it = running.find(message->easy_handle);
+            if (it == running.end()) continue;
+            long status = 0;
+            curl_easy_getinfo(message->easy_handle, CURLINFO_RESPONSE_CODE, &status);
+            curl_multi_remove_handle(multi.get(), message->easy_handle);
+
+            JournalOutcome outcome = outcomeOf(message->data.result, status);
+            std::lock_guard<std::mutex> lock(impl->mutex);
+            impl->finish(it->second->key, outcome, status);
+            switch (outcome) {
+                case JournalOutcome::Acknowledged: ++summary.acknowledged; break;
+                case JournalOutcome::Rejected: ++summary.rejected; break;
+                default: break;
+            }
+            running.erase(it);
+            finished = true;
+        }
+        if (finished && impl->options.syncEveryAppend) {
+            std::lock_guard<std::mutex> lock(impl->mutex);
+            impl->file.sync();
+        }
+        if (!running.empty()) {
+            curl_multi_poll(multi.get(), nullptr, 0, 100, nullptr);
+        }
+    }
+
+    summary.pending = size();
+    return summary;
+}
+
+std::vector<JournalEntry> MutationJournal::pending() const {
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    std::vector<JournalEntry> out;
+    out.reserve(impl->entries.size());
+    for (const Impl::Live& live : impl->entries) {
+        out.push_back(live.entry);
+    }
+    return out;
+}
+
+bool MutationJournal::resolve(const std::string& key) {
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    if (!impl->byKey.count(key)) return false;
+    impl->finish(key, JournalOutcome::Acknowledged, 0);
+    if (impl->options.syncEveryAppend) impl->file.sync();
+    return true;
+}
+
+void MutationJournal::compact() {
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    impl->compact();
+}
+
+std::size_t MutationJournal::size() const {
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    return impl->entries.size();
+}
+
+// LobbyWatcher
+struct LobbyWatcher::Watched {
+    std::string url;
+    // Validator of the last 200, sent back as If-None-Match
+    std::string etag;
+    // Players seen in the last answer, sorted by user_id
+    std::vector<LobbyUser> users;
+    std::chrono::milliseconds interval{0};
+    // Slot in `schedule`; schedule.end() while a poll is on the wire
+    std::multimap<std::chrono::steady_clock::time_point, std::string>::iterator due;
+    // Tells a poll for this watch apart from one for an earlier watch of the same lobby
+    std::uint64_t generation = 0;
+};
+
+struct LobbyWatcher::Poll {
+    std::unique_ptr<CURL, decltype(&curl_easy_cleanup)> handle{curl_easy_init(), &curl_easy_cleanup};
+    std::unique_ptr<curl_slist, decltype(&curl_slist_free_all)> headers{nullptr, &curl_slist_free_all};
+    std::string lobbyId;
+    std::uint64_t generation = 0;
+    std::string response;
+    std::string etag;
+};
+
+struct LobbyWatcher::Transport {
+    std::unique_ptr<CURLM, decltype(&curl_multi_cleanup)> multi{curl_multi_init(), &curl_multi_cleanup};
+};
+
+namespace {
+
+size_t collectEtag(char* data, size_t size, size_t count, void* userdata) {
+    std::string_view line(data, size * count);
+    auto colon = line.find(':');
+    if (colon != std::string_view::npos && equalsIgnoreCase(line.substr(0, colon), "etag")) {
+        std::string_view value = line.substr(colon + 1);
+        while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+        while (!value.empty() && (value.back() == '\r' || value.back() == '\n' || value.back() == ' ')) value.remove_suffix(1);
+        static_cast<std::string*>(userdata)->assign(value);
+    }
+    return size * count;
+}
+
+} // namespace
+
+void detail::diffUsers(const std::string& lobbyId, const std::vector<LobbyUser>& previous,
+               const std::vector<LobbyUser>& next, std::vector<LobbyEvent>& events) {
+    auto before = previous.begin();
+    auto after = next.begin();
+    while (before != previous.end() || after != next.end()) {
+        if (after == next.end() || (before != previous.end() && before->user_id < after->user_id)) {
+            events.push_back(LobbyEvent{LobbyEventKind::Left, lobbyId, *before++});
+        } else if (before == previous.end() || after->user_id < before->user_id) {
+            events.push_back(LobbyEvent{LobbyEventKind::Joined, lobbyId, *after++});
+        } else {
+            ++before;
+            ++after;
+        }
+    }
+}
+
+LobbyWatcher::LobbyWatcher(const Client& client, Listener onEvent, LobbyWatchOptions options)
+    : baseUrl(client.base_url), onEvent(std::move(onEvent)), options(options), transport(std::make_unique<Transport>()) {
+    this->options.minInterval = std::max(options.minInterval, std::chrono::milliseconds(1));
+    this->options.maxInterval = std::max(options.maxInterval, this->options.minInterval);
+    this->options.backoff = std::max(options.backoff, 1.0);
+    this->options.maxInFlight = std::max<std::size_t>(1, options.maxInFlight);
+    curl_multi_setopt(transport->multi.get(), CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(transport->multi.get(), CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(this->options.maxInFlight));
+    worker = std::thread([this] { run(); });
+}
+
+LobbyWatcher::~LobbyWatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp();
+    worker.join();
+}
+
+void LobbyWatcher::watch(const std::string& lobbyId) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (lobbies.count(lobbyId)) return;
+        auto watched = std::make_unique<Watched>();
+        watched->url = baseUrl + detail::routes::lobby.expand(lobbyId);
+        watched->interval = options.minInterval;
+        watched->generation = ++nextGeneration;
+        watched->due = schedule.emplace(std::chrono::steady_clock::now(), lobbyId);
+        lobbies.emplace(lobbyId, std::move(watched));
+    }
+    wakeUp();
+}
+
+void LobbyWatcher::unwatch(const std::string& lobbyId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = lobbies.find(lobbyId);
+    if (it == lobbies.end()) return;
+    if (it->second->due != schedule.end()) schedule.erase(it->second->due);
+    lobbies.erase(it);
+}
+
+bool LobbyWatcher::nudge(const std::string& lobbyId) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = lobbies.find(lobbyId);
+        if (it == lobbies.end()) return false;
+        Watched& watched = *it->second;
+        watched.interval = options.minInterval;
+        // A poll on the wire is rescheduled from the new interval when it lands
+        if (watched.due == schedule.end()) return true;
+        schedule.erase(watched.due);
+        watched.due = schedule.emplace(std::chrono::steady_clock::now(), lobbyId);
+    }
+    wakeUp();
+    return true;
+}
+
+std::size_t LobbyWatcher::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lobbies.size();
+}
+
+LobbyWatchStats LobbyWatcher::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+
+void LobbyWatcher::wakeUp() {
+    curl_multi_wakeup(transport->multi.get());
+}
+
+void LobbyWatcher::run() {
+    using Clock = std::chrono::steady_clock;
+    CURLM* multi = transport->multi.get();
+    std::unordered_map<CURL*, std::unique_ptr<Poll>> running;
+    std::vector<LobbyEvent> events;
+
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping) break;
+            auto now = Clock::now();
+            while (running.size() < options.maxInFlight && !schedule.empty() && schedule.begin()->first <= now) {
+                auto it = lobbies.find(schedule.begin()->second);
+                schedule.erase(schedule.begin());
+                if (it == lobbies.end()) continue;
+                Watched& watched = *it->second;
+                watched.due = schedule.end();
+
+                auto poll = std::make_unique<Poll>();
+                poll->lobbyId = it->first;
+                poll->generation = watched.generation;
+                if (!watched.etag.empty()) {
+                    poll->headers.reset(curl_slist_append(nullptr, ("If-None-Match: " + watched.etag).c_str()));
+                }
+                CURL* handle = poll->handle.get();
+                curl_easy_setopt(handle, CURLOPT_URL, watched.url.c_str());
+                curl_easy_setopt(handle, CURLOPT_HTTPGET, 1L);
+                curl_easy_setopt(handle, CURLOPT_HTTPHEADER, poll->headers.get());
+                curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "");
+                curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, collectResponse);
+                curl_easy_setopt(handle, CURLOPT_WRITEDATA, &poll->response);
+                curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, collectEtag);
+                curl_easy_setopt(handle, CURLOPT_HEADERDATA, &poll->etag);
+                curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, static_cast<long>(options.requestTimeout.count()));
+                curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+                curl_easy_setopt(handle, CURLOPT_TCP_NODELAY, 1L);
+                curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+                curl_multi_add_handle(multi, handle);
+                running.emplace(handle, std::move(poll));
+                ++counters.requests;
+            }
+        }
+
+        int active = 0;
+        curl_multi_perform(multi, &active);
+
+        int queued = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi, &queued)) {
+            if (message->msg != CURLMSG_DONE) continue;
+            auto found = running.find(message->easy_handle);
+            if (found == running.end()) continue;
+            std::unique_ptr<Poll> poll = std::move(found->second);
+            running.erase(found);
+            curl_multi_remove_handle(multi, message->easy_handle);
+
+            long status = 0;
+            std::optional<Lobby> lobby;
+            if (message->data.result == CURLE_OK) {
+                curl_easy_getinfo(poll->handle.get(), CURLINFO_RESPONSE_CODE, &status);
+            }
+            if (status == 200) {
+                // Parsed before taking the lock
+                char* contentType = nullptr;
+                curl_easy_getinfo(poll->handle.get(), CURLINFO_CONTENT_TYPE, &contentType);
+                json data;
+                try {
+                    if (decodeBody(poll->response, contentType ? contentType : "", data)) {
+                        lobby = Lobby(data);
+                        std::sort(lobby->users.begin(), lobby->users.end(),
+                                  [](const LobbyUser& a, const LobbyUser& b) { return a.user_id < b.user_id; });
+                    }
+                } catch (const std::exception&) {
+                    lobby.reset();
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = lobbies.find(poll->lobbyId);
+            // Unwatched (or unwatched and watched again) while on the wire
+            if (it == lobbies.end() || it->second->generation != poll->generation) continue;
+            Watched& watched = *it->second;
+            bool changed = false;
+
+            if (status == 304) {
+                ++counters.notModified;
+            } else if (lobby) {
+                std::size_t before = events.size();
+                detail::diffUsers(poll->lobbyId, watched.users, lobby->users, events);
+                changed = events.size() != before;
+                if (changed) ++counters.changed;
+                watched.users = std::move(lobby->users);
+                watched.etag = std::move(poll->etag);
+            } else if (status == 404) {
+                for (LobbyUser& user : watched.users) {
+                    events.push_back(LobbyEvent{LobbyEventKind::Left, poll->lobbyId, std::move(user)});
+                }
+                events.push_back(LobbyEvent{LobbyEventKind::Closed, poll->lobbyId, LobbyUser()});
+                lobbies.erase(it);
+                continue;
+            } else {
+                ++counters.failed;
+            }
+
+            if (changed) {
+                watched.interval = options.minInterval;
+            } else {
+                auto next = std::chrono::duration_cast<std::chrono::milliseconds>(watched.interval * options.backoff);
+                watched.interval = std::min(next, options.maxInterval);
+            }
+            watched.due = schedule.emplace(Clock::now() + watched.interval, poll->lobbyId);
+        }
+
+        if (!events.empty()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                counters.events += events.size();
+            }
+            for (const LobbyEvent& event : events) {
+                onEvent(event);
+            }
+            events.clear();
+        }
+
+        std::chrono::milliseconds wait = options.maxInterval;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            // With every slot busy, finishing transfers wake the poll instead
+            if (running.size() < options.maxInFlight && !schedule.empty()) {
+                auto untilDue = std::chrono::duration_cast<std::chrono::milliseconds>(schedule.begin()->first - Clock::now());
+                wait = std::clamp(untilDue + std::chrono::milliseconds(1), std::chrono::milliseconds(0), options.maxInterval);
+            }
+        }
+        curl_multi_poll(multi, nullptr, 0, static_cast<int>(wait.count()), nullptr);
+    }
+
+    for (auto& [handle, poll] : running) {
+        curl_multi_remove_handle(multi, handle);
+    }
+}
+
+// TradeWatcher
+std::map<std::string, TradeItemDetail> detail::itemsById(std::vector<TradeItemDetail>& items) {
+    std::map<std::string, TradeItemDetail> byId;
+    for (TradeItemDetail& item : items) {
+        auto [it, inserted] = byId.emplace(item.itemId, item);
+        if (!inserted) {
+            int amount = it->second.amount + item.amount;
+            it->second = std::move(item);
+            it->second.amount = amount;
+        }
+    }
+    return byId;
+}
+
+void detail::diffItems(bool fromUser, const std::map<std::string, TradeItemDetail>& previous,
+                       const std::map<std::string, TradeItemDetail>& next, std::vector<TradeItemChange>& changes) {
+    auto before = previous.begin();
+    auto after = next.begin();
+    while (before != previous.end() || after != next.end()) {
+        if (after == next.end() || (before != previous.end() && before->first < after->first)) {
+            changes.push_back(TradeItemChange{fromUser, before->first, before->second.amount, 0, before->second});
+            ++before;
+        } else if (before == previous.end() || after->first < before->first) {
+            changes.push_back(TradeItemChange{fromUser, after->first, 0, after->second.amount, after->second});
+            ++after;
+        } else {
+            if (before->second.amount != after->second.amount) {
+                changes.push_back(TradeItemChange{fromUser, after->first, before->second.amount, after->second.amount, after->second});
+            }
+            ++before;
+            ++after;
+        }
+    }
 }
 
-APIResponse Client::Lobbies::leave(const std::string& lobbyId) const {
+TradeWatcher::TradeWatcher(const Client& client, std::string userId, Listener onChange, TradeWatchOptions options)
+    : client(client), onChange(std::move(onChange)), options(options) {
     if (client.token.empty()) {
         throw std::runtime_error("Token is required");
     }
-    
-    return client.makeRequest("POST", "/lobbies/" + lobbyId + "/leave", json::object(), true);
+    url = client.base_url + detail::routes::userTrades.expand(userId);
+    this->options.minInterval = std::max(options.minInterval, std::chrono::milliseconds(1));
+    this->options.maxInterval = std::max(options.maxInterval, this->options.minInterval);
+    this->options.backoff = std::max(options.backoff, 1.0);
+    worker = std::thread([this] { run(); });
 }
 
-// STUDIOS namespace methods
-APIResponse Client::Studios::create(const std::string& studioName) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+TradeWatcher::~TradeWatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
     }
-    
-    json body = {{"studioName", studioName}};
-    return client.makeRequest("POST", "/studios", body, true);
+    wake.notify_one();
+    worker.join();
 }
 
-std::optional<Studio> Client::Studios::get(const std::string& studioId) const {
-    auto response = client.makeRequest("GET", "/studios/" + studioId);
-    if (response.success) {
-        return Studio(response.data);
+void TradeWatcher::nudge() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        nudged = true;
     }
-    return std::nullopt;
+    wake.notify_one();
 }
 
-std::vector<Studio> Client::Studios::getMyStudios() const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
-    }
-    
-    auto response = client.makeRequest("GET", "/studios/user/@me", json::object(), true);
-    
-    std::vector<Studio> studios;
-    if (response.success && response.data.is_array()) {
-        for (const auto& studioJson : response.data) {
-            studios.emplace_back(studioJson);
+TradeWatchStats TradeWatcher::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+
+bool TradeWatcher::apply(std::vector<Trade>& latest, std::vector<TradeChange>& changes) {
+    std::size_t before = changes.size();
+    std::unordered_set<std::string> present;
+    std::uint64_t diffed = 0;
+
+    for (Trade& trade : latest) {
+        present.insert(trade.id);
+        auto it = trades.find(trade.id);
+        // Every update to a trade moves updatedAt, so an unchanged one needs no diff
+        if (it != trades.end() && it->second.updatedAt == trade.updatedAt) continue;
+        ++diffed;
+
+        Snapshot next;
+        next.updatedAt = std::move(trade.updatedAt);
+        next.approvedFromUser = trade.approvedFromUser;
+        next.approvedToUser = trade.approvedToUser;
+        next.status = std::move(trade.status);
+        next.fromUserItems = detail::itemsById(trade.fromUserItems);
+        next.toUserItems = detail::itemsById(trade.toUserItems);
+
+        TradeChange change;
+        change.tradeId = trade.id;
+        if (it == trades.end()) {
+            if (next.status == "pending") {
+                change.opened = true;
+                detail::diffItems(true, {}, next.fromUserItems, change.items);
+                detail::diffItems(false, {}, next.toUserItems, change.items);
+                change.approvedFromUser = next.approvedFromUser;
+                change.approvedToUser = next.approvedToUser;
+                change.status = next.status;
+            }
+            trades.emplace(trade.id, std::move(next));
+        } else {
+            Snapshot& previous = it->second;
+            detail::diffItems(true, previous.fromUserItems, next.fromUserItems, change.items);
+            detail::diffItems(false, previous.toUserItems, next.toUserItems, change.items);
+            if (previous.approvedFromUser != next.approvedFromUser) change.approvedFromUser = next.approvedFromUser;
+            if (previous.approvedToUser != next.approvedToUser) change.approvedToUser = next.approvedToUser;
+            if (previous.status != next.status) change.status = next.status;
+            previous = std::move(next);
+        }
+
+        if (change.opened || !change.items.empty() || change.approvedFromUser || change.approvedToUser || change.status) {
+            changes.push_back(std::move(change));
         }
     }
-    return studios;
-}
 
-APIResponse Client::Studios::addUser(const std::string& studioId, const std::string& userId) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+    // Trades no longer listed are forgotten
+    for (auto it = trades.begin(); it != trades.end();) {
+        it = present.count(it->first) ? std::next(it) : trades.erase(it);
     }
-    
-    json body = {{"userId", userId}};
-    return client.makeRequest("POST", "/studios/" + studioId + "/add-user", body, true);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    counters.diffed += diffed;
+    counters.changes += changes.size() - before;
+    return changes.size() != before;
 }
 
-APIResponse Client::Studios::removeUser(const std::string& studioId, const std::string& userId) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+void TradeWatcher::run() {
+    cpr::Session session;
+    session.SetUrl(cpr::Url{url});
+    std::chrono::milliseconds interval = options.minInterval;
+    std::vector<TradeChange> changes;
+
+    for (;;) {
+        cpr::Header headers = client.preparedHeaders();
+        if (!etag.empty()) {
+            headers["If-None-Match"] = etag;
+        }
+        session.SetHeader(headers);
+        cpr::Response response = session.Get();
+
+        bool changed = false;
+        bool failed = false;
+        if (!response.error && response.status_code == 304) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++counters.notModified;
+        } else if (!response.error && response.status_code == 200) {
+            json data;
+            auto contentType = response.header.find("Content-Type");
+            try {
+                failed = !decodeBody(response.text, contentType != response.header.end() ? contentType->second : "", data) ||
+                         !data.is_array();
+                if (!failed) {
+                    std::vector<Trade> latest = listOf<Trade>(std::move(data));
+                    changed = apply(latest, changes);
+                    auto tag = response.header.find("ETag");
+                    etag = tag != response.header.end() ? tag->second : "";
+                }
+            } catch (const std::exception&) {
+                failed = true;
+            }
+        } else {
+            failed = true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++counters.requests;
+            if (failed) ++counters.failed;
+        }
+        for (const TradeChange& change : changes) {
+            onChange(change);
+        }
+        changes.clear();
+
+        if (changed) {
+            interval = options.minInterval;
+        } else {
+            auto next = std::chrono::duration_cast<std::chrono::milliseconds>(interval * options.backoff);
+            interval = std::min(next, options.maxInterval);
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait_for(lock, interval, [this] { return stopping || nudged; });
+        if (stopping) return;
+        if (nudged) {
+            nudged = false;
+            interval = options.minInterval;
+        }
     }
-    
-    json body = {{"userId", userId}};
-    return client.makeRequest("POST", "/studios/" + studioId + "/remove-user", body, true);
 }
 
-// TRADES namespace methods
-std::optional<Trade> Client::Trades::startOrGetPending(const std::string& userId) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
-    }
-    
-    auto response = client.makeRequest("POST", "/trades/start-or-latest/" + userId, json::object(), true);
-    if (response.success) {
-        return Trade(response.data);
-    }
-    return std::nullopt;
+// PushClient
+PushClient::PushClient(const Client& client, PushOptions options)
+    : client(client), options(std::move(options)) {
+    url = this->options.url.empty() ? client.base_url + this->options.path : this->options.url;
+    this->options.reconnectDelay = std::max(this->options.reconnectDelay, std::chrono::milliseconds(1));
+    this->options.maxReconnectDelay = std::max(this->options.maxReconnectDelay, this->options.reconnectDelay);
 }
 
-std::optional<Trade> Client::Trades::get(const std::string& tradeId) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+PushClient::~PushClient() {
+    stop();
+}
+
+void PushClient::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (reader.joinable()) {
+        if (current != PushState::Closed) return;
+        // The server closed the stream for good; its thread is done
+        reader.join();
     }
-    
-    auto response = client.makeRequest("GET", "/trades/" + tradeId, json::object(), true);
-    if (response.success) {
-        return Trade(response.data);
+    stopping = false;
+    current = PushState::Connecting;
+    if (!options.executor && !dispatcher.joinable()) {
+        tasksStopping = false;
+        dispatcher = std::thread([this] { runTasks(); });
     }
-    return std::nullopt;
+    reader = std::thread([this] { run(); });
 }
 
-std::vector<Trade> Client::Trades::getUserTrades(const std::string& userId) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+void PushClient::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
     }
-    
-    auto response = client.makeRequest("GET", "/trades/user/" + userId, json::object(), true);
-    
-    std::vector<Trade> trades;
-    if (response.success && response.data.is_array()) {
-        for (const auto& tradeJson : response.data) {
-            trades.emplace_back(tradeJson);
+    wake.notify_all();
+    if (reader.joinable()) reader.join();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current = PushState::Closed;
+    }
+    if (dispatcher.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(taskMutex);
+            tasksStopping = true;
         }
+        taskReady.notify_one();
+        dispatcher.join();
     }
-    return trades;
 }
 
-APIResponse Client::Trades::addItem(const std::string& tradeId, const TradeItem& tradeItem) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
-    }
-    
-    json body = {{"tradeItem", tradeItem.to_json()}};
-    return client.makeRequest("POST", "/trades/" + tradeId + "/add-item", body, true);
+PushClient::SubscriptionId PushClient::subscribe(const std::string& type, Handler handler) {
+    std::lock_guard<std::mutex> lock(mutex);
+    SubscriptionId id = nextSubscription++;
+    subscriptions.emplace(id, Subscription{type, std::make_shared<const Handler>(std::move(handler))});
+    return id;
 }
 
-APIResponse Client::Trades::removeItem(const std::string& tradeId, const TradeItem& tradeItem) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
-    }
-    
-    json body = {{"tradeItem", tradeItem.to_json()}};
-    return client.makeRequest("POST", "/trades/" + tradeId + "/remove-item", body, true);
+bool PushClient::unsubscribe(SubscriptionId id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return subscriptions.erase(id) > 0;
 }
 
-APIResponse Client::Trades::approve(const std::string& tradeId) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+PushState PushClient::state() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return current;
+}
+
+std::string PushClient::lastEventId() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastId;
+}
+
+PushStats PushClient::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+
+void PushClient::dispatch(PushEvent&& event) {
+    std::vector<std::shared_ptr<const Handler>> handlers;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++counters.events;
+        for (const auto& [id, subscription] : subscriptions) {
+            if (subscription.type.empty() || subscription.type == event.type) {
+                handlers.push_back(subscription.handler);
+            }
+        }
     }
-    
-    return client.makeRequest("PUT", "/trades/" + tradeId + "/approve", json::object(), true);
+    if (handlers.empty()) return;
+    // Holds the handlers themselves, so the task may outlive this client
+    post([handlers = std::move(handlers), event = std::move(event)] {
+        for (const auto& handler : handlers) {
+            (*handler)(event);
+        }
+    });
 }
 
-APIResponse Client::Trades::cancel(const std::string& tradeId) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+void PushClient::post(std::function<void()> task) {
+    if (options.executor) {
+        options.executor(std::move(task));
+        return;
     }
-    
-    return client.makeRequest("PUT", "/trades/" + tradeId + "/cancel", json::object(), true);
+    {
+        std::lock_guard<std::mutex> lock(taskMutex);
+        tasks.push_back(std::move(task));
+    }
+    taskReady.notify_one();
 }
 
-// OAUTH2 namespace methods
-std::optional<OAuth2App> Client::OAuth2::getApp(const std::string& client_id) const {
-    auto response = client.makeRequest("GET", "/oauth2/app/" + client_id);
-    if (response.success) {
-        return OAuth2App(response.data);
+void PushClient::runTasks() {
+    std::unique_lock<std::mutex> lock(taskMutex);
+    for (;;) {
+        taskReady.wait(lock, [this] { return tasksStopping || !tasks.empty(); });
+        // Queued calls still run on shutdown
+        if (tasks.empty()) return;
+        std::function<void()> task = std::move(tasks.front());
+        tasks.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
     }
-    return std::nullopt;
 }
 
-std::optional<std::pair<std::string, std::string>> Client::OAuth2::createApp(
-    const std::string& name, const std::vector<std::string>& redirect_urls) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+void PushClient::run() {
+    using Clock = std::chrono::steady_clock;
+    cpr::Session session;
+    session.SetUrl(cpr::Url{url});
+    std::chrono::milliseconds backoff{0};
+    bool reconnecting = false;
+
+    for (;;) {
+        std::string resumeFrom;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping) return;
+            current = reconnecting ? PushState::Reconnecting : PushState::Connecting;
+            resumeFrom = lastId;
+        }
+
+        cpr::Header headers = client.preparedHeaders();
+        headers["Accept"] = "text/event-stream";
+        headers["Cache-Control"] = "no-cache";
+        if (!resumeFrom.empty()) {
+            headers["Last-Event-ID"] = resumeFrom;
+        }
+        session.SetHeader(headers);
+
+        detail::SseParser parser(resumeFrom);
+        long status = 0;
+        bool eventStream = false;
+        bool opened = false;
+        auto lastActivity = Clock::now();
+
+        session.SetHeaderCallback(cpr::HeaderCallback{[&](std::string_view line, intptr_t) {
+            while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) line.remove_suffix(1);
+            if (line.substr(0, 5) == "HTTP/") {
+                status = 0;
+                eventStream = false;
+                auto space = line.find(' ');
+                if (space != std::string_view::npos) {
+                    std::from_chars(line.data() + space + 1, line.data() + line.size(), status);
+                }
+            } else if (line.empty()) {
+                // End of the headers of the final response
+                if (status == 200 && eventStream && !opened) {
+                    opened = true;
+                    std::lock_guard<std::mutex> lock(mutex);
+                    current = PushState::Open;
+                    ++counters.connects;
+                    if (reconnecting) ++counters.reconnects;
+                }
+            } else {
+                auto colon = line.find(':');
+                if (colon != std::string_view::npos && equalsIgnoreCase(line.substr(0, colon), "content-type")) {
+                    std::string_view value = line.substr(colon + 1);
+                    while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+                    eventStream = equalsIgnoreCase(value.substr(0, 17), "text/event-stream");
+                }
+            }
+            return true;
+        }});
+        session.SetWriteCallback(cpr::WriteCallback{[&](std::string_view data, intptr_t) {
+            if (!opened) return false;
+            lastActivity = Clock::now();
+            parser.feed(data, [this](PushEvent&& event) { dispatch(std::move(event)); });
+            std::lock_guard<std::mutex> lock(mutex);
+            lastId = parser.lastId;
+            if (parser.retry) retry = *parser.retry;
+            counters.comments += parser.comments;
+            parser.comments = 0;
+            return !stopping;
+        }});
+        // curl calls this about once a second even on an idle connection
+        session.SetProgressCallback(cpr::ProgressCallback{[&](auto, auto, auto, auto, intptr_t) {
+            std::lock_guard<std::mutex> lock(mutex);
+            return !stopping && Clock::now() - lastActivity < options.idleTimeout;
+        }});
+        cpr::Response response = session.Get();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        if (stopping) return;
+        // 204 is the server asking the client not to reconnect
+        if (status == 204 || (status >= 400 && status < 500 && status != 408 && status != 429)) {
+            current = PushState::Closed;
+            return;
+        }
+        std::chrono::milliseconds delay = retry.count() > 0 ? retry : options.reconnectDelay;
+        if (opened) {
+            backoff = delay;
+        } else {
+            // Doubles while connecting keeps failing
+            backoff = backoff.count() == 0 ? delay : std::min(backoff * 2, options.maxReconnectDelay);
+        }
+        reconnecting = true;
+        current = PushState::Reconnecting;
+        wake.wait_for(lock, backoff, [this] { return stopping; });
     }
-    
-    json body = {
-        {"name", name},
-        {"redirect_urls", redirect_urls}
-    };
-    
-    auto response = client.makeRequest("POST", "/oauth2/app", body, true);
-    if (response.success) {
-        std::string client_id = response.data.value("client_id", "");
-        std::string client_secret = response.data.value("client_secret", "");
-        return std::make_pair(client_id, client_secret);
+}
+
+// SearchSession
+struct SearchSession::Entry {
+    std::shared_ptr<const SearchResults> results;
+    std::chrono::steady_clock::time_point stored;
+    std::list<std::string>::iterator position;
+};
+
+struct SearchSession::Request {
+    std::unique_ptr<CURL, decltype(&curl_easy_cleanup)> handle{curl_easy_init(), &curl_easy_cleanup};
+    std::string query;
+    std::string key;
+    std::uint64_t generation = 0;
+    std::string url;
+    std::string response;
+};
+
+struct SearchSession::Transport {
+    std::unique_ptr<CURLM, decltype(&curl_multi_cleanup)> multi{curl_multi_init(), &curl_multi_cleanup};
+};
+
+namespace {
+
+// Strips the blanks the server trims off a query
+std::string_view trimBlanks(std::string_view text) {
+    auto blank = [](char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v'; };
+    while (!text.empty() && blank(text.front())) text.remove_prefix(1);
+    while (!text.empty() && blank(text.back())) text.remove_suffix(1);
+    return text;
+}
+
+char lowerAscii(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Case-insensitive for ASCII; `needle` is already lowercase
+bool containsFolded(std::string_view haystack, std::string_view needle) {
+    auto found = std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end(),
+                             [](char a, char b) { return lowerAscii(a) == b; });
+    return found != haystack.end() || needle.empty();
+}
+
+} // namespace
+
+bool detail::narrowable(std::string_view key) {
+    return std::all_of(key.begin(), key.end(), [](char c) {
+        return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == ' ';
+    });
+}
+
+std::optional<std::string> detail::asciiSlug(std::string_view text) {
+    std::string slug;
+    for (char c : text) {
+        if (static_cast<unsigned char>(c) >= 0x80) return std::nullopt;
+        c = lowerAscii(c);
+        if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) slug.push_back(c);
     }
-    return std::nullopt;
+    return slug;
 }
 
-std::vector<OAuth2App> Client::OAuth2::getMyApps() const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+std::optional<SearchResults> detail::narrowResults(const SearchResults& prefix, std::string_view key) {
+    SearchResults narrowed;
+    std::string keySlug = *asciiSlug(key);
+    for (const User& user : prefix.users) {
+        auto slug = asciiSlug(user.username);
+        if (!slug) return std::nullopt;
+        if (slug->find(keySlug) != std::string::npos) narrowed.users.push_back(user);
     }
-    
-    auto response = client.makeRequest("GET", "/oauth2/apps", json::object(), true);
-    
-    std::vector<OAuth2App> apps;
-    if (response.success && response.data.is_array()) {
-        for (const auto& appJson : response.data) {
-            apps.emplace_back(appJson);
+    for (const Game& game : prefix.games) {
+        if (containsFolded(game.name, key) || containsFolded(game.description, key) ||
+            (game.genre && containsFolded(*game.genre, key))) {
+            narrowed.games.push_back(game);
         }
     }
-    return apps;
+    for (const Item& item : prefix.items) {
+        if (containsFolded(item.name, key)) narrowed.items.push_back(item);
+    }
+    return narrowed;
 }
 
-APIResponse Client::OAuth2::updateApp(const std::string& client_id,
-                                     const std::optional<std::string>& name,
-                                     const std::optional<std::vector<std::string>>& redirect_urls) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+namespace {
+
+const detail::Route<1>& searchRoute(SearchScope scope) {
+    switch (scope) {
+        case SearchScope::Games: return detail::routes::gameSearch;
+        case SearchScope::Items: return detail::routes::itemSearch;
+        default: return detail::routes::search;
     }
-    
-    json body = json::object();
-    if (name) {
-        body["name"] = *name;
+}
+
+bool parseSearchAnswer(std::string_view text, SearchScope scope, SearchResults& results) {
+    switch (scope) {
+        case SearchScope::Games: return parseSection(text, 0, results.games);
+        case SearchScope::Items: return parseSection(text, 0, results.items);
+        default: return searchResultsOf(text, SearchOptions(), results);
     }
-    if (redirect_urls) {
-        body["redirect_urls"] = *redirect_urls;
+}
+
+} // namespace
+
+SearchSession::SearchSession(const Client& client, Listener onUpdate, SearchSessionOptions options)
+    : baseUrl(client.base_url), onUpdate(std::move(onUpdate)), options(options), transport(std::make_unique<Transport>()) {
+    worker = std::thread([this] { run(); });
+}
+
+SearchSession::~SearchSession() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
     }
-    
-    return client.makeRequest("PATCH", "/oauth2/app/" + client_id, body, true);
+    wakeUp();
+    worker.join();
 }
 
-APIResponse Client::OAuth2::deleteApp(const std::string& client_id) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+void SearchSession::update(const std::string& text) {
+    std::string_view trimmed = trimBlanks(text);
+    std::string nextKey(trimmed.size(), '\0');
+    std::transform(trimmed.begin(), trimmed.end(), nextKey.begin(), lowerAscii);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++counters.updates;
+        // Same search (e.g. a modifier key): keep the answer or the request on the wire
+        if (active && nextKey == key) return;
+        query.assign(trimmed);
+        key = std::move(nextKey);
+        ++generation;
+        active = true;
+        answered = false;
+        quietAt = std::chrono::steady_clock::now() + options.debounce;
     }
-    
-    return client.makeRequest("DELETE", "/oauth2/app/" + client_id, json::object(), true);
+    wakeUp();
 }
 
-std::string Client::OAuth2::authorize(const std::string& client_id, const std::string& redirect_uri) const {
-    if (client.token.empty()) {
-        throw std::runtime_error("Token is required");
+void SearchSession::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++generation;
+        active = false;
+        answered = true;
     }
-    
-    std::string endpoint = "/oauth2/authorize?client_id=" + client.urlEncode(client_id) + 
-                          "&redirect_uri=" + client.urlEncode(redirect_uri);
-    
-    auto response = client.makeRequest("GET", endpoint, json::object(), true);
-    if (response.success) {
-        return response.data.value("code", "");
+    wakeUp();
+}
+
+SearchStats SearchSession::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+
+void SearchSession::wakeUp() {
+    curl_multi_wakeup(transport->multi.get());
+}
+
+void SearchSession::remember(const std::string& entryKey, std::shared_ptr<const SearchResults> results,
+                             std::chrono::steady_clock::time_point stored) {
+    if (options.maxCached == 0) return;
+    auto found = cache.find(entryKey);
+    if (found != cache.end()) {
+        recency.splice(recency.begin(), recency, found->second.position);
+        found->second.results = std::move(results);
+        found->second.stored = stored;
+        return;
     }
-    return "";
+    if (cache.size() >= options.maxCached) {
+        cache.erase(recency.back());
+        recency.pop_back();
+    }
+    recency.push_front(entryKey);
+    cache.emplace(entryKey, Entry{std::move(results), stored, recency.begin()});
 }
 
-std::optional<User> Client::OAuth2::getUserByCode(const std::string& code, const std::string& client_id) const {
-    std::string endpoint = "/oauth2/user?code=" + client.urlEncode(code) + 
-                          "&client_id=" + client.urlEncode(client_id);
-    
-    auto response = client.makeRequest("GET", endpoint);
-    if (response.success) {
-        return User(response.data);
+std::shared_ptr<const SearchResults> SearchSession::answerLocally(SearchSource& source) {
+    auto now = std::chrono::steady_clock::now();
+    auto found = cache.find(key);
+    if (found != cache.end() && now - found->second.stored < options.maxAge) {
+        recency.splice(recency.begin(), recency, found->second.position);
+        source = SearchSource::Cache;
+        ++counters.cacheHits;
+        return found->second.results;
     }
-    return std::nullopt;
+    if (!detail::narrowable(key)) return nullptr;
+
+    // The longest remembered prefix has the fewest results to filter
+    for (std::size_t length = key.size() - 1; length > 0; --length) {
+        auto prefix = cache.find(key.substr(0, length));
+        if (prefix == cache.end() || now - prefix->second.stored >= options.maxAge) continue;
+        const SearchResults& results = *prefix->second.results;
+        // Shorter prefixes match at least as much, so they are cut short too
+        if (results.users.size() >= options.serverLimit || results.games.size() >= options.serverLimit ||
+            results.items.size() >= options.serverLimit) {
+            return nullptr;
+        }
+        auto narrowed = detail::narrowResults(results, key);
+        if (!narrowed) return nullptr;
+        auto shared = std::make_shared<const SearchResults>(std::move(*narrowed));
+        // As fresh as the answer it was filtered from
+        remember(key, shared, prefix->second.stored);
+        source = SearchSource::Narrowed;
+        ++counters.narrowed;
+        return shared;
+    }
+    return nullptr;
 }
 
-// Global search method
-json Client::globalSearch(const std::string& query) const {
-    std::string endpoint = "/search?q=" + urlEncode(query);
-    auto response = makeRequest("GET", endpoint);
-    
-    if (response.success) {
-        return response.data;
+void SearchSession::run() {
+    using Clock = std::chrono::steady_clock;
+    CURLM* multi = transport->multi.get();
+    // Only the latest query is ever on the wire
+    std::unique_ptr<Request> request;
+
+    // Drops answers overtaken by update() or cancel() while they were prepared
+    auto deliver = [this](const SearchUpdate& update, std::uint64_t answerGeneration) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (answerGeneration != generation) return;
+        }
+        onUpdate(update);
+    };
+
+    for (;;) {
+        std::optional<SearchUpdate> local;
+        std::uint64_t localGeneration = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping) break;
+            if (request && request->generation != generation) {
+                curl_multi_remove_handle(multi, request->handle.get());
+                request.reset();
+                ++counters.cancelled;
+            }
+            if (!answered && !request) {
+                SearchSource source = SearchSource::Network;
+                std::shared_ptr<const SearchResults> results;
+                if (key.empty()) {
+                    // Nothing to search for; the server would answer 400
+                    source = SearchSource::Cache;
+                    results = std::make_shared<const SearchResults>();
+                } else {
+                    results = answerLocally(source);
+                }
+
+                if (results) {
+                    answered = true;
+                    local = SearchUpdate{query, std::move(results), source, false};
+                    localGeneration = generation;
+                } else if (Clock::now() >= quietAt) {
+                    request = std::make_unique<Request>();
+                    request->query = query;
+                    request->key = key;
+                    request->generation = generation;
+                    request->url = baseUrl + searchRoute(options.scope).expand(query);
+                    CURL* handle = request->handle.get();
+                    curl_easy_setopt(handle, CURLOPT_URL, request->url.c_str());
+                    curl_easy_setopt(handle, CURLOPT_HTTPGET, 1L);
+                    curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "");
+                    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, collectResponse);
+                    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &request->response);
+                    curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, static_cast<long>(options.requestTimeout.count()));
+                    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+                    curl_easy_setopt(handle, CURLOPT_TCP_NODELAY, 1L);
+                    curl_multi_add_handle(multi, handle);
+                    ++counters.requests;
+                }
+            }
+        }
+        if (local) {
+            deliver(*local, localGeneration);
+        }
+
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        int queued = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi, &queued)) {
+            if (message->msg != CURLMSG_DONE || !request || message->easy_handle != request->handle.get()) continue;
+            CURLcode result = message->data.result;
+            curl_multi_remove_handle(multi, message->easy_handle);
+            std::unique_ptr<Request> done = std::move(request);
+
+            long status = 0;
+            if (result == CURLE_OK) {
+                curl_easy_getinfo(done->handle.get(), CURLINFO_RESPONSE_CODE, &status);
+            }
+            // Parsed before taking the lock
+            std::shared_ptr<const SearchResults> results;
+            SearchResults parsed;
+            if (status >= 200 && status < 300 && parseSearchAnswer(done->response, options.scope, parsed)) {
+                results = std::make_shared<const SearchResults>(std::move(parsed));
+            }
+
+            SearchUpdate update{done->query, results, SearchSource::Network, !results};
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (results) {
+                    remember(done->key, results, Clock::now());
+                } else {
+                    ++counters.failed;
+                    update.results = std::make_shared<const SearchResults>();
+                }
+                if (done->generation != generation) continue;
+                answered = true;
+            }
+            deliver(update, done->generation);
+        }
+
+        // Waits out the debounce interval; update() and cancel() wake the poll early
+        std::chrono::milliseconds wait(1000);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!answered && !request) {
+                auto untilQuiet = std::chrono::ceil<std::chrono::milliseconds>(quietAt - Clock::now());
+                wait = std::clamp(untilQuiet, std::chrono::milliseconds(0), wait);
+            }
+        }
+        curl_multi_poll(multi, nullptr, 0, static_cast<int>(wait.count()), nullptr);
+    }
+
+    if (request) {
+        curl_multi_remove_handle(multi, request->handle.get());
     }
-    return json::object();
 }
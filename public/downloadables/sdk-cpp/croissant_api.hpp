@@ -1,9 +1,34 @@
 #pragma once
 
+#include <array>
+#include <charconv>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
 #include <vector>
 #include <optional>
+#include <stdexcept>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <initializer_list>
+#include <iterator>
+#include <list>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <nlohmann/json.hpp>
 #include <cpr/cpr.h>
 
@@ -17,8 +42,139 @@ struct APIResponse {
     std::string message;
     json data;
     
-    APIResponse(bool success = false, const std::string& message = "", const json& data = json::object())
-        : success(success), message(message), data(data) {}
+    APIResponse(bool success = false, std::string message = "", json data = json::object())
+        : success(success), message(std::move(message)), data(std::move(data)) {}
+};
+
+// Failure categories reported by the exception-free try* methods
+enum class ErrorCode {
+    Transport,  // no HTTP response: connection, TLS or timeout failure
+    HttpStatus, // the server answered with a non-2xx status
+    Parse,      // the response body could not be decoded
+    Auth        // no token set, or the server answered 401/403
+};
+
+struct Error {
+    ErrorCode code;
+    long status = 0; // HTTP status, 0 when no response was received
+    std::string message;
+};
+
+// Value or Error returned by the try* methods. Move-only, so the decoded
+// payload is handed to the caller without being copied.
+template <typename T>
+class Result {
+public:
+    Result(T value) : state(std::in_place_index<0>, std::move(value)) {}
+    Result(Error error) : state(std::in_place_index<1>, std::move(error)) {}
+    Result(Result&&) = default;
+    Result& operator=(Result&&) = default;
+    Result(const Result&) = delete;
+    Result& operator=(const Result&) = delete;
+
+    bool ok() const { return state.index() == 0; }
+    explicit operator bool() const { return ok(); }
+
+    // Only valid when ok()
+    T& value() & { return std::get<0>(state); }
+    const T& value() const& { return std::get<0>(state); }
+    T&& value() && { return std::get<0>(std::move(state)); }
+    T& operator*() & { return value(); }
+    const T& operator*() const& { return value(); }
+    T* operator->() { return &value(); }
+    const T* operator->() const { return &value(); }
+
+    // Only valid when !ok()
+    const Error& error() const& { return std::get<1>(state); }
+    Error&& error() && { return std::get<1>(std::move(state)); }
+
+    T valueOr(T fallback) && { return ok() ? std::move(value()) : std::move(fallback); }
+
+    // Converts the value with `f`, passing an error through unchanged
+    template <typename F>
+    auto map(F&& f) && -> Result<std::decay_t<decltype(f(std::declval<T&&>()))>> {
+        if (!ok()) return std::move(*this).error();
+        return f(std::move(*this).value());
+    }
+
+private:
+    std::variant<T, Error> state;
+};
+
+// Serialization used on the wire. Binary formats are negotiated per request
+// and the client falls back to JSON whenever the server answers with it.
+enum class WireFormat {
+    Json,
+    MessagePack,
+    Cbor
+};
+
+// Callback invoked for each element of a streamed list response, as soon as
+// that element has been received. Return false to stop the transfer early.
+template <typename T>
+using StreamCallback = std::function<bool(T&&)>;
+
+// Metadata of a unique item instance: a flat vector of entries sorted by key.
+// Values are moved in when parsing or converting, and the entry array and its
+// keys can live in a caller-supplied arena (e.g. a monotonic buffer resource
+// shared by a whole inventory).
+class Metadata {
+public:
+    struct Entry {
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+        std::pmr::string key;
+        json value;
+
+        Entry(std::string_view key, json value, const allocator_type& alloc = {})
+            : key(key, alloc), value(std::move(value)) {}
+        Entry(const Entry& other, const allocator_type& alloc) : key(other.key, alloc), value(other.value) {}
+        Entry(Entry&& other, const allocator_type& alloc)
+            : key(std::move(other.key), alloc), value(std::move(other.value)) {}
+        Entry(const Entry&) = default;
+        Entry(Entry&&) = default;
+        Entry& operator=(const Entry&) = default;
+        Entry& operator=(Entry&&) = default;
+    };
+
+    using const_iterator = std::pmr::vector<Entry>::const_iterator;
+
+    Metadata() = default;
+    explicit Metadata(std::pmr::memory_resource* arena) : entries(arena) {}
+    Metadata(std::initializer_list<std::pair<std::string_view, json>> values);
+    Metadata(std::unordered_map<std::string, json> values,
+             std::pmr::memory_resource* arena = std::pmr::get_default_resource());
+
+    static Metadata fromJson(const json& j, std::pmr::memory_resource* arena = std::pmr::get_default_resource());
+    static Metadata fromJson(json&& j, std::pmr::memory_resource* arena = std::pmr::get_default_resource());
+    json toJson() const;
+    std::unordered_map<std::string, json> toMap() const;
+
+    std::size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+    void reserve(std::size_t count) { entries.reserve(count); }
+    void clear() { entries.clear(); }
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+    std::pmr::memory_resource* arena() const { return entries.get_allocator().resource(); }
+
+    const_iterator find(std::string_view key) const;
+    bool contains(std::string_view key) const { return find(key) != end(); }
+    const json* get(std::string_view key) const;
+    // Inserts a null value when the key is missing
+    json& operator[](std::string_view key);
+    void set(std::string_view key, json value);
+    bool erase(std::string_view key);
+
+    bool operator==(const Metadata& other) const;
+    bool operator!=(const Metadata& other) const { return !(*this == other); }
+
+private:
+    std::pmr::vector<Entry>::iterator lowerBound(std::string_view key);
+    // Restores key order (last value wins on duplicates) after a bulk fill
+    void normalize();
+
+    std::pmr::vector<Entry> entries;
 };
 
 // Struct definitions based on TypeScript interfaces
@@ -62,7 +218,7 @@ struct TradeItemDetail {
 struct TradeItem {
     std::string itemId;
     int amount;
-    std::optional<std::unordered_map<std::string, json>> metadata;
+    std::optional<Metadata> metadata;
 
     TradeItem() = default;
     TradeItem(const json& j);
@@ -141,7 +297,7 @@ struct InventoryItem {
     std::optional<std::string> user_id;
     std::optional<std::string> item_id;
     int amount;
-    std::optional<std::unordered_map<std::string, json>> metadata;
+    std::optional<Metadata> metadata;
     std::string itemId;
     std::string name;
     std::string description;
@@ -149,6 +305,9 @@ struct InventoryItem {
     double price;
     std::string owner;
     bool showInStore;
+    std::optional<bool> sellable;
+    std::optional<double> purchasePrice;
+    std::optional<std::string> rarity;
 
     InventoryItem() = default;
     InventoryItem(const json& j);
@@ -206,543 +365,4114 @@ struct OAuth2App {
     json to_json() const;
 };
 
-// Main API client class
-class Client {
-private:
-    std::string token;
-    const std::string base_url = "https://croissant-api.fr/api";
-    
-    // Internal helper methods
-    APIResponse makeRequest(const std::string& method, const std::string& endpoint, 
-                           const json& body = json::object(), bool requireAuth = false) const;
-    std::string urlEncode(const std::string& str) const;
+struct MarketListing {
+    std::string id;
+    std::string seller_id;
+    std::string item_id;
+    double price;
+    std::string status;
+    std::optional<Metadata> metadata;
+    std::string created_at;
+    std::string updated_at;
+    std::optional<std::string> sold_at;
+    std::optional<std::string> buyer_id;
+    std::optional<double> purchasePrice;
+    std::optional<std::string> rarity;
+    std::optional<std::string> custom_url_link;
+    // Set on the enriched list, search and per-user responses
+    std::optional<std::string> item_name;
+    std::optional<std::string> item_description;
+    std::optional<std::string> item_icon_hash;
 
-public:
-    // Constructor
-    explicit Client(const std::string& token = "") : token(token) {}
-    
-    // Token management
-    void setToken(const std::string& newToken) { token = newToken; }
-    std::string getToken() const { return token; }
+    MarketListing() = default;
+    MarketListing(const json& j);
+    json to_json() const;
+};
 
-    // --- USERS NAMESPACE ---
-    struct Users {
-        const Client& client;
-        explicit Users(const Client& c) : client(c) {}
+struct BuyOrder {
+    std::string id;
+    std::string buyer_id;
+    std::string item_id;
+    double price;
+    std::string status;
+    std::string created_at;
+    std::string updated_at;
+    std::optional<std::string> fulfilled_at;
 
-        /**
-         * Get the authenticated user's profile.
-         * @returns The current user object or nullopt if failed.
-         * @throws std::runtime_error if no token is set.
-         */
-        std::optional<User> getMe() const;
+    BuyOrder() = default;
+    BuyOrder(const json& j);
+    json to_json() const;
+};
 
-        /**
-         * Search users by username or other criteria.
-         * @param query The search string.
-         * @returns Vector of matching users.
-         */
-        std::vector<User> search(const std::string& query) const;
+// --- FIELD DESCRIPTORS ---
+// Each struct lists its JSON fields once in a Reflect<T> specialization. The
+// parsers and serializers are generated from that table at compile time, and
+// keys are dispatched through a perfect hash computed by the compiler.
+namespace detail {
 
-        /**
-         * Get a user by their userId.
-         * @param userId The user's ID.
-         * @returns The user object or nullopt if not found.
-         */
-        std::optional<User> getUser(const std::string& userId) const;
+// FNV-1a, usable in constant expressions
+constexpr std::uint32_t fnv1a(std::string_view key, std::uint32_t basis) {
+    std::uint32_t hash = basis;
+    for (char c : key) {
+        hash ^= static_cast<std::uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
 
-        /**
-         * Transfer credits to another user.
-         * @param targetUserId The recipient's user ID.
-         * @param amount The amount to transfer.
-         * @returns APIResponse with message about the transfer.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse transferCredits(const std::string& targetUserId, double amount) const;
+template <typename T, typename M>
+struct Field {
+    std::string_view name;
+    M T::*member;
+};
 
-        /**
-         * Verify a user with a verification key.
-         * @param userId The user ID to verify.
-         * @param verificationKey The verification key.
-         * @returns APIResponse with success status.
-         */
-        APIResponse verify(const std::string& userId, const std::string& verificationKey) const;
+template <typename T, typename M>
+constexpr Field<T, M> field(std::string_view name, M T::*member) {
+    return {name, member};
+}
 
-        /**
-         * Change username of authenticated user.
-         * @param username The new username.
-         * @returns APIResponse with result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse changeUsername(const std::string& username) const;
+} // namespace detail
 
-        /**
-         * Change password of authenticated user.
-         * @param oldPassword Current password.
-         * @param newPassword New password.
-         * @param confirmPassword Confirmation of new password.
-         * @returns APIResponse with result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse changePassword(const std::string& oldPassword, 
-                                 const std::string& newPassword, 
-                                 const std::string& confirmPassword) const;
-    } users;
+template <typename T>
+struct Reflect;
 
-    // --- GAMES NAMESPACE ---
-    struct Games {
-        const Client& client;
-        explicit Games(const Client& c) : client(c) {}
+template <> struct Reflect<LobbyUser> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("username", &LobbyUser::username),
+        detail::field("user_id", &LobbyUser::user_id),
+        detail::field("verified", &LobbyUser::verified),
+        detail::field("steam_username", &LobbyUser::steam_username),
+        detail::field("steam_avatar_url", &LobbyUser::steam_avatar_url),
+        detail::field("steam_id", &LobbyUser::steam_id));
+};
 
-        /**
-         * List all games visible in the store.
-         * @returns Vector of games.
-         */
-        std::vector<Game> list() const;
+template <> struct Reflect<StudioUser> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("user_id", &StudioUser::user_id),
+        detail::field("username", &StudioUser::username),
+        detail::field("verified", &StudioUser::verified),
+        detail::field("admin", &StudioUser::admin));
+};
 
-        /**
-         * Search for games by name, genre, or description.
-         * @param query The search string.
-         * @returns Vector of matching games.
-         */
-        std::vector<Game> search(const std::string& query) const;
+template <> struct Reflect<TradeItemDetail> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("itemId", &TradeItemDetail::itemId),
+        detail::field("name", &TradeItemDetail::name),
+        detail::field("description", &TradeItemDetail::description),
+        detail::field("iconHash", &TradeItemDetail::iconHash),
+        detail::field("amount", &TradeItemDetail::amount));
+};
 
-        /**
-         * Get all games created by the authenticated user.
-         * @returns Vector of games created by the user.
-         * @throws std::runtime_error if not authenticated.
-         */
-        std::vector<Game> getMyCreatedGames() const;
+template <> struct Reflect<TradeItem> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("itemId", &TradeItem::itemId),
+        detail::field("amount", &TradeItem::amount),
+        detail::field("metadata", &TradeItem::metadata));
+};
 
-        /**
-         * Get all games owned by the authenticated user.
-         * @returns Vector of games owned by the user.
-         * @throws std::runtime_error if not authenticated.
-         */
-        std::vector<Game> getMyOwnedGames() const;
+template <> struct Reflect<Game> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("gameId", &Game::gameId),
+        detail::field("name", &Game::name),
+        detail::field("description", &Game::description),
+        detail::field("price", &Game::price),
+        detail::field("owner_id", &Game::owner_id),
+        detail::field("showInStore", &Game::showInStore),
+        detail::field("iconHash", &Game::iconHash),
+        detail::field("splashHash", &Game::splashHash),
+        detail::field("bannerHash", &Game::bannerHash),
+        detail::field("genre", &Game::genre),
+        detail::field("release_date", &Game::release_date),
+        detail::field("developer", &Game::developer),
+        detail::field("publisher", &Game::publisher),
+        detail::field("platforms", &Game::platforms),
+        detail::field("rating", &Game::rating),
+        detail::field("website", &Game::website),
+        detail::field("trailer_link", &Game::trailer_link),
+        detail::field("multiplayer", &Game::multiplayer),
+        detail::field("download_link", &Game::download_link));
+};
 
-        /**
-         * Get a game by its ID.
-         * @param gameId The game ID.
-         * @returns The game object or nullopt if not found.
-         */
-        std::optional<Game> get(const std::string& gameId) const;
+template <> struct Reflect<User> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("userId", &User::userId),
+        detail::field("username", &User::username),
+        detail::field("email", &User::email),
+        detail::field("verified", &User::verified),
+        detail::field("studios", &User::studios),
+        detail::field("roles", &User::roles),
+        detail::field("inventory", &User::inventory),
+        detail::field("ownedItems", &User::ownedItems),
+        detail::field("createdGames", &User::createdGames),
+        detail::field("verificationKey", &User::verificationKey),
+        detail::field("steam_id", &User::steam_id),
+        detail::field("steam_username", &User::steam_username),
+        detail::field("steam_avatar_url", &User::steam_avatar_url),
+        detail::field("isStudio", &User::isStudio),
+        detail::field("admin", &User::admin),
+        detail::field("disabled", &User::disabled),
+        detail::field("google_id", &User::google_id),
+        detail::field("discord_id", &User::discord_id),
+        detail::field("balance", &User::balance),
+        detail::field("haveAuthenticator", &User::haveAuthenticator));
+};
 
-        /**
-         * Create a new game.
-         * @param game The game data to create.
-         * @returns The created game or nullopt if failed.
-         * @throws std::runtime_error if not authenticated.
-         */
-        std::optional<Game> create(const Game& game) const;
+template <> struct Reflect<Item> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("itemId", &Item::itemId),
+        detail::field("name", &Item::name),
+        detail::field("description", &Item::description),
+        detail::field("owner", &Item::owner),
+        detail::field("price", &Item::price),
+        detail::field("iconHash", &Item::iconHash),
+        detail::field("showInStore", &Item::showInStore),
+        detail::field("deleted", &Item::deleted));
+};
 
-        /**
-         * Update an existing game.
-         * @param gameId The game ID to update.
-         * @param game The updated game data.
-         * @returns The updated game or nullopt if failed.
-         * @throws std::runtime_error if not authenticated.
-         */
-        std::optional<Game> update(const std::string& gameId, const Game& game) const;
+template <> struct Reflect<InventoryItem> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("user_id", &InventoryItem::user_id),
+        detail::field("item_id", &InventoryItem::item_id),
+        detail::field("amount", &InventoryItem::amount),
+        detail::field("metadata", &InventoryItem::metadata),
+        detail::field("itemId", &InventoryItem::itemId),
+        detail::field("name", &InventoryItem::name),
+        detail::field("description", &InventoryItem::description),
+        detail::field("iconHash", &InventoryItem::iconHash),
+        detail::field("price", &InventoryItem::price),
+        detail::field("owner", &InventoryItem::owner),
+        detail::field("showInStore", &InventoryItem::showInStore),
+        detail::field("sellable", &InventoryItem::sellable),
+        detail::field("purchasePrice", &InventoryItem::purchasePrice),
+        detail::field("rarity", &InventoryItem::rarity));
+};
 
-        /**
-         * Buy a game by its ID.
-         * @param gameId The game ID to buy.
-         * @returns APIResponse with purchase result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse buy(const std::string& gameId) const;
-    } games;
+template <> struct Reflect<Lobby> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("lobbyId", &Lobby::lobbyId),
+        detail::field("users", &Lobby::users));
+};
 
-    // --- INVENTORY NAMESPACE ---
-    struct Inventory {
-        const Client& client;
-        explicit Inventory(const Client& c) : client(c) {}
+template <> struct Reflect<Studio> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("user_id", &Studio::user_id),
+        detail::field("username", &Studio::username),
+        detail::field("verified", &Studio::verified),
+        detail::field("admin_id", &Studio::admin_id),
+        detail::field("isAdmin", &Studio::isAdmin),
+        detail::field("apiKey", &Studio::apiKey),
+        detail::field("users", &Studio::users));
+};
 
-        /**
-         * Get the inventory of the authenticated user.
-         * @returns Pair of user_id and inventory items.
-         * @throws std::runtime_error if not authenticated.
-         */
-        std::pair<std::string, std::vector<InventoryItem>> getMyInventory() const;
+template <> struct Reflect<Trade> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("id", &Trade::id),
+        detail::field("fromUserId", &Trade::fromUserId),
+        detail::field("toUserId", &Trade::toUserId),
+        detail::field("fromUserItems", &Trade::fromUserItems),
+        detail::field("toUserItems", &Trade::toUserItems),
+        detail::field("approvedFromUser", &Trade::approvedFromUser),
+        detail::field("approvedToUser", &Trade::approvedToUser),
+        detail::field("status", &Trade::status),
+        detail::field("createdAt", &Trade::createdAt),
+        detail::field("updatedAt", &Trade::updatedAt));
+};
 
-        /**
-         * Get the inventory of a user by userId.
-         * @param userId The user ID.
-         * @returns Pair of user_id and inventory items.
-         */
-        std::pair<std::string, std::vector<InventoryItem>> get(const std::string& userId) const;
-    } inventory;
+template <> struct Reflect<OAuth2App> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("client_id", &OAuth2App::client_id),
+        detail::field("client_secret", &OAuth2App::client_secret),
+        detail::field("name", &OAuth2App::name),
+        detail::field("redirect_urls", &OAuth2App::redirect_urls));
+};
 
-    // --- ITEMS NAMESPACE ---
-    struct Items {
-        const Client& client;
-        explicit Items(const Client& c) : client(c) {}
+template <> struct Reflect<MarketListing> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("id", &MarketListing::id),
+        detail::field("seller_id", &MarketListing::seller_id),
+        detail::field("item_id", &MarketListing::item_id),
+        detail::field("price", &MarketListing::price),
+        detail::field("status", &MarketListing::status),
+        detail::field("metadata", &MarketListing::metadata),
+        detail::field("created_at", &MarketListing::created_at),
+        detail::field("updated_at", &MarketListing::updated_at),
+        detail::field("sold_at", &MarketListing::sold_at),
+        detail::field("buyer_id", &MarketListing::buyer_id),
+        detail::field("purchasePrice", &MarketListing::purchasePrice),
+        detail::field("rarity", &MarketListing::rarity),
+        detail::field("custom_url_link", &MarketListing::custom_url_link),
+        detail::field("item_name", &MarketListing::item_name),
+        detail::field("item_description", &MarketListing::item_description),
+        detail::field("item_icon_hash", &MarketListing::item_icon_hash));
+};
 
-        /**
-         * List all non-deleted items visible in the store.
-         * @returns Vector of items.
-         */
-        std::vector<Item> list() const;
+template <> struct Reflect<BuyOrder> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("id", &BuyOrder::id),
+        detail::field("buyer_id", &BuyOrder::buyer_id),
+        detail::field("item_id", &BuyOrder::item_id),
+        detail::field("price", &BuyOrder::price),
+        detail::field("status", &BuyOrder::status),
+        detail::field("created_at", &BuyOrder::created_at),
+        detail::field("updated_at", &BuyOrder::updated_at),
+        detail::field("fulfilled_at", &BuyOrder::fulfilled_at));
+};
 
-        /**
-         * Get all items owned by the authenticated user.
-         * @returns Vector of items owned by the user.
-         * @throws std::runtime_error if not authenticated.
-         */
-        std::vector<Item> getMyItems() const;
+namespace detail {
 
-        /**
-         * Search for items by name (only those visible in store).
-         * @param query The search string.
-         * @returns Vector of matching items.
-         */
-        std::vector<Item> search(const std::string& query) const;
+template <typename T, typename = void>
+struct IsReflected : std::false_type {};
 
-        /**
-         * Get a single item by itemId.
-         * @param itemId The item ID.
-         * @returns The item object or nullopt if not found.
-         */
-        std::optional<Item> get(const std::string& itemId) const;
+template <typename T>
+void readObject(const json& j, T& object);
+template <typename T>
+void readObject(json&& j, T& object);
+template <typename T>
+json writeObject(const T& object);
+template <typename T>
+bool readProjected(std::string_view text, T& object);
 
-        /**
-         * Create a new item.
-         * @param name Item name.
-         * @param description Item description.
-         * @param price Item price.
-         * @param iconHash Optional icon hash.
-         * @param showInStore Whether to show in store.
-         * @returns APIResponse with creation result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse create(const std::string& name, const std::string& description, 
-                          double price, const std::string& iconHash = "", 
-                          bool showInStore = true) const;
+template <typename T>
+struct IsReflected<T, std::void_t<decltype(Reflect<T>::fields)>> : std::true_type {};
 
-        /**
-         * Update an existing item.
-         * @param itemId The item ID.
-         * @param item The updated item data.
-         * @returns APIResponse with update result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse update(const std::string& itemId, const Item& item) const;
+// Per-type JSON conversion. read() returns false and leaves the field at its
+// default for values of the wrong JSON type instead of throwing; unset
+// optionals are not serialized. Codecs for types that own heap data also
+// read from a json&&, moving strings and nested values out of the document.
+template <typename V, typename = void>
+struct Codec;
 
-        /**
-         * Delete an item by its ID.
-         * @param itemId The item ID.
-         * @returns APIResponse with deletion result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse deleteItem(const std::string& itemId) const;
+template <>
+struct Codec<std::string> {
+    static bool read(const json& j, std::string& out) {
+        if (!j.is_string()) return false;
+        out = j.get_ref<const std::string&>();
+        return true;
+    }
+    static bool read(json&& j, std::string& out) {
+        if (!j.is_string()) return false;
+        out = std::move(j.get_ref<std::string&>());
+        return true;
+    }
+    static json write(const std::string& value) { return value; }
+};
 
-        /**
+template <>
+struct Codec<bool> {
+    // The API's MySQL columns come back as 0/1 as often as true/false
+    static bool read(const json& j, bool& out) {
+        if (j.is_boolean()) {
+            out = j.get<bool>();
+        } else if (j.is_number()) {
+            out = j.get<double>() != 0;
+        } else {
+            return false;
+        }
+        return true;
+    }
+    static json write(bool value) { return value; }
+};
+
+template <>
+struct Codec<int> {
+    static bool read(const json& j, int& out) {
+        if (!j.is_number()) return false;
+        out = j.get<int>();
+        return true;
+    }
+    static json write(int value) { return value; }
+};
+
+template <>
+struct Codec<double> {
+    static bool read(const json& j, double& out) {
+        if (!j.is_number()) return false;
+        out = j.get<double>();
+        return true;
+    }
+    static json write(double value) { return value; }
+};
+
+template <>
+struct Codec<json> {
+    static bool read(const json& j, json& out) {
+        out = j;
+        return true;
+    }
+    static bool read(json&& j, json& out) {
+        out = std::move(j);
+        return true;
+    }
+    static json write(const json& value) { return value; }
+};
+
+template <typename V>
+struct Codec<std::optional<V>> {
+    static bool read(const json& j, std::optional<V>& out) {
+        if (j.is_null()) {
+            out.reset();
+            return true;
+        }
+        V value{};
+        if (!Codec<V>::read(j, value)) return false;
+        out = std::move(value);
+        return true;
+    }
+    static bool read(json&& j, std::optional<V>& out) {
+        if (j.is_null()) {
+            out.reset();
+            return true;
+        }
+        V value{};
+        if (!Codec<V>::read(std::move(j), value)) return false;
+        out = std::move(value);
+        return true;
+    }
+    static json write(const std::optional<V>& value) { return Codec<V>::write(*value); }
+};
+
+template <typename V>
+struct Codec<std::vector<V>> {
+    static bool read(const json& j, std::vector<V>& out) {
+        out.clear();
+        if (!j.is_array()) return false;
+        out.reserve(j.size());
+        for (const auto& element : j) {
+            V value{};
+            Codec<V>::read(element, value);
+            out.push_back(std::move(value));
+        }
+        return true;
+    }
+    static bool read(json&& j, std::vector<V>& out) {
+        out.clear();
+        if (!j.is_array()) return false;
+        out.reserve(j.size());
+        for (auto& element : j) {
+            V value{};
+            Codec<V>::read(std::move(element), value);
+            out.push_back(std::move(value));
+        }
+        return true;
+    }
+    static json write(const std::vector<V>& values) {
+        json array = json::array();
+        for (const auto& value : values) {
+            array.push_back(Codec<V>::write(value));
+        }
+        return array;
+    }
+};
+
+template <>
+struct Codec<Metadata> {
+    static bool read(const json& j, Metadata& out) {
+        // Market listings can carry their metadata column still serialized as text
+        if (j.is_string()) {
+            out = Metadata::fromJson(json::parse(j.get_ref<const std::string&>(), nullptr, false), out.arena());
+            return true;
+        }
+        out = Metadata::fromJson(j, out.arena());
+        return j.is_object();
+    }
+    static bool read(json&& j, Metadata& out) {
+        if (j.is_string()) {
+            return read(static_cast<const json&>(j), out);
+        }
+        bool isObject = j.is_object();
+        out = Metadata::fromJson(std::move(j), out.arena());
+        return isObject;
+    }
+    static json write(const Metadata& value) { return value.toJson(); }
+};
+
+template <typename V>
+struct Codec<std::unordered_map<std::string, V>> {
+    static bool read(const json& j, std::unordered_map<std::string, V>& out) {
+        out.clear();
+        if (!j.is_object()) return false;
+        out.reserve(j.size());
+        for (auto it = j.begin(); it != j.end(); ++it) {
+            Codec<V>::read(it.value(), out[it.key()]);
+        }
+        return true;
+    }
+    static bool read(json&& j, std::unordered_map<std::string, V>& out) {
+        out.clear();
+        if (!j.is_object()) return false;
+        out.reserve(j.size());
+        for (auto it = j.begin(); it != j.end(); ++it) {
+            Codec<V>::read(std::move(it.value()), out[it.key()]);
+        }
+        return true;
+    }
+    static json write(const std::unordered_map<std::string, V>& values) {
+        json object = json::object();
+        for (const auto& [key, value] : values) {
+            object[key] = Codec<V>::write(value);
+        }
+        return object;
+    }
+};
+
+template <typename V>
+struct Codec<V, std::enable_if_t<IsReflected<V>::value>> {
+    static bool read(const json& j, V& out) {
+        readObject(j, out);
+        return j.is_object();
+    }
+    static bool read(json&& j, V& out) {
+        bool isObject = j.is_object();
+        readObject(std::move(j), out);
+        return isObject;
+    }
+    static json write(const V& value) { return writeObject(value); }
+};
+
+// Decoding of a single member straight from its JSON text, for readProjected.
+// Strings, numbers, booleans and null are read in place; any other value is
+// parsed and handed to its Codec. Like Codec::read, a well-formed value of the
+// wrong type leaves the field at its default.
+enum class TextRead { Read, WrongType, Malformed };
+
+// `raw` includes the quotes; escape sequences are decoded
+bool readJsonString(std::string_view raw, std::string& out);
+bool readJsonNumber(std::string_view raw, double& out);
+bool readJsonNumber(std::string_view raw, int& out);
+
+template <typename V>
+TextRead readParsed(std::string_view raw, V& out) {
+    json j = json::parse(raw.begin(), raw.end(), nullptr, false);
+    if (j.is_discarded()) return TextRead::Malformed;
+    return Codec<V>::read(std::move(j), out) ? TextRead::Read : TextRead::WrongType;
+}
+
+template <typename V, typename = void>
+struct TextCodec {
+    static TextRead read(std::string_view raw, V& out) { return readParsed(raw, out); }
+};
+
+template <>
+struct TextCodec<std::string> {
+    static TextRead read(std::string_view raw, std::string& out) {
+        if (raw.empty() || raw.front() != '"') return readParsed(raw, out);
+        return readJsonString(raw, out) ? TextRead::Read : TextRead::Malformed;
+    }
+};
+
+template <>
+struct TextCodec<bool> {
+    static TextRead read(std::string_view raw, bool& out) {
+        double number;
+        if (raw == "true" || raw == "false") {
+            out = raw == "true";
+        } else if (readJsonNumber(raw, number)) {
+            out = number != 0;
+        } else {
+            return readParsed(raw, out);
+        }
+        return TextRead::Read;
+    }
+};
+
+template <>
+struct TextCodec<int> {
+    static TextRead read(std::string_view raw, int& out) {
+        return readJsonNumber(raw, out) ? TextRead::Read : readParsed(raw, out);
+    }
+};
+
+template <>
+struct TextCodec<double> {
+    static TextRead read(std::string_view raw, double& out) {
+        return readJsonNumber(raw, out) ? TextRead::Read : readParsed(raw, out);
+    }
+};
+
+template <typename V>
+struct TextCodec<std::optional<V>> {
+    static TextRead read(std::string_view raw, std::optional<V>& out) {
+        if (raw == "null") {
+            out.reset();
+            return TextRead::Read;
+        }
+        V value{};
+        TextRead result = TextCodec<V>::read(raw, value);
+        if (result == TextRead::Read) {
+            out = std::move(value);
+        }
+        return result;
+    }
+};
+
+template <typename V>
+struct TextCodec<V, std::enable_if_t<IsReflected<V>::value>> {
+    static TextRead read(std::string_view raw, V& out) {
+        if (raw.empty() || raw.front() != '{') return readParsed(raw, out);
+        return readProjected(raw, out) ? TextRead::Read : TextRead::Malformed;
+    }
+};
+
+template <typename V>
+bool isSet(const V&) { return true; }
+
+template <typename V>
+bool isSet(const std::optional<V>& value) { return value.has_value(); }
+
+constexpr std::size_t nextPowerOfTwo(std::size_t n) {
+    std::size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+// Perfect hash over the field names of T: slot = fnv1a(key, basis) & mask
+// is collision-free for every declared key, so a lookup costs one hash, one
+// table load and one string comparison.
+template <typename T>
+struct FieldIndex {
+    using Fields = std::remove_const_t<decltype(Reflect<T>::fields)>;
+    static constexpr std::size_t count = std::tuple_size_v<Fields>;
+    static constexpr std::size_t buckets = nextPowerOfTwo(count * 4);
+    static constexpr std::uint8_t empty = 0xFF;
+    static_assert(count < empty, "too many fields for the perfect hash table");
+
+    template <std::size_t... Is>
+    static constexpr std::array<std::string_view, count> namesOf(std::index_sequence<Is...>) {
+        return {std::get<Is>(Reflect<T>::fields).name...};
+    }
+    static constexpr std::array<std::string_view, count> names = namesOf(std::make_index_sequence<count>{});
+
+    static constexpr bool collisionFree(std::uint32_t basis) {
+        std::array<bool, buckets> used{};
+        for (std::string_view name : names) {
+            std::size_t slot = fnv1a(name, basis) & (buckets - 1);
+            if (used[slot]) return false;
+            used[slot] = true;
+        }
+        return true;
+    }
+
+    static constexpr std::uint32_t findBasis() {
+        for (std::uint32_t attempt = 0; attempt < 100000; ++attempt) {
+            std::uint32_t basis = 2166136261u ^ (attempt * 0x9E3779B9u);
+            if (collisionFree(basis)) return basis;
+        }
+        return 0;
+    }
+    static constexpr std::uint32_t basis = findBasis();
+    static_assert(basis != 0, "no perfect hash found for field names");
+
+    static constexpr std::array<std::uint8_t, buckets> buildTable() {
+        std::array<std::uint8_t, buckets> table{};
+        for (auto& slot : table) slot = empty;
+        for (std::size_t i = 0; i < count; ++i) {
+            table[fnv1a(names[i], basis) & (buckets - 1)] = static_cast<std::uint8_t>(i);
+        }
+        return table;
+    }
+    static constexpr std::array<std::uint8_t, buckets> table = buildTable();
+
+    // Index of the field called `key`, or -1 when T has no such field
+    static constexpr int lookup(std::string_view key) {
+        std::uint8_t slot = table[fnv1a(key, basis) & (buckets - 1)];
+        return slot != empty && names[slot] == key ? slot : -1;
+    }
+
+    template <std::size_t I>
+    static void readField(T& object, const json& value) {
+        constexpr auto f = std::get<I>(Reflect<T>::fields);
+        using Member = std::remove_reference_t<decltype(object.*(f.member))>;
+        Codec<Member>::read(value, object.*(f.member));
+    }
+
+    using Reader = void (*)(T&, const json&);
+    template <std::size_t... Is>
+    static constexpr std::array<Reader, count> readersOf(std::index_sequence<Is...>) {
+        return {&readField<Is>...};
+    }
+    static constexpr std::array<Reader, count> readers = readersOf(std::make_index_sequence<count>{});
+
+    // Same as readField, moving the value out of a document being consumed
+    template <std::size_t I>
+    static void moveField(T& object, json&& value) {
+        constexpr auto f = std::get<I>(Reflect<T>::fields);
+        using Member = std::remove_reference_t<decltype(object.*(f.member))>;
+        Codec<Member>::read(std::move(value), object.*(f.member));
+    }
+
+    using Mover = void (*)(T&, json&&);
+    template <std::size_t... Is>
+    static constexpr std::array<Mover, count> moversOf(std::index_sequence<Is...>) {
+        return {&moveField<Is>...};
+    }
+    static constexpr std::array<Mover, count> movers = moversOf(std::make_index_sequence<count>{});
+
+    // Same as readField, decoding the value from its JSON text; false when
+    // the text is malformed
+    template <std::size_t I>
+    static bool scanField(T& object, std::string_view value) {
+        constexpr auto f = std::get<I>(Reflect<T>::fields);
+        using Member = std::remove_reference_t<decltype(object.*(f.member))>;
+        return TextCodec<Member>::read(value, object.*(f.member)) != TextRead::Malformed;
+    }
+
+    using Scanner = bool (*)(T&, std::string_view);
+    template <std::size_t... Is>
+    static constexpr std::array<Scanner, count> scannersOf(std::index_sequence<Is...>) {
+        return {&scanField<Is>...};
+    }
+    static constexpr std::array<Scanner, count> scanners = scannersOf(std::make_index_sequence<count>{});
+};
+
+template <typename T, std::size_t... Is>
+void resetFields(T& object, std::index_sequence<Is...>) {
+    ((object.*(std::get<Is>(Reflect<T>::fields).member) = {}), ...);
+}
+
+template <typename T, std::size_t... Is>
+void writeFields(const T& object, json& j, std::index_sequence<Is...>) {
+    auto writeOne = [&](const auto& f) {
+        const auto& value = object.*(f.member);
+        using Member = std::remove_cv_t<std::remove_reference_t<decltype(value)>>;
+        if (isSet(value)) {
+            j[f.name.data()] = Codec<Member>::write(value);
+        }
+    };
+    (writeOne(std::get<Is>(Reflect<T>::fields)), ...);
+}
+
+// Fill `object` from a JSON object; fields absent from `j` keep their defaults
+template <typename T>
+void readObject(const json& j, T& object) {
+    using Index = FieldIndex<T>;
+    resetFields(object, std::make_index_sequence<Index::count>{});
+    if (!j.is_object()) return;
+    for (auto it = j.begin(); it != j.end(); ++it) {
+        int slot = Index::lookup(it.key());
+        if (slot >= 0) {
+            Index::readers[slot](object, it.value());
+        }
+    }
+}
+
+// Same as above, moving field values out of `j`
+template <typename T>
+void readObject(json&& j, T& object) {
+    using Index = FieldIndex<T>;
+    resetFields(object, std::make_index_sequence<Index::count>{});
+    if (!j.is_object()) return;
+    for (auto it = j.begin(); it != j.end(); ++it) {
+        int slot = Index::lookup(it.key());
+        if (slot >= 0) {
+            Index::movers[slot](object, std::move(it.value()));
+        }
+    }
+}
+
+template <typename T>
+json writeObject(const T& object) {
+    json j = json::object();
+    writeFields(object, j, std::make_index_sequence<FieldIndex<T>::count>{});
+    return j;
+}
+
+// Serializes JSON straight into a caller-owned buffer, without building a
+// DOM. Commas are inserted automatically; unset optional fields of reflected
+// structs are skipped like in writeObject().
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) : out(out) {}
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+    JsonWriter& key(std::string_view name);
+
+    JsonWriter& write(std::string_view text);
+    JsonWriter& write(const char* text) { return write(std::string_view(text)); }
+    JsonWriter& write(const std::string& text) { return write(std::string_view(text)); }
+    JsonWriter& write(bool flag);
+    JsonWriter& write(int number);
+    JsonWriter& write(double number);
+    JsonWriter& write(const json& j);
+    JsonWriter& write(const Metadata& metadata);
+
+    template <typename V>
+    JsonWriter& write(const std::optional<V>& value) {
+        if (!value) return writeNull();
+        return write(*value);
+    }
+
+    template <typename V>
+    JsonWriter& write(const std::vector<V>& values) {
+        beginArray();
+        for (const auto& value : values) {
+            write(value);
+        }
+        return endArray();
+    }
+
+    template <typename T, std::enable_if_t<IsReflected<T>::value, int> = 0>
+    JsonWriter& write(const T& object) {
+        beginObject();
+        std::apply([&](const auto&... f) { (writeField(object, f), ...); }, Reflect<T>::fields);
+        return endObject();
+    }
+
+    template <typename V>
+    JsonWriter& member(std::string_view name, const V& value) {
+        key(name);
+        return write(value);
+    }
+
+    JsonWriter& writeNull();
+
+private:
+    template <typename T, typename F>
+    void writeField(const T& object, const F& f) {
+        const auto& value = object.*(f.member);
+        if (isSet(value)) {
+            member(f.name, value);
+        }
+    }
+    void separate() {
+        if (needComma) out.push_back(',');
+    }
+    void writeString(std::string_view text);
+    void writeNumber(const char* begin, const char* end);
+
+    std::string& out;
+    bool needComma = false;
+};
+
+// Raw JSON text scanning, used to walk objects without building a DOM
+
+inline bool isJsonSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline std::size_t skipWhitespace(std::string_view text, std::size_t pos) {
+    while (pos < text.size() && isJsonSpace(text[pos])) ++pos;
+    return pos;
+}
+
+// `pos` is on the opening quote; returns the position past the closing one
+inline std::size_t skipString(std::string_view text, std::size_t pos) {
+    for (++pos; pos < text.size(); ++pos) {
+        if (text[pos] == '\\') {
+            ++pos;
+        } else if (text[pos] == '"') {
+            return pos + 1;
+        }
+    }
+    return text.size();
+}
+
+// Returns the position just past the value starting at `pos`
+inline std::size_t skipValue(std::string_view text, std::size_t pos) {
+    pos = skipWhitespace(text, pos);
+    if (pos >= text.size()) return pos;
+    if (text[pos] == '"') return skipString(text, pos);
+    if (text[pos] == '{' || text[pos] == '[') {
+        int depth = 0;
+        while (pos < text.size()) {
+            char c = text[pos];
+            if (c == '"') {
+                pos = skipString(text, pos);
+                continue;
+            }
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if ((c == '}' || c == ']') && --depth == 0) {
+                return pos + 1;
+            }
+            ++pos;
+        }
+        return pos;
+    }
+    while (pos < text.size() && text[pos] != ',' && text[pos] != '}' && text[pos] != ']' &&
+           !isJsonSpace(text[pos])) {
+        ++pos;
+    }
+    return pos;
+}
+
+// Calls onMember(key, valueText) for each member of a JSON object. Keys are
+// passed raw (escape sequences are not decoded). Returns false when the text
+// is not an object or stops before its closing brace.
+template <typename F>
+bool forEachMember(std::string_view object, F&& onMember) {
+    std::size_t pos = skipWhitespace(object, 0);
+    if (pos >= object.size() || object[pos] != '{') return false;
+    pos = skipWhitespace(object, pos + 1);
+    if (pos < object.size() && object[pos] == '}') return true;
+    while (true) {
+        pos = skipWhitespace(object, pos);
+        if (pos >= object.size() || object[pos] != '"') return false;
+        std::size_t keyEnd = skipString(object, pos);
+        std::string_view key = object.substr(pos + 1, keyEnd - pos - 2);
+        pos = skipWhitespace(object, keyEnd);
+        if (pos >= object.size() || object[pos] != ':') return false;
+        std::size_t valueStart = skipWhitespace(object, pos + 1);
+        if (valueStart >= object.size()) return false;
+        std::size_t valueEnd = skipValue(object, valueStart);
+        onMember(key, object.substr(valueStart, valueEnd - valueStart));
+        pos = skipWhitespace(object, valueEnd);
+        if (pos < object.size() && object[pos] == '}') return true;
+        if (pos >= object.size() || object[pos] != ',') return false;
+        ++pos;
+    }
+}
+
+// Fill `object` straight from the JSON text of an object. Only the members
+// declared in Reflect<T> are decoded, strings and numbers in place; all others
+// are skipped without being copied or materialized. Never throws: returns
+// false when the object or one of the decoded members is malformed, leaving
+// what could not be read at its default.
+template <typename T>
+bool readProjected(std::string_view text, T& object) {
+    using Index = FieldIndex<T>;
+    resetFields(object, std::make_index_sequence<Index::count>{});
+    bool wellFormed = true;
+    bool complete = forEachMember(text, [&object, &wellFormed](std::string_view key, std::string_view value) {
+        int slot = Index::lookup(key);
+        if (slot >= 0 && !Index::scanners[slot](object, value)) {
+            wellFormed = false;
+        }
+    });
+    return complete && wellFormed;
+}
+
+// Incremental splitter for a JSON document containing one large array.
+// Bytes are fed as they come off the socket; every complete element of the
+// target array is handed out as raw JSON text, everything else is kept so
+// the surrounding object (e.g. "user_id" or an error "message") can still be
+// parsed once the transfer is over. An empty `arrayKey` targets a top-level
+// array. Both arguments are kept by reference.
+class JsonArraySplitter {
+public:
+    JsonArraySplitter(const std::string& arrayKey,
+                      const std::function<bool(std::string_view)>& onElement)
+        : arrayKey(arrayKey), onElement(onElement) {}
+
+    // Returns false once the consumer asked to stop or threw.
+    bool feed(std::string_view chunk);
+
+    // The document without the elements of the target array
+    const std::string& remainder() const { return rest; }
+    std::exception_ptr failure() const { return error; }
+    bool stopped() const { return stop; }
+
+private:
+    bool step(char c);
+    bool betweenElements(char c);
+    bool elementChar(char c);
+    void documentChar(char c);
+    bool emit();
+    void closeArray();
+
+    const std::string& arrayKey;
+    const std::function<bool(std::string_view)>& onElement;
+
+    int depth = 0;
+    int arrayDepth = -1;
+    bool found = false;
+    bool inString = false;
+    bool escape = false;
+    bool inElement = false;
+    bool stop = false;
+    std::string element;
+    std::string rest;
+    std::string current;
+    std::string lastString;
+    std::string pendingKey;
+    std::exception_ptr error;
+};
+
+} // namespace detail
+
+// --- INTERNED IDS ---
+// Compact handle for an ID string (itemId, user_id, gameId, ...). Every
+// distinct string is stored once in a process-wide interner, so an Id is a
+// 32-bit index that compares and hashes like an integer.
+class Id {
+public:
+    Id() = default;
+    explicit Id(std::string_view value);
+
+    // The interned string; valid for the lifetime of the process
+    std::string_view str() const;
+    std::uint32_t index() const { return value; }
+    bool empty() const { return value == 0; }
+
+    friend bool operator==(Id a, Id b) { return a.value == b.value; }
+    friend bool operator!=(Id a, Id b) { return a.value != b.value; }
+    // Orders by interning order, not alphabetically
+    friend bool operator<(Id a, Id b) { return a.value < b.value; }
+
+private:
+    std::uint32_t value = 0;
+};
+
+// Thread-safe, append-only string table behind Id. Lookups by index are
+// lock-free; interning locks one of several shards.
+class IdInterner {
+public:
+    static IdInterner& global();
+
+    std::uint32_t intern(std::string_view value);
+    std::string_view lookup(std::uint32_t index) const;
+    std::size_t size() const { return next.load(std::memory_order_acquire); }
+
+    IdInterner();
+    ~IdInterner();
+    IdInterner(const IdInterner&) = delete;
+    IdInterner& operator=(const IdInterner&) = delete;
+
+private:
+    static constexpr std::size_t shardCount = 16;
+    static constexpr std::size_t chunkBits = 16;
+    static constexpr std::size_t chunkSize = std::size_t(1) << chunkBits;
+    static constexpr std::size_t maxChunks = 4096;
+    static constexpr std::size_t blockSize = 64 * 1024;
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string_view, std::uint32_t> indices;
+        std::vector<std::unique_ptr<char[]>> blocks;
+        std::vector<std::unique_ptr<char[]>> oversized;
+        std::size_t blockUsed = blockSize;
+    };
+
+    std::string_view store(Shard& shard, std::string_view value);
+    std::string_view* chunkFor(std::uint32_t index);
+
+    Shard shards[shardCount];
+    std::atomic<std::string_view*> chunks[maxChunks];
+    std::mutex chunkMutex;
+    std::atomic<std::uint32_t> next{1};
+};
+
+namespace detail {
+
+template <>
+struct Codec<Id> {
+    static bool read(const json& j, Id& out) {
+        if (!j.is_string()) return false;
+        out = Id(j.get_ref<const std::string&>());
+        return true;
+    }
+    static json write(Id value) { return std::string(value.str()); }
+};
+
+template <>
+struct TextCodec<Id> {
+    static TextRead read(std::string_view raw, Id& out) {
+        if (raw.size() < 2 || raw.front() != '"') return readParsed(raw, out);
+        std::string_view text = raw.substr(1, raw.size() - 2);
+        if (raw.back() == '"' && text.find('\\') == std::string_view::npos) {
+            out = Id(text);
+            return TextRead::Read;
+        }
+        std::string decoded;
+        if (!readJsonString(raw, decoded)) return TextRead::Malformed;
+        out = Id(decoded);
+        return TextRead::Read;
+    }
+};
+
+} // namespace detail
+
+// --- PROJECTIONS ---
+// Compact views of a response type for paths that only need a few fields.
+// Any struct with a Reflect<T> specialization can be used as a projection
+// with the `...As<T>()` calls, e.g. `api.games.listAs<GamePrice>()`.
+
+struct ItemAmount {
+    std::string itemId;
+    int amount = 0;
+};
+
+struct GamePrice {
+    std::string gameId;
+    double price = 0.0;
+};
+
+template <> struct Reflect<ItemAmount> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("itemId", &ItemAmount::itemId),
+        detail::field("amount", &ItemAmount::amount));
+};
+
+template <> struct Reflect<GamePrice> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("gameId", &GamePrice::gameId),
+        detail::field("price", &GamePrice::price));
+};
+
+// Interned counterparts of the ID-heavy types, for large ID-keyed caches.
+// Use them wherever a projection is accepted, e.g.
+// `api.inventory.getAs<InternedInventoryItem>(userId)`.
+
+struct InternedInventoryItem {
+    Id user_id;
+    Id itemId;
+    Id owner;
+    int amount = 0;
+    double price = 0.0;
+    bool showInStore = false;
+};
+
+struct InternedTradeItem {
+    Id itemId;
+    int amount = 0;
+};
+
+struct InternedTrade {
+    Id id;
+    Id fromUserId;
+    Id toUserId;
+    std::vector<InternedTradeItem> fromUserItems;
+    std::vector<InternedTradeItem> toUserItems;
+    bool approvedFromUser = false;
+    bool approvedToUser = false;
+    std::string status;
+};
+
+struct InternedGame {
+    Id gameId;
+    Id owner_id;
+    double price = 0.0;
+    bool showInStore = false;
+};
+
+template <> struct Reflect<InternedInventoryItem> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("user_id", &InternedInventoryItem::user_id),
+        detail::field("itemId", &InternedInventoryItem::itemId),
+        detail::field("owner", &InternedInventoryItem::owner),
+        detail::field("amount", &InternedInventoryItem::amount),
+        detail::field("price", &InternedInventoryItem::price),
+        detail::field("showInStore", &InternedInventoryItem::showInStore));
+};
+
+template <> struct Reflect<InternedTradeItem> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("itemId", &InternedTradeItem::itemId),
+        detail::field("amount", &InternedTradeItem::amount));
+};
+
+template <> struct Reflect<InternedTrade> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("id", &InternedTrade::id),
+        detail::field("fromUserId", &InternedTrade::fromUserId),
+        detail::field("toUserId", &InternedTrade::toUserId),
+        detail::field("fromUserItems", &InternedTrade::fromUserItems),
+        detail::field("toUserItems", &InternedTrade::toUserItems),
+        detail::field("approvedFromUser", &InternedTrade::approvedFromUser),
+        detail::field("approvedToUser", &InternedTrade::approvedToUser),
+        detail::field("status", &InternedTrade::status));
+};
+
+template <> struct Reflect<InternedGame> {
+    static constexpr auto fields = std::make_tuple(
+        detail::field("gameId", &InternedGame::gameId),
+        detail::field("owner_id", &InternedGame::owner_id),
+        detail::field("price", &InternedGame::price),
+        detail::field("showInStore", &InternedGame::showInStore));
+};
+
+// --- COMPACT LAYOUTS ---
+// Memory-lean alternatives to User and Game for large in-memory caches.
+// Optional bools are packed into bit masks and absent optional strings cost
+// nothing: present ones share a single length-prefixed buffer.
+namespace detail {
+
+// Up to 32 optional strings stored back to back in one buffer
+class PackedStrings {
+public:
+    PackedStrings() = default;
+    explicit PackedStrings(std::initializer_list<const std::optional<std::string>*> fields);
+
+    std::optional<std::string_view> get(std::size_t slot) const;
+    std::optional<std::string> copy(std::size_t slot) const {
+        auto value = get(slot);
+        return value ? std::optional<std::string>(std::string(*value)) : std::nullopt;
+    }
+    std::size_t heapBytes() const { return data.capacity() >= sizeof(std::string) ? data.capacity() : 0; }
+
+private:
+    std::uint32_t present = 0;
+    std::string data;
+};
+
+// Up to 16 optional bools in 32 bits
+class PackedFlags {
+public:
+    void set(std::size_t slot, std::optional<bool> value) {
+        std::uint16_t bit = static_cast<std::uint16_t>(1u << slot);
+        present = value ? (present | bit) : (present & ~bit);
+        values = value && *value ? (values | bit) : (values & ~bit);
+    }
+    std::optional<bool> get(std::size_t slot) const {
+        if (!(present >> slot & 1u)) return std::nullopt;
+        return (values >> slot & 1u) != 0;
+    }
+
+private:
+    std::uint16_t present = 0;
+    std::uint16_t values = 0;
+};
+
+} // namespace detail
+
+class CompactUser {
+public:
+    CompactUser() = default;
+    explicit CompactUser(const User& user);
+    User toUser() const;
+
+    const std::string& userId() const { return id; }
+    const std::string& username() const { return name; }
+    bool verified() const { return flags.get(Verified).value_or(false); }
+    std::optional<std::string_view> email() const { return strings.get(Email); }
+    std::optional<std::string_view> verificationKey() const { return strings.get(VerificationKey); }
+    std::optional<std::string_view> steam_id() const { return strings.get(SteamId); }
+    std::optional<std::string_view> steam_username() const { return strings.get(SteamUsername); }
+    std::optional<std::string_view> steam_avatar_url() const { return strings.get(SteamAvatarUrl); }
+    std::optional<std::string_view> google_id() const { return strings.get(GoogleId); }
+    std::optional<std::string_view> discord_id() const { return strings.get(DiscordId); }
+    std::optional<bool> isStudio() const { return flags.get(IsStudio); }
+    std::optional<bool> admin() const { return flags.get(Admin); }
+    std::optional<bool> disabled() const { return flags.get(Disabled); }
+    std::optional<bool> haveAuthenticator() const { return flags.get(HaveAuthenticator); }
+    std::optional<double> balance() const { return flags.get(HasBalance) ? std::optional<double>(balanceValue) : std::nullopt; }
+
+    // Approximate bytes used by this object, including heap allocations
+    std::size_t footprint() const;
+
+private:
+    enum StringSlot { Email, VerificationKey, SteamId, SteamUsername, SteamAvatarUrl, GoogleId, DiscordId };
+    enum FlagSlot { Verified, IsStudio, Admin, Disabled, HaveAuthenticator, HasBalance };
+
+    // Nested collections are rare in cached users; they live out of line
+    struct Collections {
+        std::optional<std::vector<Studio>> studios;
+        std::optional<std::vector<std::string>> roles;
+        std::optional<std::vector<InventoryItem>> inventory;
+        std::optional<std::vector<Item>> ownedItems;
+        std::optional<std::vector<Game>> createdGames;
+    };
+
+    std::string id;
+    std::string name;
+    detail::PackedStrings strings;
+    double balanceValue = 0.0;
+    detail::PackedFlags flags;
+    std::shared_ptr<const Collections> collections;
+};
+
+class CompactGame {
+public:
+    CompactGame() = default;
+    explicit CompactGame(const Game& game);
+    Game toGame() const;
+
+    const std::string& gameId() const { return id; }
+    const std::string& name() const { return title; }
+    const std::string& description() const { return text; }
+    double price() const { return priceValue; }
+    double rating() const { return ratingValue; }
+    const std::string& owner_id() const { return owner; }
+    bool showInStore() const { return flags.get(ShowInStore).value_or(false); }
+    bool multiplayer() const { return flags.get(Multiplayer).value_or(false); }
+    std::optional<std::string_view> iconHash() const { return strings.get(IconHash); }
+    std::optional<std::string_view> splashHash() const { return strings.get(SplashHash); }
+    std::optional<std::string_view> bannerHash() const { return strings.get(BannerHash); }
+    std::optional<std::string_view> genre() const { return strings.get(Genre); }
+    std::optional<std::string_view> release_date() const { return strings.get(ReleaseDate); }
+    std::optional<std::string_view> developer() const { return strings.get(Developer); }
+    std::optional<std::string_view> publisher() const { return strings.get(Publisher); }
+    std::optional<std::string_view> website() const { return strings.get(Website); }
+    std::optional<std::string_view> trailer_link() const { return strings.get(TrailerLink); }
+    std::optional<std::string_view> download_link() const { return strings.get(DownloadLink); }
+    const std::vector<std::string>* platforms() const { return platformList.get(); }
+
+    // Approximate bytes used by this object, including heap allocations
+    std::size_t footprint() const;
+
+private:
+    enum StringSlot { IconHash, SplashHash, BannerHash, Genre, ReleaseDate, Developer, Publisher,
+                      Website, TrailerLink, DownloadLink };
+    enum FlagSlot { ShowInStore, Multiplayer };
+
+    std::string id;
+    std::string title;
+    std::string text;
+    std::string owner;
+    double priceValue = 0.0;
+    double ratingValue = 0.0;
+    detail::PackedStrings strings;
+    detail::PackedFlags flags;
+    std::shared_ptr<const std::vector<std::string>> platformList;
+};
+
+// Layout regression checks: the compact types must stay well below the full ones
+static_assert(sizeof(detail::PackedFlags) == 4, "PackedFlags grew");
+static_assert(sizeof(CompactUser) <= 3 * sizeof(std::string) + 48, "CompactUser layout regressed");
+static_assert(sizeof(CompactGame) <= 5 * sizeof(std::string) + 48, "CompactGame layout regressed");
+static_assert(sizeof(CompactUser) * 3 < sizeof(User), "CompactUser should be far smaller than User");
+static_assert(sizeof(CompactGame) * 2 < sizeof(Game), "CompactGame should be far smaller than Game");
+
+// --- INVENTORY TABLE ---
+// Column-oriented (struct-of-arrays) inventory storage for analytics over
+// large inventories. Numbers and flags sit in contiguous columns so the
+// aggregation kernels can run with SIMD; IDs are stored as interned Ids.
+class InventoryTable {
+public:
+    void reserve(std::size_t rows);
+    void clear();
+    void append(const InventoryItem& item);
+    void append(const InternedInventoryItem& item);
+
+    std::size_t size() const { return amountColumn.size(); }
+    bool empty() const { return amountColumn.empty(); }
+
+    const std::vector<Id>& userIds() const { return userColumn; }
+    const std::vector<Id>& itemIds() const { return itemColumn; }
+    const std::vector<Id>& owners() const { return ownerColumn; }
+    const std::vector<std::int32_t>& amounts() const { return amountColumn; }
+    const std::vector<double>& prices() const { return priceColumn; }
+    // 1 if the item is shown in the store, 0 otherwise
+    const std::vector<std::uint8_t>& showInStore() const { return storeColumn; }
+
+    // Sum of price * amount over all rows
+    double totalValue() const;
+    // Sum of price * amount over rows whose showInStore flag equals `shown`
+    double totalValue(bool shown) const;
+    std::int64_t totalAmount() const;
+    // Indices of rows whose showInStore flag equals `shown`
+    std::vector<std::uint32_t> filterShowInStore(bool shown) const;
+    // price * amount summed per item owner
+    std::unordered_map<Id, double> valueByOwner() const;
+
+private:
+    friend class Client;
+
+    std::vector<Id> userColumn;
+    std::vector<Id> itemColumn;
+    std::vector<Id> ownerColumn;
+    std::vector<std::int32_t> amountColumn;
+    std::vector<double> priceColumn;
+    std::vector<std::uint8_t> storeColumn;
+};
+
+// --- LAZY VIEWS ---
+// A response body kept alive by the views that point into it. Views decode
+// fields only when they are read; strings come back as std::string_view into
+// the body, except for escaped strings, whose decoded copy is stored here.
+struct ResponseBody {
+    std::string text;
+    mutable std::mutex decodedMutex;
+    mutable std::deque<std::string> decoded;
+    // Offset of an escaped string value in `text` -> its index in `decoded`
+    mutable std::unordered_map<std::size_t, std::size_t> decodedAt;
+};
+
+class ObjectView {
+public:
+    ObjectView() = default;
+    ObjectView(std::shared_ptr<const ResponseBody> body, std::string_view text)
+        : body(std::move(body)), text(text) {}
+
+    // Raw JSON text of the object, and of one member (empty if absent)
+    std::string_view raw() const { return text; }
+    std::string_view raw(std::string_view key) const;
+
+    // True if the member exists and is not null
+    bool has(std::string_view key) const;
+
+    std::string_view string(std::string_view key) const;
+    std::optional<std::string_view> optionalString(std::string_view key) const;
+    double number(std::string_view key, double fallback = 0.0) const;
+    std::optional<double> optionalNumber(std::string_view key) const;
+    bool boolean(std::string_view key, bool fallback = false) const;
+    std::optional<bool> optionalBoolean(std::string_view key) const;
+
+    // Parse into any reflected type (a full struct or a projection); members
+    // that are malformed keep their defaults
+    template <typename T>
+    T as() const {
+        T object;
+        detail::readProjected(text, object);
+        return object;
+    }
+
+private:
+    std::shared_ptr<const ResponseBody> body;
+    std::string_view text;
+};
+
+class ItemView : public ObjectView {
+public:
+    using ObjectView::ObjectView;
+    std::string_view itemId() const { return string("itemId"); }
+    std::string_view name() const { return string("name"); }
+    std::string_view description() const { return string("description"); }
+    std::string_view owner() const { return string("owner"); }
+    double price() const { return number("price"); }
+    std::string_view iconHash() const { return string("iconHash"); }
+    std::optional<bool> showInStore() const { return optionalBoolean("showInStore"); }
+    std::optional<bool> deleted() const { return optionalBoolean("deleted"); }
+    Item materialize() const { return as<Item>(); }
+};
+
+class GameView : public ObjectView {
+public:
+    using ObjectView::ObjectView;
+    std::string_view gameId() const { return string("gameId"); }
+    std::string_view name() const { return string("name"); }
+    std::string_view description() const { return string("description"); }
+    double price() const { return number("price"); }
+    std::string_view owner_id() const { return string("owner_id"); }
+    bool showInStore() const { return boolean("showInStore"); }
+    std::optional<std::string_view> iconHash() const { return optionalString("iconHash"); }
+    std::optional<std::string_view> splashHash() const { return optionalString("splashHash"); }
+    std::optional<std::string_view> bannerHash() const { return optionalString("bannerHash"); }
+    std::optional<std::string_view> genre() const { return optionalString("genre"); }
+    std::optional<std::string_view> release_date() const { return optionalString("release_date"); }
+    std::optional<std::string_view> developer() const { return optionalString("developer"); }
+    std::optional<std::string_view> publisher() const { return optionalString("publisher"); }
+    double rating() const { return number("rating"); }
+    std::optional<std::string_view> website() const { return optionalString("website"); }
+    std::optional<std::string_view> trailer_link() const { return optionalString("trailer_link"); }
+    bool multiplayer() const { return boolean("multiplayer"); }
+    std::optional<std::string_view> download_link() const { return optionalString("download_link"); }
+    Game materialize() const { return as<Game>(); }
+};
+
+class UserView : public ObjectView {
+public:
+    using ObjectView::ObjectView;
+    std::string_view userId() const { return string("userId"); }
+    std::string_view username() const { return string("username"); }
+    std::optional<std::string_view> email() const { return optionalString("email"); }
+    bool verified() const { return boolean("verified"); }
+    std::optional<std::string_view> steam_id() const { return optionalString("steam_id"); }
+    std::optional<std::string_view> steam_username() const { return optionalString("steam_username"); }
+    std::optional<std::string_view> steam_avatar_url() const { return optionalString("steam_avatar_url"); }
+    std::optional<bool> isStudio() const { return optionalBoolean("isStudio"); }
+    std::optional<bool> admin() const { return optionalBoolean("admin"); }
+    std::optional<bool> disabled() const { return optionalBoolean("disabled"); }
+    std::optional<double> balance() const { return optionalNumber("balance"); }
+    User materialize() const { return as<User>(); }
+};
+
+// The elements of a JSON array response, as views sharing one body
+template <typename V>
+class ListView {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = V;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = V;
+
+        iterator(const ListView* list, std::size_t index) : list(list), index(index) {}
+        V operator*() const { return (*list)[index]; }
+        iterator& operator++() { ++index; return *this; }
+        iterator operator++(int) { iterator previous = *this; ++index; return previous; }
+        bool operator==(const iterator& other) const { return index == other.index; }
+        bool operator!=(const iterator& other) const { return index != other.index; }
+
+    private:
+        const ListView* list;
+        std::size_t index;
+    };
+
+    ListView() = default;
+    ListView(std::shared_ptr<const ResponseBody> body, std::vector<std::string_view> elements)
+        : body(std::move(body)), elements(std::move(elements)) {}
+
+    std::size_t size() const { return elements.size(); }
+    bool empty() const { return elements.empty(); }
+    V operator[](std::size_t index) const { return V(body, elements[index]); }
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, elements.size()); }
+
+private:
+    std::shared_ptr<const ResponseBody> body;
+    std::vector<std::string_view> elements;
+};
+
+namespace detail {
+
+// Spans of the elements of the JSON array held in `text`
+std::vector<std::string_view> arrayElements(std::string_view text);
+
+} // namespace detail
+
+// --- GLOBAL SEARCH ---
+
+struct SearchResults {
+    std::vector<User> users;
+    std::vector<Game> games;
+    std::vector<Item> items;
+};
+
+struct SearchOptions {
+    // Results kept per section, 0 for all. Parsing a section stops as soon
+    // as it has this many; the rest of it is skipped unparsed.
+    std::size_t maxPerSection = 0;
+    // Responses at least this large get one thread per section (multi-core hosts only)
+    std::size_t parallelThreshold = 64 * 1024;
+};
+
+// --- DOWNLOADS ---
+
+struct DownloadOptions {
+    // Bytes per HTTP range request
+    std::size_t chunkSize = 8 * 1024 * 1024;
+    // Parallel connections, used when the server honours range requests
+    std::size_t connections = 4;
+    // Lowercase hex SHA-256 the finished file must match
+    std::optional<std::string> expectedSha256;
+    // Receives (bytes done, total bytes or 0 when unknown); return false to
+    // cancel. Called from the download threads, one call at a time.
+    std::function<bool(std::uint64_t, std::uint64_t)> onProgress;
+};
+
+struct DownloadResult {
+    bool success = false;
+    std::string message;
+    std::uint64_t bytes = 0;
+    // Bytes kept from an interrupted earlier attempt
+    std::uint64_t resumedBytes = 0;
+    // Lowercase hex SHA-256 of the file
+    std::string sha256;
+};
+
+namespace detail {
+
+// SHA-256 (FIPS 180-4), fed incrementally while a download is running
+class Sha256 {
+public:
+    void update(const char* data, std::size_t size);
+    // Pads the message; call once, after the last update()
+    std::string hexDigest();
+
+private:
+    void compress();
+
+    std::uint32_t state[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                              0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    unsigned char block[64] = {};
+    std::size_t used = 0;
+    std::uint64_t length = 0;
+};
+
+} // namespace detail
+
+// --- ROUTES ---
+
+namespace detail {
+
+// Appends `text` to `out`, percent-encoding everything but the RFC 3986
+// unreserved characters
+void percentEncode(std::string_view text, std::string& out);
+
+// Endpoint template with N "{}" placeholders, split into literal segments at
+// compile time. Expansion percent-encodes string parameters, formats integers
+// in place and sizes the result with a single allocation.
+template <std::size_t N>
+class Route {
+public:
+    constexpr explicit Route(std::string_view pattern) : segments{} {
+        std::size_t count = 0;
+        std::size_t start = 0;
+        for (std::size_t i = 0; i + 1 < pattern.size(); ++i) {
+            if (pattern[i] == '{' && pattern[i + 1] == '}') {
+                if (count == N) throw std::logic_error("Route has more placeholders than parameters");
+                segments[count++] = pattern.substr(start, i - start);
+                start = ++i + 1;
+            }
+        }
+        if (count != N) throw std::logic_error("Route has fewer placeholders than parameters");
+        segments[N] = pattern.substr(start);
+    }
+
+    // Literal text before placeholder i (i == N: after the last one)
+    constexpr std::string_view segment(std::size_t i) const { return segments[i]; }
+
+    template <typename... Params>
+    std::string expand(const Params&... params) const {
+        static_assert(sizeof...(Params) == N, "Route expects N parameters");
+        std::size_t capacity = 0;
+        for (auto segment : segments) capacity += segment.size();
+        ((capacity += maxLength(params)), ...);
+
+        std::string out;
+        out.reserve(capacity);
+        std::size_t i = 0;
+        ((out.append(segments[i++]), append(out, params)), ...);
+        out.append(segments[N]);
+        return out;
+    }
+
+private:
+    static std::size_t maxLength(std::string_view text) { return text.size() * 3; }
+    static std::size_t maxLength(int) { return 11; }
+    static void append(std::string& out, std::string_view text) { percentEncode(text, out); }
+    static void append(std::string& out, int number) {
+        char digits[12];
+        out.append(digits, std::to_chars(digits, digits + sizeof(digits), number).ptr);
+    }
+
+    std::array<std::string_view, N + 1> segments;
+};
+
+namespace routes {
+
+inline constexpr Route<1> user{"/users/{}"};
+inline constexpr Route<1> userSearch{"/users/search?q={}"};
+inline constexpr Route<1> game{"/games/{}"};
+inline constexpr Route<1> gameBuy{"/games/{}/buy"};
+inline constexpr Route<1> gameDownload{"/games/{}/download"};
+inline constexpr Route<1> gameSearch{"/games/search?q={}"};
+inline constexpr Route<1> gameView{"/game-views/games/{}/view"};
+inline constexpr Route<1> inventory{"/inventory/{}"};
+inline constexpr Route<1> item{"/items/{}"};
+inline constexpr Route<1> itemSearch{"/items/search?q={}"};
+inline constexpr Route<1> itemUpdate{"/items/update/{}"};
+inline constexpr Route<1> itemDelete{"/items/delete/{}"};
+inline constexpr Route<1> itemBuy{"/items/buy/{}"};
+inline constexpr Route<1> itemSell{"/items/sell/{}"};
+inline constexpr Route<1> itemGive{"/items/give/{}"};
+inline constexpr Route<1> itemConsume{"/items/consume/{}"};
+inline constexpr Route<1> itemUpdateMetadata{"/items/update-metadata/{}"};
+inline constexpr Route<1> itemDrop{"/items/drop/{}"};
+inline constexpr Route<1> lobby{"/lobbies/{}"};
+inline constexpr Route<1> userLobby{"/lobbies/user/{}"};
+inline constexpr Route<1> lobbyJoin{"/lobbies/{}/join"};
+inline constexpr Route<1> lobbyLeave{"/lobbies/{}/leave"};
+inline constexpr Route<1> studio{"/studios/{}"};
+inline constexpr Route<1> studioAddUser{"/studios/{}/add-user"};
+inline constexpr Route<1> studioRemoveUser{"/studios/{}/remove-user"};
+inline constexpr Route<1> tradeStartOrLatest{"/trades/start-or-latest/{}"};
+inline constexpr Route<1> trade{"/trades/{}"};
+inline constexpr Route<1> userTrades{"/trades/user/{}"};
+inline constexpr Route<1> tradeAddItem{"/trades/{}/add-item"};
+inline constexpr Route<1> tradeRemoveItem{"/trades/{}/remove-item"};
+inline constexpr Route<1> tradeApprove{"/trades/{}/approve"};
+inline constexpr Route<1> tradeCancel{"/trades/{}/cancel"};
+inline constexpr Route<1> oauth2App{"/oauth2/app/{}"};
+inline constexpr Route<2> oauth2Authorize{"/oauth2/authorize?client_id={}&redirect_uri={}"};
+inline constexpr Route<2> oauth2User{"/oauth2/user?code={}&client_id={}"};
+inline constexpr Route<2> marketListings{"/market-listings?limit={}&offset={}"};
+inline constexpr Route<2> marketSearch{"/market-listings/search?q={}&limit={}"};
+inline constexpr Route<1> marketListing{"/market-listings/{}"};
+inline constexpr Route<1> marketItem{"/market-listings/item/{}"};
+inline constexpr Route<1> marketUser{"/market-listings/user/{}"};
+inline constexpr Route<1> marketCancel{"/market-listings/{}/cancel"};
+inline constexpr Route<1> marketBuy{"/market-listings/{}/buy"};
+inline constexpr Route<1> buyOrderCancel{"/buy-orders/{}/cancel"};
+inline constexpr Route<1> buyOrdersItem{"/buy-orders/item/{}"};
+inline constexpr Route<1> buyOrdersUser{"/buy-orders/user/{}"};
+inline constexpr Route<1> search{"/search?q={}"};
+inline constexpr Route<1> itemIcon{"/items-icons/{}"};
+inline constexpr Route<1> gameIcon{"/games-icons/{}"};
+inline constexpr Route<1> banner{"/banners-icons/{}"};
+
+} // namespace routes
+
+} // namespace detail
+
+// Main API client class
+class Client {
+private:
+    std::string token;
+    std::string base_url = "https://croissant-api.fr/api";
+    bool acceptCompression = true;
+    std::size_t requestCompressionThreshold = 0;
+    WireFormat wireFormat = WireFormat::Json;
+    // Set once the server has answered in the binary wire format, so request
+    // bodies can be sent in it too.
+    mutable std::atomic<bool> binaryBodiesAccepted{false};
+    // Content-Type and Authorization, rebuilt only when the token changes;
+    // the negotiated set adds Accept for the binary wire format.
+    cpr::Header jsonHeaders;
+    cpr::Header negotiatedHeaders;
+    
+    // Internal helper methods
+    APIResponse makeRequest(const std::string& method, const std::string& endpoint, 
+                           const json& body = json::object(), bool requireAuth = false) const;
+    // Sends a body that was already serialized as JSON (see detail::JsonWriter)
+    APIResponse makeRawRequest(const std::string& method, const std::string& endpoint,
+                               std::string_view body, bool requireAuth = false) const;
+    // Exception-free request: the decoded body on 2xx, a typed Error otherwise
+    Result<json> exchange(const std::string& method, const std::string& endpoint,
+                          std::string_view body = {}, bool requireAuth = false) const;
+    bool sendRaw(const std::string& method, const std::string& endpoint, std::string_view body,
+                 cpr::Response& response) const;
+    // Streams the response body and hands each element of the array found under
+    // `arrayKey` (or of the root array when empty) to `onElement` as raw JSON
+    // text while the download is still running. The returned APIResponse holds
+    // the rest of the document, with the streamed array left empty.
+    APIResponse makeStreamingRequest(const std::string& method, const std::string& endpoint,
+                                     const std::string& arrayKey,
+                                     const std::function<bool(std::string_view)>& onElement,
+                                     bool requireAuth = false) const;
+    // Fetches a JSON array response and keeps its body for lazy views
+    template <typename V>
+    ListView<V> fetchListView(const std::string& endpoint, bool requireAuth = false) const {
+        auto body = fetchBody(endpoint, requireAuth);
+        if (!body) {
+            return ListView<V>();
+        }
+        auto elements = detail::arrayElements(body->text);
+        return ListView<V>(std::move(body), std::move(elements));
+    }
+    // Raw JSON body of a successful GET, or nullptr
+    std::shared_ptr<const ResponseBody> fetchBody(const std::string& endpoint, bool requireAuth) const;
+    // Streams an inventory response straight into the columns of `table`
+    APIResponse loadInventory(const std::string& endpoint, const std::string& userId,
+                              InventoryTable& table, bool requireAuth) const;
+    // Streams a list response, decoding each element as T; a malformed
+    // element ends the request with a failed APIResponse
+    template <typename T, typename F>
+    APIResponse streamObjects(const std::string& endpoint, const std::string& arrayKey, F&& onObject,
+                              bool requireAuth = false) const;
+    // Streams a list response and parses only the fields of projection P
+    template <typename P>
+    APIResponse collectProjected(const std::string& endpoint, const std::string& arrayKey,
+                                 std::vector<P>& out, bool requireAuth = false) const;
+    void prepareHeaders();
+    const cpr::Header& preparedHeaders(bool negotiate = false) const {
+        return negotiate ? negotiatedHeaders : jsonHeaders;
+    }
+    cpr::AcceptEncoding acceptEncoding() const;
+    // Serializes a request body in the negotiated wire format, gzip-compressing
+    // it (and flagging it in `headers`) when it is larger than the configured threshold.
+    std::string encodeBody(const json& body, cpr::Header& headers, bool binary) const;
+    static APIResponse buildResponse(long statusCode, const std::string& text,
+                                     const std::string& contentType = "");
+    std::string urlEncode(const std::string& str) const;
+
+public:
+    // Token management
+    void setToken(const std::string& newToken) {
+        token = newToken;
+        prepareHeaders();
+    }
+    std::string getToken() const { return token; }
+
+    // API root, e.g. a staging deployment or a local stand-in. Helpers that
+    // keep their own copy (watchers, queues, push clients) read it when they
+    // are created.
+    void setBaseUrl(const std::string& url) { base_url = url; }
+    const std::string& getBaseUrl() const { return base_url; }
+
+    // Transfer compression
+    // Advertise gzip/deflate (plus brotli and zstd when libcurl supports them)
+    // and decompress responses on the fly. Enabled by default.
+    void setAcceptCompression(bool enabled) { acceptCompression = enabled; }
+    // Gzip request bodies of at least `bytes` bytes; 0 (the default) never compresses.
+    void setRequestCompressionThreshold(std::size_t bytes) { requestCompressionThreshold = bytes; }
+
+    // Wire format
+    // Ask for MessagePack or CBOR responses (JSON stays acceptable). Request
+    // bodies switch to the binary format once the server has replied with it.
+    // Streaming list calls always use JSON.
+    void setWireFormat(WireFormat format) {
+        wireFormat = format;
+        binaryBodiesAccepted = false;
+        prepareHeaders();
+    }
+    WireFormat getWireFormat() const { return wireFormat; }
+
+    // --- USERS NAMESPACE ---
+    struct Users {
+        const Client& client;
+        explicit Users(const Client& c) : client(c) {}
+
+        /**
+         * Get the authenticated user's profile.
+         * @returns The current user object or nullopt if failed.
+         * @throws std::runtime_error if no token is set.
+         */
+        std::optional<User> getMe() const;
+
+        /**
+         * Search users by username or other criteria.
+         * @param query The search string.
+         * @returns Vector of matching users.
+         */
+        std::vector<User> search(const std::string& query) const;
+
+        /**
+         * Search users, returning lazy views over the response body.
+         * @param query The search string.
+         * @returns List of user views.
+         */
+        ListView<UserView> searchView(const std::string& query) const;
+
+        /**
+         * Get a user by their userId.
+         * @param userId The user's ID.
+         * @returns The user object or nullopt if not found.
+         */
+        std::optional<User> getUser(const std::string& userId) const;
+
+        /**
+         * Transfer credits to another user.
+         * @param targetUserId The recipient's user ID.
+         * @param amount The amount to transfer.
+         * @returns APIResponse with message about the transfer.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse transferCredits(const std::string& targetUserId, double amount) const;
+
+        /**
+         * Verify a user with a verification key.
+         * @param userId The user ID to verify.
+         * @param verificationKey The verification key.
+         * @returns APIResponse with success status.
+         */
+        APIResponse verify(const std::string& userId, const std::string& verificationKey) const;
+
+        /**
+         * Change username of authenticated user.
+         * @param username The new username.
+         * @returns APIResponse with result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse changeUsername(const std::string& username) const;
+
+        /**
+         * Change password of authenticated user.
+         * @param oldPassword Current password.
+         * @param newPassword New password.
+         * @param confirmPassword Confirmation of new password.
+         * @returns APIResponse with result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse changePassword(const std::string& oldPassword, 
+                                 const std::string& newPassword, 
+                                 const std::string& confirmPassword) const;
+
+        /**
+         * Exception-free getMe().
+         * @returns The current user, or an Auth error when no token is set.
+         */
+        Result<User> tryGetMe() const;
+
+        /**
+         * Exception-free getUser().
+         * @param userId The user's ID.
+         * @returns The user, or an Error describing the failure.
+         */
+        Result<User> tryGetUser(const std::string& userId) const;
+    } users;
+
+    // --- GAMES NAMESPACE ---
+    struct Games {
+        const Client& client;
+        explicit Games(const Client& c) : client(c) {}
+
+        /**
+         * List all games visible in the store.
+         * @returns Vector of games.
+         */
+        std::vector<Game> list() const;
+
+        /**
+         * Search for games by name, genre, or description.
+         * @param query The search string.
+         * @returns Vector of matching games.
+         */
+        std::vector<Game> search(const std::string& query) const;
+
+        /**
+         * Stream all games visible in the store, one at a time as they arrive.
+         * @param onGame Called for each game; return false to stop early.
+         * @returns APIResponse with the request status.
+         */
+        APIResponse listStream(const StreamCallback<Game>& onGame) const;
+
+        /**
+         * Stream games matching a search, one at a time as they arrive.
+         * @param query The search string.
+         * @param onGame Called for each game; return false to stop early.
+         * @returns APIResponse with the request status.
+         */
+        APIResponse searchStream(const std::string& query, const StreamCallback<Game>& onGame) const;
+
+        /**
+         * List store games as lazy views over the response body.
+         * @returns List of game views.
+         */
+        ListView<GameView> listView() const;
+
+        /**
+         * Search games, returning lazy views over the response body.
+         * @param query The search string.
+         * @returns List of game views.
+         */
+        ListView<GameView> searchView(const std::string& query) const;
+
+        /**
+         * List store games, parsing only the fields of projection P.
+         * @returns Vector of projected games.
+         */
+        template <typename P>
+        std::vector<P> listAs() const {
+            std::vector<P> games;
+            client.collectProjected("/games", "", games);
+            return games;
+        }
+
+        /**
+         * Search games, parsing only the fields of projection P.
+         * @param query The search string.
+         * @returns Vector of projected games.
+         */
+        template <typename P>
+        std::vector<P> searchAs(const std::string& query) const {
+            std::vector<P> games;
+            client.collectProjected(detail::routes::gameSearch.expand(query), "", games);
+            return games;
+        }
+
+        /**
+         * Get all games created by the authenticated user.
+         * @returns Vector of games created by the user.
+         * @throws std::runtime_error if not authenticated.
+         */
+        std::vector<Game> getMyCreatedGames() const;
+
+        /**
+         * Get all games owned by the authenticated user.
+         * @returns Vector of games owned by the user.
+         * @throws std::runtime_error if not authenticated.
+         */
+        std::vector<Game> getMyOwnedGames() const;
+
+        /**
+         * Get a game by its ID.
+         * @param gameId The game ID.
+         * @returns The game object or nullopt if not found.
+         */
+        std::optional<Game> get(const std::string& gameId) const;
+
+        /**
+         * Create a new game.
+         * @param game The game data to create.
+         * @returns The created game or nullopt if failed.
+         * @throws std::runtime_error if not authenticated.
+         */
+        std::optional<Game> create(const Game& game) const;
+
+        /**
+         * Update an existing game.
+         * @param gameId The game ID to update.
+         * @param game The updated game data.
+         * @returns The updated game or nullopt if failed.
+         * @throws std::runtime_error if not authenticated.
+         */
+        std::optional<Game> update(const std::string& gameId, const Game& game) const;
+
+        /**
+         * Buy a game by its ID.
+         * @param gameId The game ID to buy.
+         * @returns APIResponse with purchase result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse buy(const std::string& gameId) const;
+
+        /**
+         * Download an owned game build straight to disk.
+         * When the server honours range requests the file is fetched in
+         * chunks over several connections and written in place; otherwise it
+         * is streamed over a single connection. Progress is kept in a
+         * "<destination>.download" file, so calling again after an
+         * interruption resumes from the chunks already on disk (after checking
+         * them against their recorded CRC-32). The SHA-256 of the file is
+         * computed while the download runs.
+         * @param gameId The game ID.
+         * @param destination File to write.
+         * @param options Chunking, parallelism, checksum and progress settings.
+         * @returns DownloadResult with the outcome and the file's SHA-256.
+         * @throws std::runtime_error if not authenticated.
+         */
+        DownloadResult download(const std::string& gameId, const std::filesystem::path& destination,
+                                const DownloadOptions& options = {}) const;
+
+        /**
+         * Exception-free list().
+         * @returns All games, or an Error describing the failure.
+         */
+        Result<std::vector<Game>> tryList() const;
+
+        /**
+         * Exception-free get().
+         * @param gameId The game ID.
+         * @returns The game, or an Error describing the failure.
+         */
+        Result<Game> tryGet(const std::string& gameId) const;
+
+        /**
+         * Exception-free buy().
+         * @param gameId The game ID.
+         * @returns Response data, or an Error describing the failure.
+         */
+        Result<json> tryBuy(const std::string& gameId) const;
+    } games;
+
+    // --- INVENTORY NAMESPACE ---
+    struct Inventory {
+        const Client& client;
+        explicit Inventory(const Client& c) : client(c) {}
+
+        /**
+         * Get the inventory of the authenticated user.
+         * @returns Pair of user_id and inventory items.
+         * @throws std::runtime_error if not authenticated.
+         */
+        std::pair<std::string, std::vector<InventoryItem>> getMyInventory() const;
+
+        /**
+         * Get the inventory of a user by userId.
+         * @param userId The user ID.
+         * @returns Pair of user_id and inventory items.
+         */
+        std::pair<std::string, std::vector<InventoryItem>> get(const std::string& userId) const;
+
+        /**
+         * Stream the inventory of the authenticated user, one item at a time as it arrives.
+         * @param onItem Called for each inventory item; return false to stop early.
+         * @returns APIResponse whose data holds the user_id.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse getMyInventoryStream(const StreamCallback<InventoryItem>& onItem) const;
+
+        /**
+         * Stream the inventory of a user by userId, one item at a time as it arrives.
+         * @param userId The user ID.
+         * @param onItem Called for each inventory item; return false to stop early.
+         * @returns APIResponse whose data holds the user_id.
+         */
+        APIResponse getStream(const std::string& userId, const StreamCallback<InventoryItem>& onItem) const;
+
+        /**
+         * Get a user's inventory as a column-oriented table.
+         * @param userId The user ID.
+         * @returns InventoryTable filled from the response.
+         */
+        InventoryTable getTable(const std::string& userId) const;
+
+        /**
+         * Get the authenticated user's inventory as a column-oriented table.
+         * @returns InventoryTable filled from the response.
+         * @throws std::runtime_error if not authenticated.
+         */
+        InventoryTable getMyInventoryTable() const;
+
+        /**
+         * Append a user's inventory to an existing table, e.g. to aggregate many players.
+         * @param userId The user ID.
+         * @param table The table to append rows to.
+         * @returns APIResponse with the request status.
+         */
+        APIResponse loadInto(const std::string& userId, InventoryTable& table) const;
+
+        /**
+         * Get the authenticated user's inventory, parsing only the fields of projection P.
+         * @returns Pair of user_id and projected inventory items.
+         * @throws std::runtime_error if not authenticated.
+         */
+        template <typename P>
+        std::pair<std::string, std::vector<P>> getMyInventoryAs() const {
+            if (client.token.empty()) {
+                throw std::runtime_error("Token is required");
+            }
+            std::vector<P> inventory;
+            auto response = client.collectProjected("/inventory/@me", "inventory", inventory, true);
+            return std::make_pair(response.data.value("user_id", ""), std::move(inventory));
+        }
+
+        /**
+         * Get a user's inventory, parsing only the fields of projection P.
+         * @param userId The user ID.
+         * @returns Pair of user_id and projected inventory items.
+         */
+        template <typename P>
+        std::pair<std::string, std::vector<P>> getAs(const std::string& userId) const {
+            std::vector<P> inventory;
+            auto response = client.collectProjected(detail::routes::inventory.expand(userId), "inventory", inventory);
+            return std::make_pair(response.data.value("user_id", ""), std::move(inventory));
+        }
+
+        /**
+         * Exception-free getMyInventory().
+         * @returns Pair of user_id and inventory items, or an Error describing the failure.
+         */
+        Result<std::pair<std::string, std::vector<InventoryItem>>> tryGetMyInventory() const;
+
+        /**
+         * Exception-free get().
+         * @param userId The user ID.
+         * @returns Pair of user_id and inventory items, or an Error describing the failure.
+         */
+        Result<std::pair<std::string, std::vector<InventoryItem>>> tryGet(const std::string& userId) const;
+    } inventory;
+
+    // --- ITEMS NAMESPACE ---
+    struct Items {
+        const Client& client;
+        explicit Items(const Client& c) : client(c) {}
+
+        /**
+         * List all non-deleted items visible in the store.
+         * @returns Vector of items.
+         */
+        std::vector<Item> list() const;
+
+        /**
+         * Stream all non-deleted store items, one at a time as they arrive.
+         * @param onItem Called for each item; return false to stop early.
+         * @returns APIResponse with the request status.
+         */
+        APIResponse listStream(const StreamCallback<Item>& onItem) const;
+
+        /**
+         * List store items as lazy views over the response body.
+         * @returns List of item views.
+         */
+        ListView<ItemView> listView() const;
+
+        /**
+         * Search items, returning lazy views over the response body.
+         * @param query The search string.
+         * @returns List of item views.
+         */
+        ListView<ItemView> searchView(const std::string& query) const;
+
+        /**
+         * List store items, parsing only the fields of projection P.
+         * @returns Vector of projected items.
+         */
+        template <typename P>
+        std::vector<P> listAs() const {
+            std::vector<P> items;
+            client.collectProjected("/items", "", items);
+            return items;
+        }
+
+        /**
+         * Search items, parsing only the fields of projection P.
+         * @param query The search string.
+         * @returns Vector of projected items.
+         */
+        template <typename P>
+        std::vector<P> searchAs(const std::string& query) const {
+            std::vector<P> items;
+            client.collectProjected(detail::routes::itemSearch.expand(query), "", items);
+            return items;
+        }
+
+        /**
+         * Get all items owned by the authenticated user.
+         * @returns Vector of items owned by the user.
+         * @throws std::runtime_error if not authenticated.
+         */
+        std::vector<Item> getMyItems() const;
+
+        /**
+         * Search for items by name (only those visible in store).
+         * @param query The search string.
+         * @returns Vector of matching items.
+         */
+        std::vector<Item> search(const std::string& query) const;
+
+        /**
+         * Get a single item by itemId.
+         * @param itemId The item ID.
+         * @returns The item object or nullopt if not found.
+         */
+        std::optional<Item> get(const std::string& itemId) const;
+
+        /**
+         * Create a new item.
+         * @param name Item name.
+         * @param description Item description.
+         * @param price Item price.
+         * @param iconHash Optional icon hash.
+         * @param showInStore Whether to show in store.
+         * @returns APIResponse with creation result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse create(const std::string& name, const std::string& description, 
+                          double price, const std::string& iconHash = "", 
+                          bool showInStore = true) const;
+
+        /**
+         * Update an existing item.
+         * @param itemId The item ID.
+         * @param item The updated item data.
+         * @returns APIResponse with update result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse update(const std::string& itemId, const Item& item) const;
+
+        /**
+         * Delete an item by its ID.
+         * @param itemId The item ID.
+         * @returns APIResponse with deletion result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse deleteItem(const std::string& itemId) const;
+
+        /**
          * Buy an item by its ID.
          * @param itemId The item ID.
-         * @param amount The amount to buy.
-         * @returns APIResponse with purchase result.
+         * @param amount The amount to buy.
+         * @returns APIResponse with purchase result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse buy(const std::string& itemId, int amount) const;
+
+        /**
+         * Sell an item by its ID.
+         * @param itemId The item ID.
+         * @param amount The amount to sell.
+         * @returns APIResponse with sale result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse sell(const std::string& itemId, int amount) const;
+
+        /**
+         * Give an item to a user.
+         * @param itemId The item ID.
+         * @param amount The amount to give.
+         * @param userId The recipient's user ID.
+         * @param metadata Optional metadata for the item instance.
+         * @returns APIResponse with operation result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse give(const std::string& itemId, int amount, const std::string& userId,
+                        const std::optional<Metadata>& metadata = std::nullopt) const;
+
+        /**
+         * Consume an item instance.
+         * @param itemId The item ID.
+         * @param userId The user ID.
+         * @param amount Optional amount (if not specified, uniqueId must be provided).
+         * @param uniqueId Optional unique instance ID.
+         * @returns APIResponse with operation result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse consume(const std::string& itemId, const std::string& userId,
+                           const std::optional<int>& amount = std::nullopt,
+                           const std::optional<std::string>& uniqueId = std::nullopt) const;
+
+        /**
+         * Update metadata for an item instance.
+         * @param itemId The item ID.
+         * @param uniqueId The unique instance ID.
+         * @param metadata The new metadata.
+         * @returns APIResponse with update result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse updateMetadata(const std::string& itemId, const std::string& uniqueId,
+                                  const Metadata& metadata) const;
+
+        /**
+         * Drop an item instance from the user's inventory.
+         * @param itemId The item ID.
+         * @param amount Optional amount (if not specified, uniqueId must be provided).
+         * @param uniqueId Optional unique instance ID.
+         * @returns APIResponse with operation result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse drop(const std::string& itemId,
+                        const std::optional<int>& amount = std::nullopt,
+                        const std::optional<std::string>& uniqueId = std::nullopt) const;
+
+        /**
+         * Exception-free list().
+         * @returns All items, or an Error describing the failure.
+         */
+        Result<std::vector<Item>> tryList() const;
+
+        /**
+         * Exception-free get().
+         * @param itemId The item ID.
+         * @returns The item, or an Error describing the failure.
+         */
+        Result<Item> tryGet(const std::string& itemId) const;
+
+        /**
+         * Exception-free buy().
+         * @returns Response data, or an Error describing the failure.
+         */
+        Result<json> tryBuy(const std::string& itemId, int amount) const;
+
+        /**
+         * Exception-free sell().
+         * @returns Response data, or an Error describing the failure.
+         */
+        Result<json> trySell(const std::string& itemId, int amount) const;
+
+        /**
+         * Exception-free give().
+         * @returns Response data, or an Error describing the failure.
+         */
+        Result<json> tryGive(const std::string& itemId, int amount, const std::string& userId,
+                             const std::optional<Metadata>& metadata = std::nullopt) const;
+
+        /**
+         * Exception-free consume().
+         * @returns Response data, or an Error describing the failure.
+         */
+        Result<json> tryConsume(const std::string& itemId, const std::string& userId,
+                                const std::optional<int>& amount = std::nullopt,
+                                const std::optional<std::string>& uniqueId = std::nullopt) const;
+
+        /**
+         * Exception-free drop().
+         * @returns Response data, or an Error describing the failure.
+         */
+        Result<json> tryDrop(const std::string& itemId,
+                             const std::optional<int>& amount = std::nullopt,
+                             const std::optional<std::string>& uniqueId = std::nullopt) const;
+    } items;
+
+    // --- LOBBIES NAMESPACE ---
+    struct Lobbies {
+        const Client& client;
+        explicit Lobbies(const Client& c) : client(c) {}
+
+        /**
+         * Create a new lobby for the authenticated user.
+         * @returns APIResponse with creation result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse create() const;
+
+        /**
+         * Get a lobby by its ID.
+         * @param lobbyId The lobby ID.
+         * @returns The lobby object or nullopt if not found.
+         */
+        std::optional<Lobby> get(const std::string& lobbyId) const;
+
+        /**
+         * Get the lobby the authenticated user is in.
+         * @returns The lobby object or nullopt if not in a lobby.
+         * @throws std::runtime_error if not authenticated.
+         */
+        std::optional<Lobby> getMyLobby() const;
+
+        /**
+         * Get the lobby a user is in by userId.
+         * @param userId The user ID.
+         * @returns The lobby object or nullopt if user not in a lobby.
+         */
+        std::optional<Lobby> getUserLobby(const std::string& userId) const;
+
+        /**
+         * Join a lobby by its ID.
+         * @param lobbyId The lobby ID.
+         * @returns APIResponse with join result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse join(const std::string& lobbyId) const;
+
+        /**
+         * Leave a lobby by its ID.
+         * @param lobbyId The lobby ID.
+         * @returns APIResponse with leave result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse leave(const std::string& lobbyId) const;
+    } lobbies;
+
+    // --- STUDIOS NAMESPACE ---
+    struct Studios {
+        const Client& client;
+        explicit Studios(const Client& c) : client(c) {}
+
+        /**
+         * Create a new studio.
+         * @param studioName The name of the studio.
+         * @returns APIResponse with creation result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse create(const std::string& studioName) const;
+
+        /**
+         * Get a studio by its ID.
+         * @param studioId The studio ID.
+         * @returns The studio object or nullopt if not found.
+         */
+        std::optional<Studio> get(const std::string& studioId) const;
+
+        /**
+         * Get all studios the authenticated user is a member of.
+         * @returns Vector of studios.
+         * @throws std::runtime_error if not authenticated.
+         */
+        std::vector<Studio> getMyStudios() const;
+
+        /**
+         * Add a user to a studio.
+         * @param studioId The studio ID.
+         * @param userId The user ID to add.
+         * @returns APIResponse with operation result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse addUser(const std::string& studioId, const std::string& userId) const;
+
+        /**
+         * Remove a user from a studio.
+         * @param studioId The studio ID.
+         * @param userId The user ID to remove.
+         * @returns APIResponse with operation result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse removeUser(const std::string& studioId, const std::string& userId) const;
+    } studios;
+
+    // --- TRADES NAMESPACE ---
+    struct Trades {
+        const Client& client;
+        explicit Trades(const Client& c) : client(c) {}
+
+        /**
+         * Start a new trade or get the latest pending trade with a user.
+         * @param userId The user ID to trade with.
+         * @returns The trade object or nullopt if failed.
+         * @throws std::runtime_error if not authenticated.
+         */
+        std::optional<Trade> startOrGetPending(const std::string& userId) const;
+
+        /**
+         * Get a trade by its ID.
+         * @param tradeId The trade ID.
+         * @returns The trade object or nullopt if not found.
+         * @throws std::runtime_error if not authenticated.
+         */
+        std::optional<Trade> get(const std::string& tradeId) const;
+
+        /**
+         * Get all trades for a user.
+         * @param userId The user ID.
+         * @returns Vector of trades.
+         * @throws std::runtime_error if not authenticated.
+         */
+        std::vector<Trade> getUserTrades(const std::string& userId) const;
+
+        /**
+         * Get all trades for a user, parsing only the fields of projection P.
+         * @param userId The user ID.
+         * @returns Vector of projected trades.
+         * @throws std::runtime_error if not authenticated.
+         */
+        template <typename P>
+        std::vector<P> getUserTradesAs(const std::string& userId) const {
+            if (client.token.empty()) {
+                throw std::runtime_error("Token is required");
+            }
+            std::vector<P> trades;
+            client.collectProjected(detail::routes::userTrades.expand(userId), "", trades, true);
+            return trades;
+        }
+
+        /**
+         * Add an item to a trade.
+         * @param tradeId The trade ID.
+         * @param tradeItem The item to add.
+         * @returns APIResponse with operation result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse addItem(const std::string& tradeId, const TradeItem& tradeItem) const;
+
+        /**
+         * Remove an item from a trade.
+         * @param tradeId The trade ID.
+         * @param tradeItem The item to remove.
+         * @returns APIResponse with operation result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse removeItem(const std::string& tradeId, const TradeItem& tradeItem) const;
+
+        /**
+         * Approve a trade.
+         * @param tradeId The trade ID.
+         * @returns APIResponse with operation result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse approve(const std::string& tradeId) const;
+
+        /**
+         * Cancel a trade.
+         * @param tradeId The trade ID.
+         * @returns APIResponse with operation result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse cancel(const std::string& tradeId) const;
+
+        /**
+         * Exception-free get().
+         * @param tradeId The trade ID.
+         * @returns The trade, or an Error describing the failure.
+         */
+        Result<Trade> tryGet(const std::string& tradeId) const;
+
+        /**
+         * Exception-free addItem().
+         * @returns Response data, or an Error describing the failure.
+         */
+        Result<json> tryAddItem(const std::string& tradeId, const TradeItem& tradeItem) const;
+
+        /**
+         * Exception-free removeItem().
+         * @returns Response data, or an Error describing the failure.
+         */
+        Result<json> tryRemoveItem(const std::string& tradeId, const TradeItem& tradeItem) const;
+
+        /**
+         * Exception-free approve().
+         * @returns Response data, or an Error describing the failure.
+         */
+        Result<json> tryApprove(const std::string& tradeId) const;
+    } trades;
+
+    // --- OAUTH2 NAMESPACE ---
+    struct OAuth2 {
+        const Client& client;
+        explicit OAuth2(const Client& c) : client(c) {}
+
+        /**
+         * Get an OAuth2 app by its client ID.
+         * @param client_id The client ID.
+         * @returns The OAuth2 app object or nullopt if not found.
+         */
+        std::optional<OAuth2App> getApp(const std::string& client_id) const;
+
+        /**
+         * Create a new OAuth2 app.
+         * @param name The app name.
+         * @param redirect_urls The allowed redirect URLs.
+         * @returns Pair of client_id and client_secret or nullopt if failed.
+         * @throws std::runtime_error if not authenticated.
+         */
+        std::optional<std::pair<std::string, std::string>> createApp(const std::string& name, 
+                                                                    const std::vector<std::string>& redirect_urls) const;
+
+        /**
+         * Get all OAuth2 apps owned by the authenticated user.
+         * @returns Vector of OAuth2 apps.
+         * @throws std::runtime_error if not authenticated.
+         */
+        std::vector<OAuth2App> getMyApps() const;
+
+        /**
+         * Update an OAuth2 app.
+         * @param client_id The client ID.
+         * @param name Optional new name.
+         * @param redirect_urls Optional new redirect URLs.
+         * @returns APIResponse with update result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse updateApp(const std::string& client_id,
+                             const std::optional<std::string>& name = std::nullopt,
+                             const std::optional<std::vector<std::string>>& redirect_urls = std::nullopt) const;
+
+        /**
+         * Delete an OAuth2 app by its client ID.
+         * @param client_id The client ID.
+         * @returns APIResponse with deletion result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse deleteApp(const std::string& client_id) const;
+
+        /**
+         * Authorize a user for an OAuth2 app.
+         * @param client_id The client ID.
+         * @param redirect_uri The redirect URI.
+         * @returns The authorization code or empty string if failed.
+         * @throws std::runtime_error if not authenticated.
+         */
+        std::string authorize(const std::string& client_id, const std::string& redirect_uri) const;
+
+        /**
+         * Get a user by OAuth2 code and client ID.
+         * @param code The authorization code.
+         * @param client_id The client ID.
+         * @returns The user object or nullopt if failed.
+         */
+        std::optional<User> getUserByCode(const std::string& code, const std::string& client_id) const;
+    } oauth2;
+
+    // --- MARKET NAMESPACE ---
+    struct Market {
+        const Client& client;
+        explicit Market(const Client& c) : client(c) {}
+
+        /**
+         * List active market listings with item details.
+         * @param limit Maximum number of listings.
+         * @param offset Number of listings to skip.
+         * @returns Vector of listings.
+         */
+        std::vector<MarketListing> list(int limit = 50, int offset = 0) const;
+
+        /**
+         * Search active market listings by item name.
+         * @param query The search string.
+         * @param limit Maximum number of listings.
+         * @returns Vector of matching listings.
+         */
+        std::vector<MarketListing> search(const std::string& query, int limit = 50) const;
+
+        /**
+         * Get a market listing by its ID, whatever its status.
+         * @param listingId The listing ID.
+         * @returns The listing or nullopt if not found.
+         */
+        std::optional<MarketListing> get(const std::string& listingId) const;
+
+        /**
+         * Get the active listings (the asks) for an item.
+         * @param itemId The item ID.
+         * @returns Vector of listings.
+         */
+        std::vector<MarketListing> getForItem(const std::string& itemId) const;
+
+        /**
+         * Get the listings of the authenticated user.
+         * @param userId The authenticated user's ID.
+         * @returns Vector of listings.
          * @throws std::runtime_error if not authenticated.
          */
-        APIResponse buy(const std::string& itemId, int amount) const;
+        std::vector<MarketListing> getByUser(const std::string& userId) const;
+
+        /**
+         * Put an inventory item up for sale. A matching buy order fills it immediately.
+         * @param inventoryItem The item to sell, as returned by the inventory endpoints.
+         * @param sellingPrice The asking price.
+         * @returns The new listing or nullopt if failed.
+         * @throws std::runtime_error if not authenticated.
+         */
+        std::optional<MarketListing> create(const InventoryItem& inventoryItem, double sellingPrice) const;
+
+        /**
+         * Cancel a listing and return the item to the seller's inventory.
+         * @param listingId The listing ID.
+         * @returns APIResponse with operation result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse cancel(const std::string& listingId) const;
+
+        /**
+         * Buy a listing.
+         * @param listingId The listing ID.
+         * @returns APIResponse holding the sold listing.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse buy(const std::string& listingId) const;
+
+        /**
+         * Exception-free getForItem().
+         * @param itemId The item ID.
+         * @returns The listings, or an Error describing the failure.
+         */
+        Result<std::vector<MarketListing>> tryGetForItem(const std::string& itemId) const;
+
+        /**
+         * Exception-free buy().
+         * @returns The sold listing, or an Error describing the failure.
+         */
+        Result<MarketListing> tryBuy(const std::string& listingId) const;
+    } market;
+
+    // --- BUY ORDERS NAMESPACE ---
+    struct BuyOrders {
+        const Client& client;
+        explicit BuyOrders(const Client& c) : client(c) {}
+
+        /**
+         * Place a buy order for an item.
+         * @param itemId The item ID.
+         * @param price The price offered, at least 1.
+         * @returns The new buy order or nullopt if failed.
+         * @throws std::runtime_error if not authenticated.
+         */
+        std::optional<BuyOrder> create(const std::string& itemId, double price) const;
+
+        /**
+         * Cancel a buy order.
+         * @param orderId The buy order ID.
+         * @returns APIResponse with operation result.
+         * @throws std::runtime_error if not authenticated.
+         */
+        APIResponse cancel(const std::string& orderId) const;
+
+        /**
+         * Get the active buy orders (the bids) for an item, best price first.
+         * @param itemId The item ID.
+         * @returns Vector of buy orders.
+         */
+        std::vector<BuyOrder> getForItem(const std::string& itemId) const;
+
+        /**
+         * Get the buy orders of the authenticated user.
+         * @param userId The authenticated user's ID.
+         * @returns Vector of buy orders.
+         * @throws std::runtime_error if not authenticated.
+         */
+        std::vector<BuyOrder> getByUser(const std::string& userId) const;
+
+        /**
+         * Exception-free getForItem().
+         * @param itemId The item ID.
+         * @returns The buy orders, or an Error describing the failure.
+         */
+        Result<std::vector<BuyOrder>> tryGetForItem(const std::string& itemId) const;
+    } buyOrders;
+
+    // Constructor initializes all namespaces
+    explicit Client(const std::string& token = "")
+        : token(token), users(*this), games(*this), inventory(*this), items(*this), 
+          lobbies(*this), studios(*this), trades(*this), oauth2(*this), market(*this), buyOrders(*this) {
+        prepareHeaders();
+    }
+
+    // --- GLOBAL SEARCH ---
+    /**
+     * Perform a global search across all content types.
+     * @param query The search string.
+     * @returns JSON object with search results.
+     */
+    json globalSearch(const std::string& query) const;
+
+    /**
+     * Global search with typed results. Sections are cut out of the raw
+     * response and parsed independently (concurrently for large responses),
+     * reading only the fields the result types declare.
+     * @param query The search string.
+     * @returns Users, games and items; empty sections if the request failed.
+     */
+    SearchResults search(const std::string& query, const SearchOptions& options = {}) const;
+
+    /**
+     * Exception-free search().
+     * @param query The search string.
+     * @returns Users, games and items, or an Error describing the failure
+     *          (ErrorCode::Parse if a section or an element is malformed).
+     */
+    Result<SearchResults> trySearch(const std::string& query, const SearchOptions& options = {}) const;
+
+private:
+    friend class AssetCache;
+    friend class MarketBuyer;
+    friend class GameViewAggregator;
+    friend class MutationQueue;
+    friend class MutationJournal;
+    friend class LobbyWatcher;
+    friend class TradeWatcher;
+    friend class PushClient;
+    friend class SearchSession;
+};
+
+template <typename T, typename F>
+APIResponse Client::streamObjects(const std::string& endpoint, const std::string& arrayKey, F&& onObject,
+                                  bool requireAuth) const {
+    bool malformed = false;
+    auto response = makeStreamingRequest("GET", endpoint, arrayKey, [&onObject, &malformed](std::string_view element) {
+        T object;
+        if (!detail::readProjected(element, object)) {
+            malformed = true;
+            return false;
+        }
+        return onObject(std::move(object));
+    }, requireAuth);
+    if (malformed) {
+        return APIResponse(false, "Malformed response body");
+    }
+    return response;
+}
+
+template <typename P>
+APIResponse Client::collectProjected(const std::string& endpoint, const std::string& arrayKey,
+                                     std::vector<P>& out, bool requireAuth) const {
+    return streamObjects<P>(endpoint, arrayKey, [&out](P&& projected) {
+        out.push_back(std::move(projected));
+        return true;
+    }, requireAuth);
+}
+
+// --- ASSET CACHE ---
+
+// Image families served by the API; each kind maps to its own route
+enum class AssetKind {
+    ItemIcon, // Item::iconHash
+    GameIcon, // Game::iconHash
+    Banner    // Game::bannerHash
+};
+
+// Read-only bytes of an asset. Cached assets are memory-mapped; the mapping
+// stays valid for as long as any copy of the Asset is alive, even if the file
+// is evicted in the meantime.
+class Asset {
+public:
+    Asset() = default;
+
+    std::string_view bytes() const { return view; }
+    const char* data() const { return view.data(); }
+    std::size_t size() const { return view.size(); }
+    bool empty() const { return view.empty(); }
+    explicit operator bool() const { return !view.empty(); }
+
+private:
+    friend class AssetCache;
+    Asset(std::shared_ptr<const void> owner, std::string_view view) : owner(std::move(owner)), view(view) {}
+
+    std::shared_ptr<const void> owner;
+    std::string_view view;
+};
+
+// Content-addressed on-disk cache for icon and banner hashes. Content behind a
+// hash never changes, so hits are served from disk without revalidation.
+// Concurrent requests for the same hash share one download, and the least
+// recently used files are evicted once the cache grows past its size cap.
+class AssetCache {
+public:
+    /**
+     * Open (or create) a cache directory. Files left by a previous run are
+     * indexed by their modification time so LRU order survives restarts.
+     * @param client Client whose base URL assets are fetched from; must outlive the cache.
+     * @param directory Cache directory.
+     * @param maxBytes Size cap for the files in the cache.
+     */
+    AssetCache(const Client& client, std::filesystem::path directory,
+               std::uint64_t maxBytes = 256ull * 1024 * 1024);
+    AssetCache(const AssetCache&) = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+
+    /**
+     * Get an asset, downloading it on a cache miss.
+     * @param kind Which route serves the hash.
+     * @param hash Content hash (iconHash / bannerHash).
+     * @returns The asset bytes, or an empty Asset if the hash is malformed or
+     * the download failed. Placeholder images the server returns for unknown
+     * hashes are handed back but not cached.
+     */
+    Asset get(AssetKind kind, const std::string& hash);
+
+    /**
+     * Start fetching an asset on a background thread.
+     * @returns Future for the asset; the cache must outlive it.
+     */
+    std::shared_future<Asset> fetch(AssetKind kind, const std::string& hash);
+
+    /**
+     * Get many assets, downloading the missing ones in parallel.
+     * @param parallelism Maximum number of concurrent downloads.
+     * @returns Assets in the order of `hashes`.
+     */
+    std::vector<Asset> getAll(AssetKind kind, const std::vector<std::string>& hashes,
+                              std::size_t parallelism = 8);
+
+    bool contains(const std::string& hash) const;
+    // Bytes currently stored on disk
+    std::uint64_t size() const;
+    std::uint64_t maxSize() const;
+    // Lowers or raises the cap, evicting immediately when needed
+    void setMaxSize(std::uint64_t bytes);
+    // Removes every cached file
+    void clear();
+
+private:
+    struct Entry {
+        std::uint64_t bytes;
+        std::list<std::string>::iterator position;
+    };
+
+    // Maps a cached file (reads it into memory where mmap is unavailable)
+    static Asset load(const std::filesystem::path& path);
+    static Asset hold(std::string bytes);
+    std::filesystem::path pathOf(const std::string& hash) const;
+    // Downloads into the cache directory; `stored` tells whether the file was kept
+    Asset download(AssetKind kind, const std::string& hash, bool& stored);
+    void insert(const std::string& hash, std::uint64_t bytes);
+    void evict(const std::string& keep);
+
+    const Client& client;
+    std::filesystem::path directory;
+    mutable std::mutex mutex;
+    std::uint64_t capacity;
+    std::uint64_t totalBytes = 0;
+    // Most recently used first
+    std::list<std::string> recency;
+    std::unordered_map<std::string, Entry> entries;
+    std::unordered_map<std::string, std::shared_future<Asset>> inflight;
+};
+
+// --- ORDER BOOK ---
+
+// The orders resting at one price, oldest first
+struct PriceLevel {
+    double price = 0;
+    std::vector<std::string> orderIds;
+
+    std::size_t size() const { return orderIds.size(); }
+};
+
+// Local order book of one item: active market listings are the asks, active
+// buy orders the bids. Each side keeps its price levels sorted, and every
+// refresh is applied as a difference against the previous one, so only the
+// orders that appeared, moved or went away touch the levels. The best prices
+// are read in O(1) and any price level is found in O(log n).
+// Not synchronized: share a book between threads only behind a lock.
+class OrderBook {
+public:
+    /**
+     * Book that refreshes itself through `client`.
+     * @param client The client to fetch with; must outlive the book.
+     * @param itemId The item ID.
+     */
+    OrderBook(const Client& client, std::string itemId);
+
+    /**
+     * Book fed only through applyListings() / applyBuyOrders().
+     * @param itemId The item ID.
+     */
+    explicit OrderBook(std::string itemId);
+
+    /**
+     * Fetch the item's active listings and buy orders and apply them.
+     * @returns false if the book has no client or either request failed; the
+     *          side that failed is left as it was.
+     */
+    bool refresh();
+
+    /**
+     * Replace the ask side with a snapshot of listings. Orders for other items
+     * or that are not active are ignored.
+     * @returns Number of orders added, repriced or removed.
+     */
+    std::size_t applyListings(const std::vector<MarketListing>& listings);
 
-        /**
-         * Sell an item by its ID.
-         * @param itemId The item ID.
-         * @param amount The amount to sell.
-         * @returns APIResponse with sale result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse sell(const std::string& itemId, int amount) const;
+    /**
+     * Replace the bid side with a snapshot of buy orders.
+     * @returns Number of orders added, repriced or removed.
+     */
+    std::size_t applyBuyOrders(const std::vector<BuyOrder>& buyOrders);
 
-        /**
-         * Give an item to a user.
-         * @param itemId The item ID.
-         * @param amount The amount to give.
-         * @param userId The recipient's user ID.
-         * @param metadata Optional metadata for the item instance.
-         * @returns APIResponse with operation result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse give(const std::string& itemId, int amount, const std::string& userId,
-                        const std::optional<std::unordered_map<std::string, json>>& metadata = std::nullopt) const;
+    /**
+     * Drop one order, e.g. a listing that was just bought.
+     * @returns false if the order was not in the book.
+     */
+    bool erase(const std::string& orderId);
 
-        /**
-         * Consume an item instance.
-         * @param itemId The item ID.
-         * @param userId The user ID.
-         * @param amount Optional amount (if not specified, uniqueId must be provided).
-         * @param uniqueId Optional unique instance ID.
-         * @returns APIResponse with operation result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse consume(const std::string& itemId, const std::string& userId,
-                           const std::optional<int>& amount = std::nullopt,
-                           const std::optional<std::string>& uniqueId = std::nullopt) const;
+    void clear();
 
-        /**
-         * Update metadata for an item instance.
-         * @param itemId The item ID.
-         * @param uniqueId The unique instance ID.
-         * @param metadata The new metadata.
-         * @returns APIResponse with update result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse updateMetadata(const std::string& itemId, const std::string& uniqueId,
-                                  const std::unordered_map<std::string, json>& metadata) const;
+    const std::string& itemId() const { return item; }
+
+    // Lowest ask / highest bid, nullptr when that side is empty
+    const PriceLevel* bestAsk() const { return asks.empty() ? nullptr : &asks.begin()->second; }
+    const PriceLevel* bestBid() const { return bids.empty() ? nullptr : &bids.begin()->second; }
+    // Best ask minus best bid, when both sides have orders
+    std::optional<double> spread() const;
+
+    // Orders resting at exactly `price`
+    std::size_t asksAt(double price) const;
+    std::size_t bidsAt(double price) const;
+
+    // The first `levels` levels of a side, best price first
+    std::vector<PriceLevel> askDepth(std::size_t levels) const;
+    std::vector<PriceLevel> bidDepth(std::size_t levels) const;
+
+    std::size_t askLevels() const { return asks.size(); }
+    std::size_t bidLevels() const { return bids.size(); }
+    std::size_t askOrders() const { return askCount; }
+    std::size_t bidOrders() const { return bidCount; }
+
+private:
+    using Asks = std::map<double, PriceLevel>;
+    using Bids = std::map<double, PriceLevel, std::greater<double>>;
+
+    struct Resting {
+        bool bid;
+        double price;
+        // Refresh that last reported the order
+        std::uint64_t generation;
+    };
+
+    template <typename Order>
+    std::size_t applySide(const std::vector<Order>& snapshot, bool bid);
+    void place(const std::string& orderId, bool bid, double price);
+    void unplace(const std::string& orderId, const Resting& resting);
+
+    const Client* client = nullptr;
+    std::string item;
+    Asks asks;
+    Bids bids;
+    std::size_t askCount = 0;
+    std::size_t bidCount = 0;
+    std::unordered_map<std::string, Resting> orders;
+    std::uint64_t generation = 0;
+};
+
+// --- MARKET BUYER ---
+
+// Where the time of one buy attempt went
+struct BuyTiming {
+    // Reconnecting first because the connection was closed or idle; zero when warm
+    std::chrono::nanoseconds connect{0};
+    // Patching the listing ID into the prepared request
+    std::chrono::nanoseconds prepare{0};
+    // Handing the request bytes to the socket
+    std::chrono::nanoseconds send{0};
+    // Request sent until the first response byte arrived
+    std::chrono::nanoseconds firstByte{0};
+    // First response byte until the response was complete
+    std::chrono::nanoseconds receive{0};
+    std::chrono::nanoseconds total{0};
+    bool reusedConnection = false;
+};
+
+struct BuyAttempt {
+    bool success = false;
+    // HTTP status, 0 when no response arrived
+    long status = 0;
+    // Raw response body (the sold listing, or the server's error); valid
+    // until the next call on the same buyer
+    std::string_view body;
+    // Static description of a transport failure, empty otherwise
+    std::string_view error;
+    BuyTiming timing;
+};
+
+// Latency-critical market purchases. The buyer keeps one dedicated HTTP/1.1
+// connection to the API host open (TLS done, TCP_NODELAY set, DNS answer
+// cached for good) and holds the complete request for
+// POST /market-listings/:id/buy pre-built, so a buy only copies the listing
+// ID into place and writes the bytes to the socket. Nothing is allocated on
+// that path; the response is read into a buffer owned by the buyer.
+// One thread at a time per buyer; use one buyer per racing thread.
+class MarketBuyer {
+public:
+    /**
+     * Create a buyer and open its connection.
+     * @param client The client whose token (as set now) and host are used.
+     * @param maxListingIdLength Longest listing ID buy() accepts.
+     * @throws std::runtime_error if no token is set.
+     */
+    explicit MarketBuyer(const Client& client, std::size_t maxListingIdLength = 64);
+    ~MarketBuyer();
+
+    MarketBuyer(const MarketBuyer&) = delete;
+    MarketBuyer& operator=(const MarketBuyer&) = delete;
+
+    /**
+     * Open the connection if needed and keep it alive with a CORS preflight
+     * request, which the server answers without touching its database. Call
+     * it more often than the idle timeout while waiting for a listing.
+     * @returns false if the connection could not be established.
+     */
+    bool warm();
+
+    /**
+     * Buy a listing over the warm connection. A connection idle for longer
+     * than the idle timeout is reopened first (see BuyTiming::connect); a
+     * request is never sent twice.
+     * @param listingId The listing ID.
+     * @returns Outcome and per-phase timings of the attempt.
+     */
+    BuyAttempt buy(std::string_view listingId);
+
+    // Connections unused for this long are reopened before a buy; keep it
+    // below the server's keep-alive timeout (5 s for Node.js). Default 4 s.
+    void setIdleTimeout(std::chrono::milliseconds timeout) { idleTimeout = timeout; }
+    // Give up on a response after this long. Default 10 s.
+    void setResponseTimeout(std::chrono::milliseconds timeout) { responseTimeout = timeout; }
+
+    bool connected() const;
+
+private:
+    struct Connection;
+
+    bool connect();
+    void disconnect();
+    bool sendAll(const char* data, std::size_t size);
+    // Reads one response into `response` and fills in status, body and the
+    // firstByte/receive timings of `attempt`
+    bool readResponse(BuyAttempt& attempt, std::chrono::steady_clock::time_point sent);
+
+    std::string origin;
+    std::chrono::milliseconds idleTimeout{4000};
+    std::chrono::milliseconds responseTimeout{10000};
+    std::unique_ptr<Connection> connection;
+    // The buy request is assembled in `request`: everything before the ID is
+    // written once, the ID goes at `idOffset` followed by `requestTail`
+    std::size_t idOffset = 0;
+    std::size_t maxIdLength;
+    std::string requestTail;
+    std::string warmRequest;
+    std::vector<char> request;
+    std::vector<char> response;
+};
+
+// --- GAME VIEW TELEMETRY ---
+
+namespace detail {
+
+// Bounded lock-free queue for many producers and one consumer (Vyukov's
+// bounded queue). Each cell carries a sequence number telling producers and
+// the consumer whose turn it is, so a push is one CAS on the tail plus two
+// stores, and a full queue is reported instead of waited on.
+template <typename T>
+class BoundedMpscQueue {
+public:
+    // `capacity` is rounded up to a power of two
+    explicit BoundedMpscQueue(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) size <<= 1;
+        mask = size - 1;
+        cells.reset(new Cell[size]);
+        for (std::size_t i = 0; i < size; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Any thread; false when the queue is full
+    bool push(const T& value) {
+        std::size_t position = tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[position & mask];
+            std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = value;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only; false when the queue is empty
+    bool pop(T& value) {
+        Cell& cell = cells[head & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != head + 1) return false;
+        value = cell.value;
+        cell.sequence.store(head + mask + 1, std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+    std::size_t capacity() const { return mask + 1; }
+    // Approximate number of queued values
+    std::size_t sizeApprox() const { return tail.load(std::memory_order_relaxed) - consumed.load(std::memory_order_relaxed); }
+    // Consumer thread: publishes progress for sizeApprox()
+    void publishHead() { consumed.store(head, std::memory_order_relaxed); }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    std::size_t mask = 0;
+    alignas(64) std::atomic<std::size_t> tail{0};
+    alignas(64) std::size_t head = 0;
+    std::atomic<std::size_t> consumed{0};
+};
+
+} // namespace detail
+
+struct TelemetryOptions {
+    // Views that can wait in the queue; when it is full, record() drops
+    std::size_t queueCapacity = 64 * 1024;
+    // Time between flushes
+    std::chrono::milliseconds flushInterval{1000};
+    // Distinct (game, viewer) pairs held between flushes; reaching it flushes
+    // early, and while that flush runs the queue absorbs new views
+    std::size_t maxPendingViews = 4096;
+    // Sends per pair before a failing view is given up on
+    int maxAttempts = 3;
+    // Offset from UTC of the server database's time zone. Its calendar day
+    // (MySQL CURDATE()) is what "already viewed today" means to the server.
+    std::chrono::minutes serverUtcOffset{0};
+};
+
+struct TelemetryStats {
+    std::uint64_t recorded = 0;
+    // Rejected because the queue was full
+    std::uint64_t dropped = 0;
+    // Folded into a view already pending or already counted today
+    std::uint64_t coalesced = 0;
+    std::uint64_t sent = 0;
+    std::uint64_t failed = 0;
+};
+
+// Collects game views from any thread and reports them with
+// POST /game-views/games/:gameId/view from one background thread.
+// The server counts one view per viewer (its viewer_id cookie) per game and
+// day, so views are coalesced per (game, viewer) pair: each pair is sent
+// once per flush, and pairs already counted today are not sent again.
+// Anonymous views get a new cookie from the server each, so they are sent
+// one POST per view.
+// Recording is a push onto a bounded lock-free queue of interned IDs.
+class GameViewAggregator {
+public:
+    /**
+     * Start the aggregator and its flush thread.
+     * @param client The client to send with; must outlive the aggregator.
+     */
+    explicit GameViewAggregator(const Client& client, TelemetryOptions options = {});
+    // Flushes what was recorded, then stops the thread
+    ~GameViewAggregator();
+
+    GameViewAggregator(const GameViewAggregator&) = delete;
+    GameViewAggregator& operator=(const GameViewAggregator&) = delete;
+
+    /**
+     * Record one view. Lock-free and allocation-free; safe from any thread.
+     * @param gameId The game viewed.
+     * @param viewerId The viewer cookie to report the view under; empty lets
+     *                 the server assign one per request.
+     * @returns false if the queue was full and the view was dropped.
+     */
+    bool record(Id gameId, Id viewerId = Id()) {
+        bool queued = queue.push(View{gameId, viewerId});
+        (queued ? recorded : dropped).fetch_add(1, std::memory_order_relaxed);
+        if (queued && queue.sizeApprox() > queue.capacity() / 2 && !wakeRequested.exchange(true)) {
+            wake.notify_one();
+        }
+        return queued;
+    }
+
+    // Same, interning the IDs first
+    bool record(std::string_view gameId, std::string_view viewerId = {}) {
+        return record(Id(gameId), viewerId.empty() ? Id() : Id(viewerId));
+    }
+
+    /**
+     * Send everything recorded so far and wait for it.
+     */
+    void flush();
+
+    TelemetryStats stats() const;
+
+private:
+    struct View {
+        Id game;
+        Id viewer;
+    };
+
+    struct Pending {
+        View view;
+        std::uint64_t views = 0;
+        int attempts = 0;
+    };
+
+    static std::uint64_t keyOf(View view) {
+        return static_cast<std::uint64_t>(view.game.index()) << 32 | view.viewer.index();
+    }
+
+    void run();
+    // Moves queued views into `pending`; returns false once it is full
+    bool drain();
+    // Sends every pending pair once (anonymous ones once per view), keeping
+    // failed ones for the next flush
+    void send(cpr::Session& session);
+
+    const Client& client;
+    TelemetryOptions options;
+    detail::BoundedMpscQueue<View> queue;
+
+    std::atomic<std::uint64_t> recorded{0};
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<std::uint64_t> coalesced{0};
+    std::atomic<std::uint64_t> sent{0};
+    std::atomic<std::uint64_t> failed{0};
+
+    // Flush thread state
+    std::unordered_map<std::uint64_t, Pending> pending;
+    // Pairs the server already counted, for the server's day in `countedDay`
+    std::unordered_set<std::uint64_t> counted;
+    std::int64_t countedDay = 0;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable flushed;
+    std::atomic<bool> wakeRequested{false};
+    bool stopping = false;
+    std::uint64_t flushRequested = 0;
+    std::uint64_t flushCompleted = 0;
+    std::thread worker;
+};
+
+// --- MUTATION QUEUE ---
+
+enum class MutationKind {
+    Give,
+    Consume,
+    UpdateMetadata,
+    TransferCredits,
+    Buy
+};
+
+struct MutationResult {
+    // Ticket returned when the mutation was submitted
+    std::uint64_t ticket = 0;
+    MutationKind kind = MutationKind::Give;
+    Result<json> result = json::object();
+};
+
+struct MutationQueueOptions {
+    // Submissions that can wait for the dispatcher; when full, submitting fails
+    std::size_t capacity = 4096;
+    // Requests on the wire at once. Mutations start in submission order but
+    // may complete out of order; 1 keeps them strictly sequential.
+    std::size_t maxInFlight = 8;
+    // Longest the idle dispatcher sleeps; new submissions and socket activity
+    // wake it straight away, so this only bounds the wait
+    std::chrono::milliseconds idleWait{1000};
+    std::chrono::milliseconds requestTimeout{30000};
+};
+
+// Fire-and-forget item and credit mutations for threads that must not block,
+// such as a game tick loop. Submitting serializes the request body and
+// pushes it onto a lock-free queue; a dispatcher thread keeps up to
+// maxInFlight requests running over shared connections (multiplexed on one
+// HTTP/2 connection when the server offers it) and puts each outcome on a
+// completion queue. The game drains that queue with poll() once per frame,
+// so the submitting thread never waits on the network.
+// Submitting is safe from any thread; poll() from one thread at a time.
+class MutationQueue {
+public:
+    /**
+     * Start the dispatcher.
+     * @param client The client whose token (as set now) and host are used.
+     * @throws std::runtime_error if no token is set.
+     */
+    explicit MutationQueue(const Client& client, MutationQueueOptions options = {});
+    // Completes every submitted mutation, then stops; unpolled results are dropped
+    ~MutationQueue();
+
+    MutationQueue(const MutationQueue&) = delete;
+    MutationQueue& operator=(const MutationQueue&) = delete;
+
+    /**
+     * Queue Items::give().
+     * @returns Ticket identifying the result, or 0 if the queue was full.
+     */
+    std::uint64_t give(const std::string& itemId, int amount, const std::string& userId,
+                       const std::optional<Metadata>& metadata = std::nullopt);
+
+    /**
+     * Queue Items::consume().
+     * @returns Ticket identifying the result, or 0 if the queue was full.
+     */
+    std::uint64_t consume(const std::string& itemId, const std::string& userId,
+                          const std::optional<int>& amount = std::nullopt,
+                          const std::optional<std::string>& uniqueId = std::nullopt);
+
+    /**
+     * Queue Items::updateMetadata().
+     * @returns Ticket identifying the result, or 0 if the queue was full.
+     */
+    std::uint64_t updateMetadata(const std::string& itemId, const std::string& uniqueId, const Metadata& metadata);
+
+    /**
+     * Queue Users::transferCredits().
+     * @returns Ticket identifying the result, or 0 if the queue was full.
+     */
+    std::uint64_t transferCredits(const std::string& targetUserId, double amount);
+
+    /**
+     * Take the next finished mutation, if any. Never blocks.
+     * @returns false when no result is waiting.
+     */
+    bool poll(MutationResult& out);
+
+    // Hands every waiting result to `onResult`; returns how many there were
+    template <typename F>
+    std::size_t drain(F&& onResult) {
+        std::size_t count = 0;
+        MutationResult result;
+        while (poll(result)) {
+            onResult(std::move(result));
+            ++count;
+        }
+        return count;
+    }
+
+    // Submitted mutations whose result has not reached the completion queue yet
+    std::size_t inFlight() const {
+        return static_cast<std::size_t>(submitted.load(std::memory_order_relaxed) -
+                                        completed.load(std::memory_order_relaxed));
+    }
+
+private:
+    struct Mutation {
+        std::uint64_t ticket;
+        MutationKind kind;
+        const char* method;
+        std::string endpoint;
+        std::string body;
+    };
+
+    std::uint64_t submit(MutationKind kind, const char* method, std::string endpoint, const std::string& body);
+    void run();
+
+    MutationQueueOptions options;
+    std::string baseUrl;
+    std::string authorization;
+    detail::BoundedMpscQueue<Mutation*> submissions;
+    detail::BoundedMpscQueue<MutationResult*> completions;
+    std::atomic<std::uint64_t> nextTicket{1};
+    std::atomic<std::uint64_t> submitted{0};
+    std::atomic<std::uint64_t> completed{0};
+    std::atomic<bool> stopping{false};
+
+    // The curl multi handle, created up front so submit() can wake the dispatcher
+    struct Transport;
+    std::unique_ptr<Transport> transport;
+    std::thread dispatcher;
+};
+
+// --- MUTATION JOURNAL ---
+
+struct JournalOptions {
+    // The log file grows (and is remapped) in steps of this many bytes
+    std::size_t growBy = 1 << 20;
+    // Flush every record to disk before its request is sent. Turning this off
+    // trades durability on power loss (not on process crash) for throughput.
+    bool syncEveryAppend = true;
+    // Rewrite the log once settled records take up more than this share of it
+    double compactRatio = 0.5;
+    // Requests replay() keeps on the wire at once
+    std::size_t replayBatch = 32;
+    // Resend entries whose earlier request may already have reached the
+    // server. The API does not deduplicate on Idempotency-Key yet, so doing
+    // so can apply a mutation twice; by default such entries are left for
+    // the caller to check and settle with resolve().
+    bool replayUncertain = false;
+    std::chrono::milliseconds requestTimeout{30000};
+};
+
+struct JournalEntry {
+    // Client-generated Idempotency-Key sent with every attempt
+    std::string key;
+    MutationKind kind = MutationKind::Give;
+    std::string method;
+    std::string endpoint;
+    std::string body;
+    // A request was sent without a definite answer, so the server may have applied it
+    bool uncertain = false;
+};
+
+struct JournalReplay {
+    std::size_t acknowledged = 0; // answered 2xx
+    std::size_t rejected = 0;     // answered 4xx; settled and not retried
+    std::size_t pending = 0;      // still unsettled, including skipped uncertain entries
+};
+
+// Write-ahead log for item mutations. Each call appends the mutation, with a
+// fresh idempotency key, to a memory-mapped file before sending it; the
+// answer is appended afterwards. A mutation that got no definite answer
+// (timeout, 5xx, process exit) stays in the log and is resent by replay(),
+// in concurrent batches. Settled records are compacted away. Records carry a
+// CRC, so a write torn by a crash is discarded on the next open.
+// Safe to use from several threads; one journal per file.
+class MutationJournal {
+public:
+    /**
+     * Open (or create) the journal and load its unsettled entries.
+     * @param client The client whose token (as set now) and host are used.
+     * @throws std::runtime_error if no token is set or the file cannot be opened.
+     */
+    MutationJournal(const Client& client, const std::filesystem::path& path, JournalOptions options = {});
+    ~MutationJournal();
+
+    MutationJournal(const MutationJournal&) = delete;
+    MutationJournal& operator=(const MutationJournal&) = delete;
+
+    /**
+     * Journal and send Items::give().
+     * @returns The server's answer, or a Transport/5xx error when the entry was kept for replay().
+     */
+    Result<json> give(const std::string& itemId, int amount, const std::string& userId,
+                      const std::optional<Metadata>& metadata = std::nullopt);
+
+    /**
+     * Journal and send Items::consume().
+     * @returns The server's answer, or a Transport/5xx error when the entry was kept for replay().
+     */
+    Result<json> consume(const std::string& itemId, const std::string& userId,
+                         const std::optional<int>& amount = std::nullopt,
+                         const std::optional<std::string>& uniqueId = std::nullopt);
+
+    /**
+     * Journal and send Items::buy().
+     * @returns The server's answer, or a Transport/5xx error when the entry was kept for replay().
+     */
+    Result<json> buy(const std::string& itemId, int amount);
+
+    /**
+     * Resend unsettled entries in journal order, `replayBatch` at a time.
+     * Blocks until every request sent has been answered or has timed out.
+     */
+    JournalReplay replay();
+
+    // Unsettled entries in journal order
+    std::vector<JournalEntry> pending() const;
+
+    /**
+     * Settle an entry without sending it, e.g. after checking that the server applied it.
+     * @returns false if no unsettled entry has this key.
+     */
+    bool resolve(const std::string& key);
+
+    // Rewrite the log with only the unsettled entries
+    void compact();
+
+    std::size_t size() const;
+
+private:
+    struct Impl;
+
+    Result<json> record(MutationKind kind, const char* method, std::string endpoint, std::string body);
+
+    std::unique_ptr<Impl> impl;
+};
+
+// --- LOBBY WATCHER ---
+
+enum class LobbyEventKind {
+    Joined,
+    Left,
+    Closed // the lobby no longer exists; it is no longer watched
+};
+
+struct LobbyEvent {
+    LobbyEventKind kind = LobbyEventKind::Joined;
+    std::string lobbyId;
+    // The player who joined or left; empty for Closed
+    LobbyUser user;
+};
+
+namespace detail {
+
+// Reports players in `next` but not `previous` as joined, and the reverse as
+// left. Both lists are sorted by user_id.
+void diffUsers(const std::string& lobbyId, const std::vector<LobbyUser>& previous,
+               const std::vector<LobbyUser>& next, std::vector<LobbyEvent>& events);
+
+} // namespace detail
+
+struct LobbyWatchOptions {
+    // Polling interval right after a lobby changed
+    std::chrono::milliseconds minInterval{500};
+    // Ceiling the interval backs off to while a lobby stays unchanged
+    std::chrono::milliseconds maxInterval{15000};
+    // Interval multiplier per unchanged poll
+    double backoff = 1.5;
+    // Conditional GETs on the wire at once
+    std::size_t maxInFlight = 16;
+    std::chrono::milliseconds requestTimeout{10000};
+};
+
+struct LobbyWatchStats {
+    std::uint64_t requests = 0;
+    // Answered 304: nothing downloaded or parsed
+    std::uint64_t notModified = 0;
+    std::uint64_t changed = 0;
+    std::uint64_t failed = 0;
+    std::uint64_t events = 0;
+};
+
+// Watches many lobbies from one background thread and reports players
+// joining and leaving. The API has no push channel for lobbies, so each
+// lobby is polled with a conditional GET (If-None-Match), and an unchanged
+// lobby costs a 304 with no body. Every lobby has its own interval: it drops
+// to minInterval when the lobby changes and backs off towards maxInterval
+// while it stays quiet, so the request rate follows the rate of change
+// rather than the number of lobbies watched.
+// The first poll of a lobby reports everyone already in it as Joined.
+class LobbyWatcher {
+public:
+    // Called on the watcher thread; must not call back into the watcher's destructor
+    using Listener = std::function<void(const LobbyEvent&)>;
+
+    /**
+     * Start the watcher thread.
+     * @param client The client whose host is polled.
+     * @param onEvent Receives every join, leave and close.
+     */
+    LobbyWatcher(const Client& client, Listener onEvent, LobbyWatchOptions options = {});
+    // Stops the thread; requests on the wire are abandoned
+    ~LobbyWatcher();
+
+    LobbyWatcher(const LobbyWatcher&) = delete;
+    LobbyWatcher& operator=(const LobbyWatcher&) = delete;
+
+    /**
+     * Start watching a lobby; it is polled right away. Watching it again is a no-op.
+     * @param lobbyId The lobby ID.
+     */
+    void watch(const std::string& lobbyId);
+
+    // Stop watching a lobby; no further events are reported for it
+    void unwatch(const std::string& lobbyId);
+
+    /**
+     * Poll a lobby now and reset its interval, e.g. right after Lobbies::join().
+     * @returns false if the lobby is not watched.
+     */
+    bool nudge(const std::string& lobbyId);
+
+    std::size_t size() const;
+    LobbyWatchStats stats() const;
+
+private:
+    struct Watched;
+    struct Poll;
+
+    void run();
+    void wakeUp();
+
+    std::string baseUrl;
+    Listener onEvent;
+    LobbyWatchOptions options;
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, std::unique_ptr<Watched>> lobbies;
+    // When each idle lobby is due, earliest first
+    std::multimap<std::chrono::steady_clock::time_point, std::string> schedule;
+    std::uint64_t nextGeneration = 0;
+    LobbyWatchStats counters;
+    bool stopping = false;
+
+    // The curl multi handle, created up front so wakeUp() can reach it
+    struct Transport;
+    std::unique_ptr<Transport> transport;
+    std::thread worker;
+};
+
+// --- TRADE WATCHER ---
+
+struct TradeItemChange {
+    // Side of the trade the item is on
+    bool fromUser = true;
+    std::string itemId;
+    // Total amount of this item on that side before and after; 0 before
+    // means it was added, 0 after that it was removed
+    int previousAmount = 0;
+    int amount = 0;
+    // Latest name, description and icon (the last known ones when removed)
+    TradeItemDetail item;
+};
+
+namespace detail {
+
+// Sums each side's amounts per itemId; unique items appear once per instance.
+// The last entry's name, description and icon win.
+std::map<std::string, TradeItemDetail> itemsById(std::vector<TradeItemDetail>& items);
+
+// Appends an added, removed or re-counted entry for each itemId whose amount
+// differs between the two sides
+void diffItems(bool fromUser, const std::map<std::string, TradeItemDetail>& previous,
+               const std::map<std::string, TradeItemDetail>& next, std::vector<TradeItemChange>& changes);
+
+} // namespace detail
+
+// What changed in one trade since the previous poll. Fields that did not
+// change are left empty.
+struct TradeChange {
+    std::string tradeId;
+    // First time the trade was seen; `items` lists what it already holds
+    bool opened = false;
+    std::vector<TradeItemChange> items;
+    std::optional<bool> approvedFromUser;
+    std::optional<bool> approvedToUser;
+    std::optional<std::string> status;
+};
+
+struct TradeWatchOptions {
+    // Polling interval right after a trade changed
+    std::chrono::milliseconds minInterval{500};
+    // Ceiling the interval backs off to while nothing changes
+    std::chrono::milliseconds maxInterval{10000};
+    // Interval multiplier per unchanged poll
+    double backoff = 1.5;
+};
+
+struct TradeWatchStats {
+    std::uint64_t requests = 0;
+    // Answered 304: nothing downloaded or parsed
+    std::uint64_t notModified = 0;
+    std::uint64_t failed = 0;
+    // Trades whose updatedAt moved and were diffed
+    std::uint64_t diffed = 0;
+    std::uint64_t changes = 0;
+};
+
+// Follows every trade of the authenticated user and reports what changed,
+// item by item. All of them are fetched in one batch (GET /trades/user/:id),
+// conditionally, so an unchanged batch costs a 304 no matter how many trades
+// are open. A 200 is diffed trade by trade, skipping trades whose updatedAt
+// did not move. The interval drops to minInterval after a change and backs
+// off towards maxInterval while nothing changes.
+// Trades first seen already completed or canceled are recorded silently.
+class TradeWatcher {
+public:
+    // Called on the watcher thread
+    using Listener = std::function<void(const TradeChange&)>;
+
+    /**
+     * Start the watcher thread.
+     * @param client The client to poll with; must outlive the watcher.
+     * @param userId The authenticated user's ID; the API only lists one's own trades.
+     * @param onChange Receives each trade's changes.
+     * @throws std::runtime_error if no token is set.
+     */
+    TradeWatcher(const Client& client, std::string userId, Listener onChange, TradeWatchOptions options = {});
+    ~TradeWatcher();
+
+    TradeWatcher(const TradeWatcher&) = delete;
+    TradeWatcher& operator=(const TradeWatcher&) = delete;
+
+    // Poll now and reset the interval, e.g. right after Trades::addItem()
+    void nudge();
+
+    TradeWatchStats stats() const;
+
+private:
+    // A trade as last seen, with each side's items summed per itemId
+    struct Snapshot {
+        std::string updatedAt;
+        bool approvedFromUser = false;
+        bool approvedToUser = false;
+        std::string status;
+        std::map<std::string, TradeItemDetail> fromUserItems;
+        std::map<std::string, TradeItemDetail> toUserItems;
+    };
+
+    void run();
+    // Diffs a 200 against `trades`; returns true if anything changed
+    bool apply(std::vector<Trade>& latest, std::vector<TradeChange>& changes);
+
+    const Client& client;
+    std::string url;
+    Listener onChange;
+    TradeWatchOptions options;
+
+    // Watcher thread state
+    std::unordered_map<std::string, Snapshot> trades;
+    std::string etag;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    TradeWatchStats counters;
+    bool nudged = false;
+    bool stopping = false;
+    std::thread worker;
+};
+
+// --- PUSH EVENTS ---
+
+struct PushEvent {
+    // The event's "event" field; "message" when the server sent none
+    std::string type;
+    // The last "id" the stream sent; it is the resume token for reconnects
+    std::string id;
+    // The "data" lines, joined with newlines
+    std::string data;
+};
+
+namespace detail {
+
+// Incremental text/event-stream parser, following the HTML "Server-sent
+// events" processing model. Lines may end in CR, LF or CRLF, and any line
+// may be split across chunks.
+class SseParser {
+public:
+    explicit SseParser(std::string lastId) : lastId(std::move(lastId)) {}
 
-        /**
-         * Drop an item instance from the user's inventory.
-         * @param itemId The item ID.
-         * @param amount Optional amount (if not specified, uniqueId must be provided).
-         * @param uniqueId Optional unique instance ID.
-         * @returns APIResponse with operation result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse drop(const std::string& itemId,
-                        const std::optional<int>& amount = std::nullopt,
-                        const std::optional<std::string>& uniqueId = std::nullopt) const;
-    } items;
+    template <typename OnEvent>
+    void feed(std::string_view chunk, OnEvent&& onEvent) {
+        while (!chunk.empty()) {
+            if (skipLineFeed) {
+                skipLineFeed = false;
+                if (chunk.front() == '\n') {
+                    chunk.remove_prefix(1);
+                    continue;
+                }
+            }
+            auto end = chunk.find_first_of("\r\n");
+            if (end == std::string_view::npos) {
+                partial.append(chunk);
+                return;
+            }
+            skipLineFeed = chunk[end] == '\r';
+            if (partial.empty()) {
+                line(chunk.substr(0, end), onEvent);
+            } else {
+                partial.append(chunk.substr(0, end));
+                line(partial, onEvent);
+                partial.clear();
+            }
+            chunk.remove_prefix(end + 1);
+        }
+    }
 
-    // --- LOBBIES NAMESPACE ---
-    struct Lobbies {
-        const Client& client;
-        explicit Lobbies(const Client& c) : client(c) {}
+    // Persists across events and is echoed as Last-Event-ID on reconnect
+    std::string lastId;
+    std::optional<std::chrono::milliseconds> retry;
+    std::uint64_t comments = 0;
 
-        /**
-         * Create a new lobby for the authenticated user.
-         * @returns APIResponse with creation result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse create() const;
+private:
+    template <typename OnEvent>
+    void line(std::string_view text, OnEvent& onEvent) {
+        if (firstLine) {
+            firstLine = false;
+            if (text.substr(0, 3) == "\xEF\xBB\xBF") text.remove_prefix(3);
+        }
+        if (text.empty()) {
+            dispatch(onEvent);
+            return;
+        }
+        if (text.front() == ':') {
+            ++comments;
+            return;
+        }
 
-        /**
-         * Get a lobby by its ID.
-         * @param lobbyId The lobby ID.
-         * @returns The lobby object or nullopt if not found.
-         */
-        std::optional<Lobby> get(const std::string& lobbyId) const;
+        auto colon = text.find(':');
+        std::string_view field = text.substr(0, colon);
+        std::string_view value;
+        if (colon != std::string_view::npos) {
+            value = text.substr(colon + 1);
+            if (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+        }
 
-        /**
-         * Get the lobby the authenticated user is in.
-         * @returns The lobby object or nullopt if not in a lobby.
-         * @throws std::runtime_error if not authenticated.
-         */
-        std::optional<Lobby> getMyLobby() const;
+        if (field == "event") {
+            type.assign(value);
+        } else if (field == "data") {
+            data.append(value);
+            data.push_back('\n');
+        } else if (field == "id") {
+            if (value.find('\0') == std::string_view::npos) lastId.assign(value);
+        } else if (field == "retry") {
+            long long ms = 0;
+            auto parsed = std::from_chars(value.data(), value.data() + value.size(), ms);
+            if (!value.empty() && parsed.ec == std::errc() && parsed.ptr == value.data() + value.size() && ms >= 0) {
+                retry = std::chrono::milliseconds(ms);
+            }
+        }
+    }
 
-        /**
-         * Get the lobby a user is in by userId.
-         * @param userId The user ID.
-         * @returns The lobby object or nullopt if user not in a lobby.
-         */
-        std::optional<Lobby> getUserLobby(const std::string& userId) const;
+    template <typename OnEvent>
+    void dispatch(OnEvent& onEvent) {
+        if (data.empty()) {
+            type.clear();
+            return;
+        }
+        data.pop_back();
+        onEvent(PushEvent{type.empty() ? "message" : std::move(type), lastId, std::move(data)});
+        type.clear();
+        data.clear();
+    }
 
-        /**
-         * Join a lobby by its ID.
-         * @param lobbyId The lobby ID.
-         * @returns APIResponse with join result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse join(const std::string& lobbyId) const;
+    std::string partial;
+    std::string type;
+    std::string data;
+    bool skipLineFeed = false;
+    bool firstLine = true;
+};
 
-        /**
-         * Leave a lobby by its ID.
-         * @param lobbyId The lobby ID.
-         * @returns APIResponse with leave result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse leave(const std::string& lobbyId) const;
-    } lobbies;
+} // namespace detail
 
-    // --- STUDIOS NAMESPACE ---
-    struct Studios {
-        const Client& client;
-        explicit Studios(const Client& c) : client(c) {}
+struct PushOptions {
+    // Event stream to connect to. Empty means base URL + `path`. The API has
+    // no event stream yet, so set this to a gateway or a local stand-in.
+    std::string url;
+    std::string path = "/events";
+    // Wait before reconnecting; a "retry:" field from the server replaces it
+    std::chrono::milliseconds reconnectDelay{1000};
+    // Ceiling the wait doubles up to while connecting keeps failing
+    std::chrono::milliseconds maxReconnectDelay{30000};
+    // A connection that receives nothing, not even keep-alive comments, for
+    // this long is dropped and reopened
+    std::chrono::milliseconds idleTimeout{60000};
+    // Runs each batch of handler calls. Empty uses a dispatch thread owned by
+    // the PushClient, so slow handlers never hold up the connection.
+    std::function<void(std::function<void()>)> executor;
+};
 
-        /**
-         * Create a new studio.
-         * @param studioName The name of the studio.
-         * @returns APIResponse with creation result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse create(const std::string& studioName) const;
+enum class PushState {
+    Closed,
+    Connecting,
+    Open,
+    Reconnecting
+};
 
-        /**
-         * Get a studio by its ID.
-         * @param studioId The studio ID.
-         * @returns The studio object or nullopt if not found.
-         */
-        std::optional<Studio> get(const std::string& studioId) const;
+struct PushStats {
+    std::uint64_t connects = 0;
+    std::uint64_t reconnects = 0;
+    std::uint64_t events = 0;
+    std::uint64_t comments = 0; // keep-alives
+};
 
-        /**
-         * Get all studios the authenticated user is a member of.
-         * @returns Vector of studios.
-         * @throws std::runtime_error if not authenticated.
-         */
-        std::vector<Studio> getMyStudios() const;
+// Server-Sent Events client: one long-lived connection per instance, whose
+// events are routed by type to any number of subscribers. Reconnects with
+// backoff, resuming from the last event ID (Last-Event-ID), and drops
+// connections that go silent. Handlers run on the executor, in stream order.
+// WebSocket is not supported: the API serves neither transport yet, and
+// Server-Sent Events needs nothing beyond HTTP.
+class PushClient {
+public:
+    using Handler = std::function<void(const PushEvent&)>;
+    using SubscriptionId = std::uint64_t;
 
-        /**
-         * Add a user to a studio.
-         * @param studioId The studio ID.
-         * @param userId The user ID to add.
-         * @returns APIResponse with operation result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse addUser(const std::string& studioId, const std::string& userId) const;
+    /**
+     * Set up the client; nothing connects until start().
+     * @param client The client whose token and host are used; must outlive this.
+     */
+    explicit PushClient(const Client& client, PushOptions options = {});
+    // Closes the connection and waits for queued handler calls on the default executor
+    ~PushClient();
 
-        /**
-         * Remove a user from a studio.
-         * @param studioId The studio ID.
-         * @param userId The user ID to remove.
-         * @returns APIResponse with operation result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse removeUser(const std::string& studioId, const std::string& userId) const;
-    } studios;
+    PushClient(const PushClient&) = delete;
+    PushClient& operator=(const PushClient&) = delete;
 
-    // --- TRADES NAMESPACE ---
-    struct Trades {
-        const Client& client;
-        explicit Trades(const Client& c) : client(c) {}
+    // Opens the connection in the background; does nothing if already started
+    void start();
+    // Closes the connection; start() opens it again, resuming from lastEventId()
+    void stop();
 
-        /**
-         * Start a new trade or get the latest pending trade with a user.
-         * @param userId The user ID to trade with.
-         * @returns The trade object or nullopt if failed.
-         * @throws std::runtime_error if not authenticated.
-         */
-        std::optional<Trade> startOrGetPending(const std::string& userId) const;
+    /**
+     * Receive events of one type.
+     * @param type The event type; empty receives every event.
+     * @returns An ID for unsubscribe().
+     */
+    SubscriptionId subscribe(const std::string& type, Handler handler);
 
-        /**
-         * Get a trade by its ID.
-         * @param tradeId The trade ID.
-         * @returns The trade object or nullopt if not found.
-         * @throws std::runtime_error if not authenticated.
-         */
-        std::optional<Trade> get(const std::string& tradeId) const;
+    // Same, decoding each event's JSON data into T; events that do not parse are skipped
+    template <typename T>
+    SubscriptionId subscribe(const std::string& type, std::function<void(const T&)> handler) {
+        return subscribe(type, [handler = std::move(handler)](const PushEvent& event) {
+            json data = json::parse(event.data, nullptr, false);
+            if (!data.is_discarded()) handler(T(data));
+        });
+    }
 
-        /**
-         * Get all trades for a user.
-         * @param userId The user ID.
-         * @returns Vector of trades.
-         * @throws std::runtime_error if not authenticated.
-         */
-        std::vector<Trade> getUserTrades(const std::string& userId) const;
+    // Stops a subscription; calls already queued may still run
+    bool unsubscribe(SubscriptionId id);
 
-        /**
-         * Add an item to a trade.
-         * @param tradeId The trade ID.
-         * @param tradeItem The item to add.
-         * @returns APIResponse with operation result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse addItem(const std::string& tradeId, const TradeItem& tradeItem) const;
+    PushState state() const;
+    std::string lastEventId() const;
+    PushStats stats() const;
 
-        /**
-         * Remove an item from a trade.
-         * @param tradeId The trade ID.
-         * @param tradeItem The item to remove.
-         * @returns APIResponse with operation result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse removeItem(const std::string& tradeId, const TradeItem& tradeItem) const;
+private:
+    struct Subscription {
+        std::string type;
+        std::shared_ptr<const Handler> handler;
+    };
 
-        /**
-         * Approve a trade.
-         * @param tradeId The trade ID.
-         * @returns APIResponse with operation result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse approve(const std::string& tradeId) const;
+    void run();
+    void dispatch(PushEvent&& event);
+    void post(std::function<void()> task);
+    // Body of the default dispatch thread
+    void runTasks();
 
-        /**
-         * Cancel a trade.
-         * @param tradeId The trade ID.
-         * @returns APIResponse with operation result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse cancel(const std::string& tradeId) const;
-    } trades;
+    const Client& client;
+    PushOptions options;
+    std::string url;
 
-    // --- OAUTH2 NAMESPACE ---
-    struct OAuth2 {
-        const Client& client;
-        explicit OAuth2(const Client& c) : client(c) {}
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::map<SubscriptionId, Subscription> subscriptions;
+    SubscriptionId nextSubscription = 1;
+    std::string lastId;
+    std::chrono::milliseconds retry{0};
+    PushState current = PushState::Closed;
+    PushStats counters;
+    bool stopping = false;
+    std::thread reader;
 
-        /**
-         * Get an OAuth2 app by its client ID.
-         * @param client_id The client ID.
-         * @returns The OAuth2 app object or nullopt if not found.
-         */
-        std::optional<OAuth2App> getApp(const std::string& client_id) const;
+    // Default executor
+    std::mutex taskMutex;
+    std::condition_variable taskReady;
+    std::deque<std::function<void()>> tasks;
+    bool tasksStopping = false;
+    std::thread dispatcher;
+};
 
-        /**
-         * Create a new OAuth2 app.
-         * @param name The app name.
-         * @param redirect_urls The allowed redirect URLs.
-         * @returns Pair of client_id and client_secret or nullopt if failed.
-         * @throws std::runtime_error if not authenticated.
-         */
-        std::optional<std::pair<std::string, std::string>> createApp(const std::string& name, 
-                                                                    const std::vector<std::string>& redirect_urls) const;
+// --- SEARCH SESSION ---
 
-        /**
-         * Get all OAuth2 apps owned by the authenticated user.
-         * @returns Vector of OAuth2 apps.
-         * @throws std::runtime_error if not authenticated.
-         */
-        std::vector<OAuth2App> getMyApps() const;
+// Route a SearchSession queries
+enum class SearchScope {
+    All,   // /search: users, games and items
+    Games, // /games/search
+    Items  // /items/search
+};
 
-        /**
-         * Update an OAuth2 app.
-         * @param client_id The client ID.
-         * @param name Optional new name.
-         * @param redirect_urls Optional new redirect URLs.
-         * @returns APIResponse with update result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse updateApp(const std::string& client_id,
-                             const std::optional<std::string>& name = std::nullopt,
-                             const std::optional<std::vector<std::string>>& redirect_urls = std::nullopt) const;
+struct SearchSessionOptions {
+    SearchScope scope = SearchScope::All;
+    // Quiet time after the last update() before a request is sent
+    std::chrono::milliseconds debounce{150};
+    std::chrono::milliseconds requestTimeout{10000};
+    // Answers remembered per query, for repeated queries and prefix narrowing
+    std::size_t maxCached = 64;
+    // Remembered answers older than this are fetched again
+    std::chrono::milliseconds maxAge{30000};
+    // The server stops a section at this many results. A section that reached
+    // it may have been cut short, so it is never narrowed locally.
+    std::size_t serverLimit = 100;
+};
 
-        /**
-         * Delete an OAuth2 app by its client ID.
-         * @param client_id The client ID.
-         * @returns APIResponse with deletion result.
-         * @throws std::runtime_error if not authenticated.
-         */
-        APIResponse deleteApp(const std::string& client_id) const;
+enum class SearchSource {
+    Network,
+    Cache,   // answer remembered for the same query
+    Narrowed // filtered from the answer to a prefix of the query
+};
 
-        /**
-         * Authorize a user for an OAuth2 app.
-         * @param client_id The client ID.
-         * @param redirect_uri The redirect URI.
-         * @returns The authorization code or empty string if failed.
-         * @throws std::runtime_error if not authenticated.
-         */
-        std::string authorize(const std::string& client_id, const std::string& redirect_uri) const;
+struct SearchUpdate {
+    // The query as passed to update(), trimmed
+    std::string query;
+    // Empty when failed
+    std::shared_ptr<const SearchResults> results;
+    SearchSource source = SearchSource::Network;
+    bool failed = false;
+};
 
-        /**
-         * Get a user by OAuth2 code and client ID.
-         * @param code The authorization code.
-         * @param client_id The client ID.
-         * @returns The user object or nullopt if failed.
-         */
-        std::optional<User> getUserByCode(const std::string& code, const std::string& client_id) const;
-    } oauth2;
+struct SearchStats {
+    std::uint64_t updates = 0;
+    std::uint64_t requests = 0;
+    // Requests aborted on the wire because a newer query replaced them
+    std::uint64_t cancelled = 0;
+    std::uint64_t cacheHits = 0;
+    std::uint64_t narrowed = 0;
+    std::uint64_t failed = 0;
+};
 
-    // Constructor initializes all namespaces
-    Client(const std::string& token = "") 
-        : token(token), users(*this), games(*this), inventory(*this), items(*this), 
-          lobbies(*this), studios(*this), trades(*this), oauth2(*this) {}
+namespace detail {
+
+// Whether the server's matching reduces to a substring test for `key` (ASCII
+// lowercase): LIKE reads % and _ as wildcards, and user search folds
+// accented letters into plain ones
+bool narrowable(std::string_view key);
+
+// The server's user search slug (lowercase letters and digits), for ASCII
+// text only; nullopt where its Unicode folding would be needed
+std::optional<std::string> asciiSlug(std::string_view text);
+
+// Filters the answer to a prefix of `key` down to the answer for `key`, using
+// the fields each section is matched on server-side; nullopt if a result
+// can't be matched the way the server would. `key` must be narrowable().
+std::optional<SearchResults> narrowResults(const SearchResults& prefix, std::string_view key);
+
+} // namespace detail
+
+// Search-as-you-type over one background thread. update() is meant to be
+// called on every keystroke: requests go out only once input has been quiet
+// for the debounce interval, and a request still on the wire when a newer
+// query arrives is aborted. A query that extends one already answered is
+// filtered locally from that answer when the server's matching rules allow
+// it (ASCII letters, digits and spaces, no section at the server limit), so
+// typing on after a pause costs no requests at all.
+// Only the latest query is ever delivered: an answer is dropped if update()
+// was called again before it is ready, and answers arrive in update() order.
+class SearchSession {
+public:
+    // Called on the session thread; must not call back into the session's destructor
+    using Listener = std::function<void(const SearchUpdate&)>;
 
-    // --- GLOBAL SEARCH ---
     /**
-     * Perform a global search across all content types.
-     * @param query The search string.
-     * @returns JSON object with search results.
+     * Start the session thread.
+     * @param client The client whose host is searched; must outlive the session.
+     * @param onUpdate Receives the answer to the latest query.
      */
-    json globalSearch(const std::string& query) const;
+    SearchSession(const Client& client, Listener onUpdate, SearchSessionOptions options = {});
+    // Stops the thread; a request on the wire is aborted
+    ~SearchSession();
+
+    SearchSession(const SearchSession&) = delete;
+    SearchSession& operator=(const SearchSession&) = delete;
+
+    /**
+     * Replace the current query. An empty (or all-blank) query is answered
+     * right away with empty results.
+     * @param query The text in the search field.
+     */
+    void update(const std::string& query);
+
+    // Abort any pending query; nothing is delivered until the next update()
+    void cancel();
+
+    SearchStats stats() const;
+
+private:
+    struct Entry;
+    struct Request;
+
+    void run();
+    void wakeUp();
+    // Answers the latest query from the cache, or null; called with the mutex held
+    std::shared_ptr<const SearchResults> answerLocally(SearchSource& source);
+    void remember(const std::string& key, std::shared_ptr<const SearchResults> results,
+                  std::chrono::steady_clock::time_point stored);
+
+    std::string baseUrl;
+    Listener onUpdate;
+    SearchSessionOptions options;
+
+    mutable std::mutex mutex;
+    // Latest query as typed, and its cache key (trimmed, ASCII lowercase)
+    std::string query;
+    std::string key;
+    std::uint64_t generation = 0;
+    // Cleared by cancel()
+    bool active = false;
+    // False while the latest query still needs an answer
+    bool answered = true;
+    // When the debounce interval of the latest query ends
+    std::chrono::steady_clock::time_point quietAt;
+    std::unordered_map<std::string, Entry> cache;
+    // Cache keys, most recently used first
+    std::list<std::string> recency;
+    SearchStats counters;
+    bool stopping = false;
+
+    // The curl multi handle, created up front so wakeUp() can reach it
+    struct Transport;
+    std::unique_ptr<Transport> transport;
+    std::thread worker;
 };
 
 } // namespace CroissantAPI
+
+namespace std {
+
+template <>
+struct hash<CroissantAPI::Id> {
+    std::size_t operator()(CroissantAPI::Id id) const noexcept { return id.index(); }
+};
+
+} // namespace std
@@ -1,4 +1,4 @@
-#include "croissant_api_new.hpp"
+#include "croissant_api.hpp"
 #include <iostream>
 #include <iomanip>
 
@@ -0,0 +1,85 @@
+// sizeof and memory-footprint regressions for CompactUser and CompactGame,
+// and their round trips through User and Game.
+
+#include "croissant_api.hpp"
+#include "test_util.hpp"
+
+using namespace CroissantAPI;
+
+namespace {
+
+// Heap bytes of a string, 0 while it fits the small-string buffer
+std::size_t heapBytes(const std::string& value) {
+    return value.capacity() > std::string().capacity() ? value.capacity() + 1 : 0;
+}
+
+std::size_t heapBytes(const std::optional<std::string>& value) {
+    return value ? heapBytes(*value) : 0;
+}
+
+// What a cache entry of the full type costs, measured the same way as footprint()
+std::size_t footprintOf(const Game& game) {
+    return sizeof(game) + heapBytes(game.gameId) + heapBytes(game.name) + heapBytes(game.description) +
+           heapBytes(game.owner_id) + heapBytes(game.iconHash) + heapBytes(game.splashHash) +
+           heapBytes(game.bannerHash) + heapBytes(game.genre) + heapBytes(game.release_date) +
+           heapBytes(game.developer) + heapBytes(game.publisher) + heapBytes(game.website) +
+           heapBytes(game.trailer_link) + heapBytes(game.download_link);
+}
+
+std::size_t footprintOf(const User& user) {
+    return sizeof(user) + heapBytes(user.userId) + heapBytes(user.username) + heapBytes(user.email) +
+           heapBytes(user.verificationKey) + heapBytes(user.steam_id) + heapBytes(user.steam_username) +
+           heapBytes(user.steam_avatar_url) + heapBytes(user.google_id) + heapBytes(user.discord_id);
+}
+
+// A store listing as /games returns it: most optional strings are set
+Game sampleGame() {
+    return Game(json{{"gameId", "7f8a2b3c-1d4e-4f5a-9b6c-7d8e9f0a1b2c"}, {"name", "Croissant Quest"},
+                     {"description", std::string(300, 'd')}, {"price", 4.99},
+                     {"owner_id", "0a1b2c3d-4e5f-6a7b-8c9d-0e1f2a3b4c5d"}, {"showInStore", 1},
+                     {"iconHash", "5d41402abc4b2a76b9719d911017c592"}, {"genre", "RPG"},
+                     {"release_date", "2024-05-17"}, {"developer", "Flaky Studio"},
+                     {"platforms", {"windows", "linux"}}, {"rating", 4.5}, {"multiplayer", 0}});
+}
+
+// A public profile: only the basic fields
+User sampleUser() {
+    return User(json{{"user_id", "0a1b2c3d-4e5f-6a7b-8c9d-0e1f2a3b4c5d"}, {"username", "baker"},
+                     {"verified", 1}, {"isStudio", false}, {"admin", 0}, {"balance", 120.5}});
+}
+
+} // namespace
+
+int main() {
+    // Layout: the compact types stay a fraction of the full ones
+    std::printf("sizeof User %zu, CompactUser %zu; Game %zu, CompactGame %zu\n", sizeof(User),
+                sizeof(CompactUser), sizeof(Game), sizeof(CompactGame));
+    CHECK(sizeof(CompactUser) <= 3 * sizeof(std::string) + 48);
+    CHECK(sizeof(CompactGame) <= 5 * sizeof(std::string) + 48);
+    CHECK(sizeof(CompactUser) * 3 < sizeof(User));
+    CHECK(sizeof(CompactGame) * 2 < sizeof(Game));
+
+    // Footprint: fewer bytes per cached entry, counting heap storage
+    Game game = sampleGame();
+    CompactGame compactGame(game);
+    std::printf("footprint Game %zu, CompactGame %zu\n", footprintOf(game), compactGame.footprint());
+    CHECK(compactGame.footprint() < footprintOf(game));
+
+    User user = sampleUser();
+    CompactUser compactUser(user);
+    std::printf("footprint User %zu, CompactUser %zu\n", footprintOf(user), compactUser.footprint());
+    CHECK(compactUser.footprint() * 2 < footprintOf(user));
+
+    // Round trips keep every field
+    CHECK(compactGame.toGame().to_json() == game.to_json());
+    CHECK(compactUser.toUser().to_json() == user.to_json());
+    CHECK(compactGame.showInStore());
+    CHECK(!compactGame.multiplayer());
+    CHECK(compactGame.genre() == std::optional<std::string_view>("RPG"));
+    CHECK(!compactGame.website());
+    CHECK(compactUser.verified());
+    CHECK(compactUser.balance() == std::optional<double>(120.5));
+    CHECK(!compactUser.email());
+
+    return test::result();
+}
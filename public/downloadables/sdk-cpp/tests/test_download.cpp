@@ -0,0 +1,218 @@
+// Games::download against a loopback stand-in: parallel range requests,
+// resuming from the CRC-checked state file (intact, truncated, or pointing at
+// damaged bytes), a server that ignores Range, and a file that changed on the
+// server between attempts.
+
+#include "croissant_api.hpp"
+#include "test_server.hpp"
+#include "test_util.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+using namespace CroissantAPI;
+
+namespace {
+
+constexpr std::size_t chunk = 64 * 1024;
+
+std::string makeContent(std::size_t size) {
+    std::string content(size, '\0');
+    std::uint32_t x = 2463534242u;
+    for (auto& c : content) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        c = static_cast<char>(x);
+    }
+    return content;
+}
+
+std::string sha256(const std::string& data) {
+    detail::Sha256 sha;
+    sha.update(data.data(), data.size());
+    return sha.hexDigest();
+}
+
+std::string readFile(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Serves `content` at the download route, honouring "bytes=a-b" ranges unless
+// `ranges` is off
+struct Origin {
+    std::string content = makeContent(5 * chunk + 1000);
+    std::string etag = "\"v1\"";
+    std::atomic<bool> ranges{true};
+    std::atomic<int> rangeRequests{0};
+    std::atomic<bool> authorized{true};
+    std::mutex mutex;
+
+    test::Reply operator()(const test::Request& request) {
+        if (request.target != "/api/games/g1/download") return test::Reply{404};
+        if (request.header("authorization") != "Bearer secret") authorized = false;
+        std::lock_guard<std::mutex> lock(mutex);
+        test::Reply reply;
+        reply.headers.emplace_back("ETag", etag);
+        std::string range = request.header("range");
+        if (!ranges || range.rfind("bytes=", 0) != 0) {
+            reply.body = content;
+            return reply;
+        }
+        ++rangeRequests;
+        std::size_t dash = range.find('-');
+        std::size_t first = std::stoul(range.substr(6, dash - 6));
+        std::size_t last = std::min<std::size_t>(std::stoul(range.substr(dash + 1)), content.size() - 1);
+        reply.status = 206;
+        reply.headers.emplace_back("Content-Range", "bytes " + std::to_string(first) + "-" + std::to_string(last) +
+                                                        "/" + std::to_string(content.size()));
+        reply.body = content.substr(first, last - first + 1);
+        return reply;
+    }
+};
+
+// One connection, cancelled once `limit` bytes have arrived
+DownloadResult interrupted(Client& client, const std::filesystem::path& destination, std::uint64_t limit) {
+    DownloadOptions options;
+    options.chunkSize = chunk;
+    options.connections = 1;
+    options.onProgress = [limit](std::uint64_t done, std::uint64_t) { return done < limit; };
+    return client.games.download("g1", destination, options);
+}
+
+DownloadResult complete(Client& client, const std::filesystem::path& destination, std::size_t connections = 3) {
+    DownloadOptions options;
+    options.chunkSize = chunk;
+    options.connections = connections;
+    return client.games.download("g1", destination, options);
+}
+
+} // namespace
+
+int main() {
+    Origin origin;
+    test::Server server([&origin](const test::Request& request) { return origin(request); });
+    Client client("secret");
+    client.setBaseUrl(server.url() + "/api");
+
+    auto directory = std::filesystem::temp_directory_path() / ("croissant_download_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(directory);
+    auto destination = directory / "game.zip";
+    auto state = directory / "game.zip.download";
+    const std::string expected = sha256(origin.content);
+
+    // Fresh download over parallel connections
+    {
+        auto result = complete(client, destination);
+        CHECK(result.success);
+        CHECK(result.bytes == origin.content.size());
+        CHECK(result.resumedBytes == 0);
+        CHECK(result.sha256 == expected);
+        CHECK(readFile(destination) == origin.content);
+        CHECK(!std::filesystem::exists(state));
+        CHECK(origin.rangeRequests == 6);
+        CHECK(origin.authorized);
+    }
+
+    // Interrupted in the third chunk: the first two are recorded and kept
+    {
+        std::filesystem::remove(destination);
+        auto cut = interrupted(client, destination, 2 * chunk + chunk / 2);
+        CHECK(!cut.success);
+        CHECK(cut.message == "Download cancelled");
+        CHECK(std::filesystem::exists(state));
+
+        origin.rangeRequests = 0;
+        auto result = complete(client, destination);
+        CHECK(result.success);
+        CHECK(result.resumedBytes == 2 * chunk);
+        CHECK(result.sha256 == expected);
+        CHECK(readFile(destination) == origin.content);
+        CHECK(origin.rangeRequests == 4);
+        CHECK(!std::filesystem::exists(state));
+    }
+
+    // A recorded chunk whose bytes were damaged since is fetched again
+    {
+        std::filesystem::remove(destination);
+        interrupted(client, destination, 2 * chunk + chunk / 2);
+        {
+            std::fstream file(destination, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(100);
+            file.put(static_cast<char>(~origin.content[100]));
+        }
+        auto result = complete(client, destination);
+        CHECK(result.success);
+        CHECK(result.resumedBytes == chunk);
+        CHECK(result.sha256 == expected);
+        CHECK(readFile(destination) == origin.content);
+    }
+
+    // A state file cut short (e.g. by a crash) is ignored and the download starts over
+    {
+        std::filesystem::remove(destination);
+        interrupted(client, destination, 2 * chunk + chunk / 2);
+        std::string saved = readFile(state);
+        CHECK(saved.size() > 10);
+        std::filesystem::resize_file(state, saved.size() / 2);
+
+        auto result = complete(client, destination);
+        CHECK(result.success);
+        CHECK(result.resumedBytes == 0);
+        CHECK(result.sha256 == expected);
+        CHECK(readFile(destination) == origin.content);
+    }
+
+    // A server that ignores Range sends the whole file, which replaces the partial one
+    {
+        std::filesystem::remove(destination);
+        interrupted(client, destination, 2 * chunk + chunk / 2);
+        origin.ranges = false;
+        origin.rangeRequests = 0;
+        auto result = complete(client, destination);
+        CHECK(result.success);
+        CHECK(result.resumedBytes == 0);
+        CHECK(result.bytes == origin.content.size());
+        CHECK(result.sha256 == expected);
+        CHECK(readFile(destination) == origin.content);
+        CHECK(origin.rangeRequests == 0);
+        CHECK(!std::filesystem::exists(state));
+        origin.ranges = true;
+    }
+
+    // A new version on the server invalidates the recorded chunks
+    {
+        std::filesystem::remove(destination);
+        interrupted(client, destination, 2 * chunk + chunk / 2);
+        {
+            std::lock_guard<std::mutex> lock(origin.mutex);
+            origin.etag = "\"v2\"";
+            origin.content = makeContent(4 * chunk);
+        }
+        auto changed = complete(client, destination);
+        CHECK(!changed.success);
+        CHECK(changed.message == "File changed on the server, retry the download");
+        CHECK(!std::filesystem::exists(state));
+
+        auto result = complete(client, destination);
+        CHECK(result.success);
+        CHECK(result.resumedBytes == 0);
+        CHECK(result.sha256 == sha256(origin.content));
+        CHECK(std::filesystem::file_size(destination) == origin.content.size());
+    }
+
+    // The digest is checked against the expected one
+    {
+        DownloadOptions options;
+        options.chunkSize = chunk;
+        options.expectedSha256 = expected;
+        auto result = client.games.download("g1", destination, options);
+        CHECK(!result.success);
+        CHECK(result.message == "SHA-256 mismatch");
+    }
+
+    std::filesystem::remove_all(directory);
+    return test::result();
+}
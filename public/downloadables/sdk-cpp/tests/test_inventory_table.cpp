@@ -0,0 +1,94 @@
+// InventoryTable kernels against a plain loop over InventoryItem, on rows
+// decoded from the API's JSON, where flags come back as 0/1.
+
+#include "croissant_api.hpp"
+#include "test_util.hpp"
+#include <cmath>
+#include <string>
+
+using namespace CroissantAPI;
+
+namespace {
+
+// /inventory rows as the API sends them: MySQL flags as numbers
+const char* rows[] = {
+    R"({"user_id":"u1","itemId":"sword","owner":"smith","amount":2,"price":10.5,"showInStore":1,"sellable":1})",
+    R"({"user_id":"u1","itemId":"shield","owner":"smith","amount":1,"price":7.25,"showInStore":0,"sellable":0})",
+    R"({"user_id":"u1","itemId":"potion","owner":"alchemist","amount":12,"price":0.5,"showInStore":1})",
+    R"({"user_id":"u1","itemId":"relic","owner":"alchemist","amount":3,"price":99.0,"showInStore":true})",
+    R"({"user_id":"u1","itemId":"map","owner":"smith","amount":5,"price":1.0,"showInStore":false})",
+};
+
+bool near(double a, double b) {
+    return std::fabs(a - b) < 1e-9;
+}
+
+} // namespace
+
+int main() {
+    // Filled the way Inventory::getTable() does: projected straight from the raw rows
+    InventoryTable table;
+    for (const char* row : rows) {
+        InternedInventoryItem item;
+        detail::readProjected(row, item);
+        table.append(item);
+    }
+
+    // Regression: "showInStore":1 must count as shown
+    CHECK(table.size() == 5);
+    CHECK(table.showInStore()[0] == 1);
+    CHECK(table.showInStore()[1] == 0);
+    CHECK(table.showInStore()[2] == 1);
+    std::vector<std::uint32_t> shown = table.filterShowInStore(true);
+    CHECK((shown == std::vector<std::uint32_t>{0, 2, 3}));
+    CHECK((table.filterShowInStore(false) == std::vector<std::uint32_t>{1, 4}));
+
+    // Kernels agree with a loop over the row-oriented items
+    std::vector<InventoryItem> items;
+    InventoryTable fromItems;
+    for (const char* row : rows) {
+        items.emplace_back(json::parse(row));
+        fromItems.append(items.back());
+    }
+    double total = 0, totalShown = 0;
+    std::int64_t amount = 0;
+    for (const InventoryItem& item : items) {
+        total += item.price * item.amount;
+        amount += item.amount;
+        if (item.showInStore) totalShown += item.price * item.amount;
+    }
+    CHECK(items[0].showInStore);
+    CHECK(items[0].sellable == std::optional<bool>(true));
+    CHECK(!items[2].sellable);
+    CHECK(near(totalShown, 2 * 10.5 + 12 * 0.5 + 3 * 99.0));
+    for (const InventoryTable* t : {&table, &fromItems}) {
+        CHECK(near(t->totalValue(), total));
+        CHECK(near(t->totalValue(true), totalShown));
+        CHECK(near(t->totalValue(false), total - totalShown));
+        CHECK(t->totalAmount() == amount);
+        auto byOwner = t->valueByOwner();
+        CHECK(near(byOwner[Id("smith")], 2 * 10.5 + 7.25 + 5 * 1.0));
+        CHECK(near(byOwner[Id("alchemist")], 12 * 0.5 + 3 * 99.0));
+    }
+
+    // Long enough to run the vector loops and their scalar tails
+    InventoryTable large;
+    double largeTotal = 0;
+    std::size_t largeShown = 0;
+    for (int i = 0; i < 1003; ++i) {
+        InventoryItem item;
+        item.itemId = "item" + std::to_string(i);
+        item.owner = "owner" + std::to_string(i % 7);
+        item.amount = i % 13;
+        item.price = (i % 101) * 0.25;
+        item.showInStore = i % 3 == 0;
+        largeTotal += item.price * item.amount;
+        largeShown += item.showInStore ? 1 : 0;
+        large.append(item);
+    }
+    CHECK(near(large.totalValue(), largeTotal));
+    CHECK(large.filterShowInStore(true).size() == largeShown);
+    CHECK(large.filterShowInStore(false).size() == large.size() - largeShown);
+
+    return test::result();
+}
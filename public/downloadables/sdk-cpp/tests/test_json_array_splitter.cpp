@@ -0,0 +1,149 @@
+// detail::JsonArraySplitter hands out the elements of the target array
+// whatever the chunking: strings holding quotes, brackets and commas, nested
+// arrays, a keyed array inside an object (the rest of which is kept), a
+// consumer that stops early and one that throws.
+
+#include "croissant_api.hpp"
+#include "test_util.hpp"
+
+#include <stdexcept>
+
+using namespace CroissantAPI;
+
+namespace {
+
+struct Split {
+    std::vector<std::string> elements;
+    std::string remainder;
+    bool completed = true;
+};
+
+// Feeds `document` in pieces cut at `cuts`; the consumer stops after `limit` elements
+Split split(std::string_view document, const std::string& arrayKey, const std::vector<std::size_t>& cuts,
+            std::size_t limit = SIZE_MAX) {
+    Split result;
+    std::function<bool(std::string_view)> onElement = [&result, limit](std::string_view element) {
+        result.elements.emplace_back(element);
+        return result.elements.size() < limit;
+    };
+    detail::JsonArraySplitter splitter(arrayKey, onElement);
+    std::size_t at = 0;
+    for (std::size_t cut : cuts) {
+        if (result.completed) result.completed = splitter.feed(document.substr(at, cut - at));
+        at = cut;
+    }
+    if (result.completed) result.completed = splitter.feed(document.substr(at));
+    result.remainder = splitter.remainder();
+    return result;
+}
+
+// Every way of cutting `document` once, then one byte at a time
+std::vector<std::vector<std::size_t>> chunkings(std::string_view document) {
+    std::vector<std::vector<std::size_t>> all{{}};
+    std::vector<std::size_t> bytes;
+    for (std::size_t i = 1; i < document.size(); ++i) {
+        all.push_back({i});
+        bytes.push_back(i);
+    }
+    all.push_back(bytes);
+    return all;
+}
+
+} // namespace
+
+int main() {
+    // Top-level array: escaped quotes, brackets and commas inside strings, nested arrays
+    {
+        const std::string document =
+            R"([{"name":"say \"hi\", ]"},"[not, an] {array}",[[1,2],[3,[4]]],"back\\",{"tags":["a]","b"]}])";
+        const std::vector<std::string> expected{
+            R"({"name":"say \"hi\", ]"})",
+            R"("[not, an] {array}")",
+            R"([[1,2],[3,[4]]])",
+            R"("back\\")",
+            R"({"tags":["a]","b"]})",
+        };
+        for (const auto& cuts : chunkings(document)) {
+            Split result = split(document, "", cuts);
+            CHECK(result.completed);
+            CHECK(result.elements == expected);
+            CHECK(result.remainder == "[]");
+        }
+    }
+
+    // Keyed array inside an object: other arrays and a nested member of the
+    // same name are left alone, and the remainder still parses
+    {
+        const std::string document =
+            R"({"user_id":"u\"1","meta":{"inventory":[9]},"other":[1,2],"inventory":[{"a":[1]},{"b":"],"}],)"
+            R"("message":"ok"})";
+        const std::vector<std::string> expected{R"({"a":[1]})", R"({"b":"],"})"};
+        for (const auto& cuts : chunkings(document)) {
+            Split result = split(document, "inventory", cuts);
+            CHECK(result.completed);
+            CHECK(result.elements == expected);
+            CHECK(result.remainder ==
+                  R"({"user_id":"u\"1","meta":{"inventory":[9]},"other":[1,2],"inventory":[],"message":"ok"})");
+        }
+        json rest = json::parse(split(document, "inventory", {}).remainder);
+        CHECK(rest["user_id"] == "u\"1");
+        CHECK(rest["message"] == "ok");
+    }
+
+    // A missing key leaves every byte in the remainder
+    {
+        const std::string document = R"({"message":"Not found","items":[1]})";
+        Split result = split(document, "inventory", {});
+        CHECK(result.elements.empty());
+        CHECK(result.remainder == document);
+    }
+
+    // Whitespace between elements is skipped
+    {
+        Split result = split("[ 1 ,\n 2 ,\r\n\t3 ]", "", {});
+        CHECK(result.elements.size() == 3);
+        for (std::size_t i = 0; i < result.elements.size(); ++i) {
+            CHECK(json::parse(result.elements[i]) == i + 1);
+        }
+    }
+
+    // Early stop: nothing is handed out after the consumer returns false
+    {
+        const std::string document = R"([{"id":1},{"id":2},{"id":3},{"id":4}])";
+        for (const auto& cuts : chunkings(document)) {
+            Split result = split(document, "", cuts, 2);
+            CHECK(!result.completed);
+            CHECK(result.elements.size() == 2);
+            CHECK(result.elements.back() == R"({"id":2})");
+        }
+        std::function<bool(std::string_view)> stopAtOnce = [](std::string_view) { return false; };
+        detail::JsonArraySplitter splitter("", stopAtOnce);
+        CHECK(!splitter.feed(document));
+        CHECK(splitter.stopped());
+        CHECK(!splitter.failure());
+    }
+
+    // A consumer that throws stops the split and its exception is kept
+    {
+        int seen = 0;
+        std::function<bool(std::string_view)> onElement = [&seen](std::string_view element) {
+            ++seen;
+            if (element == "2") throw std::runtime_error("bad element");
+            return true;
+        };
+        detail::JsonArraySplitter splitter("", onElement);
+        CHECK(!splitter.feed("[1,2,3]"));
+        CHECK(seen == 2);
+        CHECK(splitter.stopped());
+        CHECK(splitter.failure() != nullptr);
+        bool rethrown = false;
+        try {
+            std::rethrow_exception(splitter.failure());
+        } catch (const std::runtime_error& error) {
+            rethrown = std::string(error.what()) == "bad element";
+        }
+        CHECK(rethrown);
+    }
+
+    return test::result();
+}
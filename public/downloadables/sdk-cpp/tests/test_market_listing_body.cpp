@@ -0,0 +1,44 @@
+// Market::create echoes the InventoryItem it was given back to the server,
+// which refuses the listing unless `sellable` is true. Items read from the
+// API carry the flag as 0/1 and must still be sent as sellable.
+
+#include "croissant_api.hpp"
+#include "test_util.hpp"
+
+using namespace CroissantAPI;
+
+namespace {
+
+// Serialized the way Market::create builds its body
+json listingBody(const InventoryItem& item, double sellingPrice) {
+    std::string body;
+    detail::JsonWriter(body).beginObject()
+        .member("inventoryItem", item)
+        .member("sellingPrice", sellingPrice)
+        .endObject();
+    return json::parse(body);
+}
+
+} // namespace
+
+int main() {
+    InventoryItem sellable(json::parse(
+        R"({"user_id":"u1","item_id":"i1","amount":1,"itemId":"sword","name":"Sword","description":"",
+            "iconHash":"abc","price":10.5,"owner":"smith","showInStore":1,"sellable":1,
+            "metadata":{"_unique_id":"uid-1"}})"));
+    CHECK(sellable.sellable == std::optional<bool>(true));
+    json body = listingBody(sellable, 12.0);
+    CHECK(body["inventoryItem"]["sellable"] == true);
+    CHECK(body["inventoryItem"]["showInStore"] == true);
+    CHECK(body["inventoryItem"]["metadata"]["_unique_id"] == "uid-1");
+    CHECK(body["sellingPrice"] == 12.0);
+
+    InventoryItem locked(json::parse(R"({"itemId":"relic","amount":1,"price":1,"sellable":0})"));
+    CHECK(listingBody(locked, 1.0)["inventoryItem"]["sellable"] == false);
+
+    // A missing flag stays unset rather than being sent as false
+    InventoryItem unknown(json::parse(R"({"itemId":"map","amount":1,"price":1})"));
+    CHECK(!listingBody(unknown, 1.0)["inventoryItem"].contains("sellable"));
+
+    return test::result();
+}
@@ -0,0 +1,56 @@
+// Decoding from a json&& moves strings and nested values out of the document
+// and yields the same objects as decoding from a const json&.
+
+#include "croissant_api.hpp"
+#include "test_util.hpp"
+
+using namespace CroissantAPI;
+
+namespace {
+
+const char* inventoryBody = R"([
+    {"user_id":"u1","item_id":"i1","amount":2,"itemId":"sword","name":"Sword of the Morning Star",
+     "description":"A long description that does not fit in the small string buffer","iconHash":"abc",
+     "price":10.5,"owner":"smith","showInStore":1,"sellable":0,"purchasePrice":null,
+     "metadata":{"_unique_id":"uid-1","enchantments":["fire","frost"],"level":7}},
+    {"user_id":"u1","item_id":"i2","amount":1,"itemId":"shield","name":"Shield",
+     "description":"Another description long enough to live on the heap, not inline","iconHash":"def",
+     "price":7.25,"owner":"smith","showInStore":true,"metadata":"{\"_unique_id\":\"uid-2\"}"}
+])";
+
+} // namespace
+
+int main() {
+    json document = json::parse(inventoryBody);
+
+    std::vector<InventoryItem> copied;
+    CHECK(detail::Codec<std::vector<InventoryItem>>::read(document, copied));
+    std::vector<InventoryItem> moved;
+    CHECK(detail::Codec<std::vector<InventoryItem>>::read(std::move(document), moved));
+
+    CHECK(moved.size() == 2);
+    for (std::size_t i = 0; i < moved.size() && i < copied.size(); ++i) {
+        CHECK(moved[i].to_json() == copied[i].to_json());
+    }
+    CHECK(moved[0].showInStore);
+    CHECK(moved[0].sellable == std::optional<bool>(false));
+    CHECK(moved[0].metadata && moved[0].metadata->get("enchantments")->size() == 2);
+    CHECK(moved[1].metadata && *moved[1].metadata->get("_unique_id") == "uid-2");
+
+    // The strings were taken from the document rather than copied out of it
+    CHECK(document[0]["description"].get_ref<const std::string&>().empty());
+    CHECK(document[1]["name"].get_ref<const std::string&>().empty());
+    CHECK(document[0]["metadata"]["enchantments"].is_null());
+
+    // Wrong-typed values are still skipped on the move path
+    json wrong = json::parse(R"({"gameId":7,"name":"Game","price":"free","showInStore":1,"platforms":"pc"})");
+    Game game;
+    CHECK(detail::Codec<Game>::read(std::move(wrong), game));
+    CHECK(game.gameId.empty());
+    CHECK(game.name == "Game");
+    CHECK(game.price == 0);
+    CHECK(game.showInStore);
+    CHECK(!game.platforms);
+
+    return test::result();
+}
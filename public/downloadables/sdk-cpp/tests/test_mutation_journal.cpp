@@ -0,0 +1,303 @@
+// MutationJournal against a loopback stand-in and a log file damaged the way
+// crashes leave it: torn last records and the zero-filled tail of the mapped
+// growth step are dropped on open, settled entries are compacted away, and
+// replay() resends only what the server cannot have applied unless told to.
+
+#include "croissant_api.hpp"
+#include "test_server.hpp"
+#include "test_util.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+using namespace CroissantAPI;
+
+namespace {
+
+std::string readFile(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::filesystem::path& path, const std::string& data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << data;
+}
+
+// Start of every record after the 8-byte file header, then the end of the last
+// whole one. A record is a little-endian payload length, a CRC and a type byte
+// followed by the payload.
+std::vector<std::size_t> recordOffsets(const std::string& log) {
+    std::vector<std::size_t> offsets;
+    std::size_t at = 8;
+    while (log.size() - at >= 9) {
+        std::uint32_t length = 0;
+        for (int i = 3; i >= 0; --i) {
+            length = (length << 8) | static_cast<unsigned char>(log[at + i]);
+        }
+        if (length > log.size() - at - 9) break;
+        offsets.push_back(at);
+        at += 9 + length;
+    }
+    offsets.push_back(at);
+    return offsets;
+}
+
+// Answers every request with `status` and remembers each Idempotency-Key
+struct Api {
+    std::atomic<int> status{200};
+    std::mutex mutex;
+    std::vector<std::string> keys;
+    std::vector<std::string> targets;
+
+    test::Reply operator()(const test::Request& request) {
+        std::lock_guard<std::mutex> lock(mutex);
+        keys.push_back(request.header("idempotency-key"));
+        targets.push_back(request.target);
+        test::Reply reply;
+        reply.status = status;
+        reply.headers.emplace_back("Content-Type", "application/json");
+        reply.body = "{\"message\":\"ok\"}";
+        return reply;
+    }
+
+    std::size_t count() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return keys.size();
+    }
+};
+
+} // namespace
+
+int main() {
+    Api api;
+    test::Server server([&api](const test::Request& request) { return api(request); });
+    Client client("secret");
+    client.setBaseUrl(server.url() + "/api");
+
+    auto directory = std::filesystem::temp_directory_path() / ("croissant_journal_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(directory);
+    auto path = directory / "mutations.log";
+
+    // Answers settle an entry (2xx, 4xx), keep it as uncertain (5xx) or as
+    // never sent (429), and all of that survives a reopen
+    std::string uncertainKey;
+    std::string unsentKey;
+    {
+        MutationJournal journal(client, path);
+        CHECK(journal.give("sword", 1, "u1"));
+        CHECK(journal.size() == 0);
+
+        api.status = 404;
+        CHECK(!journal.give("sword", 1, "u1"));
+        CHECK(journal.size() == 0);
+
+        api.status = 500;
+        auto failed = journal.consume("shield", "u1", 2);
+        CHECK(!failed && failed.error().status == 500);
+        api.status = 429;
+        CHECK(!journal.buy("potion", 3));
+
+        auto pending = journal.pending();
+        CHECK(pending.size() == 2);
+        CHECK(pending[0].kind == MutationKind::Consume && pending[0].uncertain);
+        CHECK(pending[0].endpoint == "/items/consume/shield");
+        CHECK(pending[1].kind == MutationKind::Buy && !pending[1].uncertain);
+        CHECK(pending[1].method == "POST");
+        uncertainKey = pending[0].key;
+        unsentKey = pending[1].key;
+        CHECK(uncertainKey.size() == 32 && uncertainKey != unsentKey);
+    }
+    {
+        MutationJournal journal(client, path);
+        auto pending = journal.pending();
+        CHECK(pending.size() == 2);
+        CHECK(pending[0].key == uncertainKey && pending[0].uncertain);
+        CHECK(pending[1].key == unsentKey && !pending[1].uncertain);
+        CHECK(pending[1].body.find("\"amount\":3") != std::string::npos);
+
+        // Only the entry the server never saw is resent, under its original key
+        api.status = 200;
+        std::size_t before = api.count();
+        JournalReplay replayed = journal.replay();
+        CHECK(replayed.acknowledged == 1);
+        CHECK(replayed.rejected == 0);
+        CHECK(replayed.pending == 1);
+        CHECK(api.count() == before + 1);
+        std::lock_guard<std::mutex> lock(api.mutex);
+        CHECK(api.keys.back() == unsentKey);
+        CHECK(api.targets.back() == "/api/items/buy/potion");
+    }
+    {
+        // Uncertain entries go out only when asked for; 4xx settles them
+        JournalOptions options;
+        options.replayUncertain = true;
+        MutationJournal journal(client, path, options);
+        CHECK(journal.size() == 1);
+        api.status = 400;
+        JournalReplay replayed = journal.replay();
+        CHECK(replayed.rejected == 1);
+        CHECK(replayed.pending == 0);
+        std::lock_guard<std::mutex> lock(api.mutex);
+        CHECK(api.keys.back() == uncertainKey);
+    }
+    {
+        MutationJournal journal(client, path);
+        CHECK(journal.size() == 0);
+        CHECK(journal.replay().pending == 0);
+    }
+    std::filesystem::remove(path);
+
+    // resolve() settles an entry without sending it
+    {
+        api.status = 503;
+        MutationJournal journal(client, path);
+        journal.give("gem", 1, "u1");
+        journal.give("gem", 2, "u1");
+        auto pending = journal.pending();
+        CHECK(pending.size() == 2);
+        CHECK(journal.resolve(pending[0].key));
+        CHECK(!journal.resolve(pending[0].key));
+        CHECK(!journal.resolve("not-a-key"));
+        CHECK(journal.size() == 1);
+    }
+    {
+        MutationJournal journal(client, path);
+        CHECK(journal.size() == 1);
+        CHECK(journal.pending()[0].body.find("\"amount\":2") != std::string::npos);
+    }
+    std::filesystem::remove(path);
+
+    // A crash mid-write leaves a torn last record: the entry it belonged to is
+    // dropped, the tail is cut off, and new records follow the last good one
+    {
+        api.status = 500;
+        {
+            MutationJournal journal(client, path);
+            journal.give("a", 1, "u1");
+            journal.give("b", 1, "u1");
+        }
+        std::string log = readFile(path);
+        auto offsets = recordOffsets(log);
+        // Append and Sent for each of the two entries
+        CHECK(offsets.size() == 5);
+        CHECK(offsets.back() == log.size());
+        std::size_t cut = offsets[2] + (offsets[3] - offsets[2]) / 2;
+        writeFile(path, log.substr(0, cut));
+
+        {
+            MutationJournal journal(client, path);
+            auto pending = journal.pending();
+            CHECK(pending.size() == 1);
+            CHECK(pending[0].endpoint == "/items/give/a");
+            journal.give("c", 1, "u1");
+        }
+        std::string repaired = readFile(path);
+        CHECK(repaired.compare(0, offsets[2], log, 0, offsets[2]) == 0);
+        CHECK(recordOffsets(repaired).back() == repaired.size());
+
+        MutationJournal journal(client, path);
+        auto pending = journal.pending();
+        CHECK(pending.size() == 2);
+        CHECK(pending[0].endpoint == "/items/give/a");
+        CHECK(pending[1].endpoint == "/items/give/c");
+    }
+    std::filesystem::remove(path);
+
+    // The zeroed rest of the mapped growth step, or bytes that fail their CRC,
+    // end the log
+    {
+        api.status = 500;
+        {
+            MutationJournal journal(client, path);
+            journal.give("a", 1, "u1");
+        }
+        std::string log = readFile(path);
+        writeFile(path, log + std::string(8192, '\0'));
+        {
+            MutationJournal journal(client, path);
+            CHECK(journal.size() == 1);
+            journal.give("b", 1, "u1");
+        }
+        CHECK(recordOffsets(readFile(path)).back() == readFile(path).size());
+
+        std::string garbage(64, '\x5a');
+        garbage[0] = 16;
+        garbage[1] = garbage[2] = garbage[3] = 0;
+        writeFile(path, readFile(path) + garbage);
+        MutationJournal journal(client, path);
+        auto pending = journal.pending();
+        CHECK(pending.size() == 2);
+        CHECK(pending[1].endpoint == "/items/give/b");
+    }
+    std::filesystem::remove(path);
+
+    // A foreign file is refused rather than overwritten
+    {
+        writeFile(path, "not a journal at all");
+        bool threw = false;
+        try {
+            MutationJournal journal(client, path);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+        CHECK(readFile(path) == "not a journal at all");
+    }
+    std::filesystem::remove(path);
+
+    // Settled entries are compacted away through a staging file and rename;
+    // the reopened log holds only what is still pending
+    {
+        auto staging = path;
+        staging += ".compact";
+        std::string keep;
+        {
+            JournalOptions options;
+            options.growBy = 4096;
+            MutationJournal journal(client, path, options);
+            api.status = 500;
+            journal.give("kept", 7, "u1");
+            keep = journal.pending()[0].key;
+            api.status = 200;
+            for (int i = 0; i < 100; ++i) {
+                CHECK(journal.give("sword", 1, "u1"));
+            }
+            CHECK(journal.size() == 1);
+            CHECK(!std::filesystem::exists(staging));
+        }
+        // Without compaction the settled records alone would take several steps
+        CHECK(std::filesystem::file_size(path) < 4096);
+
+        {
+            MutationJournal journal(client, path);
+            auto pending = journal.pending();
+            CHECK(pending.size() == 1);
+            CHECK(pending[0].key == keep && pending[0].uncertain);
+
+            // An explicit compact() after settling leaves just the file header,
+            // replacing a staging file a crash left behind
+            writeFile(staging, "stale");
+            CHECK(journal.resolve(keep));
+            journal.compact();
+            CHECK(!std::filesystem::exists(staging));
+            CHECK(journal.size() == 0);
+
+            api.status = 500;
+            journal.give("after", 1, "u1");
+        }
+        std::string log = readFile(path);
+        auto offsets = recordOffsets(log);
+        CHECK(offsets.size() == 3);
+        CHECK(offsets.back() == log.size());
+
+        MutationJournal journal(client, path);
+        auto pending = journal.pending();
+        CHECK(pending.size() == 1);
+        CHECK(pending[0].endpoint == "/items/give/after");
+    }
+
+    std::filesystem::remove_all(directory);
+    return test::result();
+}
@@ -0,0 +1,92 @@
+// OrderBook applies each snapshot as a difference against the previous one:
+// orders that appear are placed, repriced ones move level, and orders missing
+// from the new snapshot are removed.
+
+#include "croissant_api.hpp"
+#include "test_util.hpp"
+
+using namespace CroissantAPI;
+
+namespace {
+
+MarketListing listing(const std::string& id, double price, const std::string& item = "sword",
+                      const std::string& status = "active") {
+    MarketListing l;
+    l.id = id;
+    l.item_id = item;
+    l.price = price;
+    l.status = status;
+    return l;
+}
+
+BuyOrder bid(const std::string& id, double price) {
+    BuyOrder b;
+    b.id = id;
+    b.item_id = "sword";
+    b.price = price;
+    b.status = "active";
+    return b;
+}
+
+std::vector<double> prices(const std::vector<PriceLevel>& levels) {
+    std::vector<double> out;
+    for (const PriceLevel& level : levels) out.push_back(level.price);
+    return out;
+}
+
+} // namespace
+
+int main() {
+    OrderBook book("sword");
+
+    // First snapshot: everything is new; other items and inactive orders are ignored
+    CHECK(book.applyListings({listing("a1", 10), listing("a2", 10), listing("a3", 12),
+                              listing("x1", 1, "shield"), listing("s1", 5, "sword", "sold")}) == 3);
+    CHECK(book.applyBuyOrders({bid("b1", 8), bid("b2", 9)}) == 2);
+    CHECK(book.askOrders() == 3);
+    CHECK(book.askLevels() == 2);
+    CHECK(book.asksAt(10) == 2);
+    CHECK(book.bestAsk() && book.bestAsk()->price == 10);
+    CHECK(book.bestBid() && book.bestBid()->price == 9);
+    CHECK(book.spread() == std::optional<double>(1));
+
+    // Same snapshot again: nothing changes
+    CHECK(book.applyListings({listing("a1", 10), listing("a2", 10), listing("a3", 12)}) == 0);
+
+    // Second snapshot: a1 filled (removed), a2 repriced to 11, a4 added at 12
+    CHECK(book.applyListings({listing("a2", 11), listing("a3", 12), listing("a4", 12)}) == 3);
+    CHECK((prices(book.askDepth(10)) == std::vector<double>{11, 12}));
+    CHECK(book.asksAt(10) == 0);
+    CHECK(book.asksAt(11) == 1);
+    CHECK(book.asksAt(12) == 2);
+    CHECK(book.askOrders() == 3);
+    CHECK(book.askDepth(1).size() == 1);
+    CHECK((book.askDepth(10)[1].orderIds == std::vector<std::string>{"a3", "a4"}));
+
+    // Applying one side leaves the other alone
+    CHECK(book.bidOrders() == 2);
+    CHECK((prices(book.bidDepth(10)) == std::vector<double>{9, 8}));
+
+    // An order that moves from the asks to the bids is repriced, not duplicated
+    CHECK(book.applyBuyOrders({bid("b1", 8), bid("b2", 9), bid("a3", 7)}) == 1);
+    CHECK(book.bidOrders() == 3);
+    CHECK(book.askOrders() == 2);
+    CHECK(book.asksAt(12) == 1);
+
+    // Erasing twice, or an unknown order, is harmless
+    CHECK(book.erase("a4"));
+    CHECK(!book.erase("a4"));
+    CHECK(!book.erase("missing"));
+    CHECK(book.askOrders() == 1);
+    CHECK(book.asksAt(12) == 0);
+
+    // An empty snapshot clears the side
+    CHECK(book.applyListings({}) == 1);
+    CHECK(book.bestAsk() == nullptr);
+    CHECK(!book.spread());
+
+    book.clear();
+    CHECK(book.bidOrders() == 0 && book.bidLevels() == 0);
+
+    return test::result();
+}
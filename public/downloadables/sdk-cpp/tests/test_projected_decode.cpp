@@ -0,0 +1,87 @@
+// detail::readProjected decodes members straight from the JSON text and yields
+// the same objects as detail::readObject on the parsed document: escapes and
+// surrogate pairs, integers written as floats, 0/1 booleans, null optionals,
+// values of the wrong type and undeclared members. Malformed text makes it
+// return false instead of throwing.
+
+#include "croissant_api.hpp"
+#include "test_util.hpp"
+
+using namespace CroissantAPI;
+
+namespace {
+
+template <typename T>
+bool sameAsParsed(std::string_view text) {
+    T parsed;
+    detail::readObject(json::parse(text), parsed);
+    T projected;
+    bool read = detail::readProjected(text, projected);
+    return read && detail::writeObject(parsed) == detail::writeObject(projected);
+}
+
+template <typename T>
+bool rejected(std::string_view text) {
+    T object;
+    try {
+        return !detail::readProjected(text, object);
+    } catch (...) {
+        return false;
+    }
+}
+
+} // namespace
+
+int main() {
+    CHECK(sameAsParsed<Item>(
+        R"({"itemId":"sword","name":"Café \"Sword\" \\ \/ \b\f\n\r\t","description":"grin 😀",)"
+        R"("owner":"smith","price":10,"iconHash":null,"showInStore":1,"deleted":false,"extra":{"x":[1,"]"]}})"));
+    CHECK(sameAsParsed<Item>(R"( { "itemId" : "a" , "price" : -2.5e1 , "showInStore" : true } )"));
+    CHECK(sameAsParsed<Item>(R"({"itemId":5,"name":["x"],"price":"12","showInStore":"yes"})"));
+    CHECK(sameAsParsed<Item>("{}"));
+
+    CHECK(sameAsParsed<InventoryItem>(
+        R"({"user_id":"u1","item_id":"i1","amount":2.9,"itemId":"sword","name":"Sword","price":7.25,)"
+        R"("showInStore":0,"sellable":1,"purchasePrice":null,"rarity":"rare",)"
+        R"("metadata":{"_unique_id":"uid-1","enchantments":["fire","frost"],"level":7}})"));
+    CHECK(sameAsParsed<InventoryItem>(R"({"amount":-3,"purchasePrice":12.5,"metadata":"{\"_unique_id\":\"uid-2\"}"})"));
+
+    CHECK(sameAsParsed<Game>(
+        R"({"gameId":"g1","name":"Quest","price":0,"showInStore":true,"platforms":["win","linux"],)"
+        R"("rating":4.5,"multiplayer":1,"release_date":null,"genre":"RPG"})"));
+
+    CHECK(sameAsParsed<InternedInventoryItem>(R"({"user_id":"u1","item_id":"i1","amount":3,"itemId":"sword"})"));
+
+    {
+        Item item;
+        CHECK(detail::readProjected(R"({"name":"plain"})", item));
+        CHECK(item.name == "plain");
+        int amount = 0;
+        CHECK(detail::readJsonNumber("3000000000", amount));
+        CHECK(amount == std::numeric_limits<int>::max());
+    }
+
+    CHECK(rejected<Item>(""));
+    CHECK(rejected<Item>("[]"));
+    CHECK(rejected<Item>(R"({"itemId":"a")"));
+    CHECK(rejected<Item>(R"({"itemId":"a",})"));
+    CHECK(rejected<Item>(R"({"itemId" "a"})"));
+    CHECK(rejected<Item>(R"({"itemId":"a\q"})"));
+    CHECK(rejected<Item>(R"({"itemId":"a\u12"})"));
+    CHECK(rejected<Item>(R"({"itemId":"\ud83d"})"));
+    CHECK(rejected<Item>(R"({"itemId":"\ude00"})"));
+    CHECK(rejected<Item>(R"({"itemId":"a\"})"));
+    CHECK(rejected<Item>(R"({"price":1x})"));
+    CHECK(rejected<Item>(R"({"showInStore":tru})"));
+    CHECK(rejected<InventoryItem>(R"({"amount":--1})"));
+    CHECK(rejected<InventoryItem>(R"({"metadata":{"a":}})"));
+
+    {
+        // Members before the malformed one are kept
+        Item item;
+        CHECK(!detail::readProjected(R"({"itemId":"kept","price":oops})", item));
+        CHECK(item.itemId == "kept");
+    }
+
+    return test::result();
+}
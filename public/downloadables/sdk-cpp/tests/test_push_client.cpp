@@ -0,0 +1,140 @@
+// PushClient against a loopback event stream: it reconnects with
+// Last-Event-ID after the stream ends, honours "retry:", runs handlers in
+// stream order, and stops for good on 204 or a non-retryable 4xx while 429
+// is retried.
+
+#include "croissant_api.hpp"
+#include "test_server.hpp"
+#include "test_util.hpp"
+
+using namespace CroissantAPI;
+
+namespace {
+
+template <typename Condition>
+bool waitFor(Condition condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+test::Reply stream(std::vector<std::string> parts) {
+    test::Reply reply;
+    reply.headers.emplace_back("Content-Type", "text/event-stream");
+    reply.headers.emplace_back("Cache-Control", "no-cache");
+    reply.parts = std::move(parts);
+    return reply;
+}
+
+void resumesAndStopsOn204() {
+    std::mutex mutex;
+    std::vector<std::string> resumeIds;
+    std::vector<std::string> calls;
+
+    test::Server server([&](const test::Request& request) {
+        std::size_t connection;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            resumeIds.push_back(request.header("last-event-id"));
+            connection = resumeIds.size();
+        }
+        CHECK(request.header("accept") == "text/event-stream");
+        switch (connection) {
+            case 1:
+                return stream({"retry: 20\n: hello\n\n", "id: 1\nevent: a\ndata: one\n\n", "id: 2\nevent: b\nda",
+                               "ta: two\n\n"});
+            case 2:
+                return stream({"id: 3\nevent: a\ndata: three\r\n\r\n"});
+            default:
+                return test::Reply{204};
+        }
+    });
+    Client client;
+    PushOptions options;
+    options.url = server.url() + "/events";
+    options.reconnectDelay = std::chrono::seconds(30); // replaced by the stream's retry: 20
+    PushClient push(client, options);
+    push.subscribe("a", [&](const PushEvent& event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        calls.push_back("a:" + event.data);
+    });
+    push.subscribe("", [&](const PushEvent& event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        calls.push_back("*:" + event.data + "#" + event.id);
+    });
+    push.start();
+
+    CHECK(waitFor([&] { return push.state() == PushState::Closed; }));
+    CHECK(waitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return calls.size() == 5;
+    }));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK(resumeIds == std::vector<std::string>({"", "2", "3"}));
+    CHECK(calls == std::vector<std::string>({"a:one", "*:one#1", "*:two#2", "a:three", "*:three#3"}));
+    PushStats stats = push.stats();
+    CHECK(stats.connects == 2);
+    CHECK(stats.reconnects == 1);
+    CHECK(stats.events == 3);
+    CHECK(stats.comments == 1);
+    CHECK(push.lastEventId() == "3");
+}
+
+void stopsOnClientErrors() {
+    std::atomic<int> requests{0};
+    test::Server server([&](const test::Request&) {
+        // 429 is retried; 403 is final
+        return test::Reply{++requests == 1 ? 429 : 403};
+    });
+    Client client;
+    PushOptions options;
+    options.url = server.url() + "/events";
+    options.reconnectDelay = std::chrono::milliseconds(10);
+    PushClient push(client, options);
+    push.start();
+
+    CHECK(waitFor([&] { return requests == 2 && push.state() == PushState::Closed; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(requests == 2);
+    CHECK(push.stats().connects == 0);
+
+    // start() after the server closed the stream connects again
+    push.start();
+    CHECK(waitFor([&] { return requests == 3 && push.state() == PushState::Closed; }));
+}
+
+void reconnectsAfterServerErrors() {
+    std::atomic<int> requests{0};
+    test::Server server([&](const test::Request&) {
+        int n = ++requests;
+        if (n <= 2) return test::Reply{503};
+        return n == 3 ? stream({"data: up\n\n"}) : test::Reply{204};
+    });
+    Client client;
+    PushOptions options;
+    options.url = server.url() + "/events";
+    options.reconnectDelay = std::chrono::milliseconds(5);
+    options.maxReconnectDelay = std::chrono::milliseconds(20);
+    PushClient push(client, options);
+    std::atomic<int> events{0};
+    push.subscribe("message", [&](const PushEvent& event) {
+        if (event.data == "up") ++events;
+    });
+    push.start();
+    CHECK(waitFor([&] { return push.state() == PushState::Closed && events == 1; }));
+    CHECK(requests == 4);
+    CHECK(push.stats().connects == 1);
+}
+
+} // namespace
+
+int main() {
+    resumesAndStopsOn204();
+    stopsOnClientErrors();
+    reconnectsAfterServerErrors();
+    return test::result();
+}
@@ -0,0 +1,169 @@
+// Client::search and trySearch against a loopback stand-in: maxPerSection
+// stops each section early and leaves the rest of it unparsed, parsing the
+// sections in parallel gives the same results as one after the other, and
+// HTTP, transport and malformed-body failures come back as typed errors.
+
+#include "croissant_api.hpp"
+#include "test_server.hpp"
+#include "test_util.hpp"
+
+using namespace CroissantAPI;
+
+namespace {
+
+json userJson(int i) {
+    return {{"userId", "user-" + std::to_string(i)},
+            {"username", "Player \"" + std::to_string(i) + "\" é"},
+            {"verified", i % 2},
+            {"balance", i * 1.5},
+            {"roles", {"player", "tester"}}};
+}
+
+json gameJson(int i) {
+    return {{"gameId", "game-" + std::to_string(i)},
+            {"name", "Quest " + std::to_string(i)},
+            {"description", std::string(200, 'd')},
+            {"price", i},
+            {"owner_id", "owner"},
+            {"showInStore", true},
+            {"rating", nullptr},
+            {"platforms", {"win", "linux"}},
+            {"multiplayer", i % 3 == 0}};
+}
+
+json itemJson(int i) {
+    return {{"itemId", "item-" + std::to_string(i)},
+            {"name", "Sword [" + std::to_string(i) + "]"},
+            {"description", "line\nbreak"},
+            {"owner", "smith"},
+            {"price", 0.25 * i},
+            {"iconHash", nullptr},
+            {"showInStore", 1}};
+}
+
+template <typename T>
+std::vector<json> written(const std::vector<T>& values) {
+    std::vector<json> out;
+    for (const auto& value : values) {
+        out.push_back(detail::writeObject(value));
+    }
+    return out;
+}
+
+bool same(const SearchResults& a, const SearchResults& b) {
+    return written(a.users) == written(b.users) && written(a.games) == written(b.games) &&
+           written(a.items) == written(b.items);
+}
+
+} // namespace
+
+int main() {
+    const std::size_t count = 300;
+    json document = {{"users", json::array()}, {"games", json::array()}, {"items", json::array()}};
+    for (int i = 0; i < int(count); ++i) {
+        document["users"].push_back(userJson(i));
+        document["games"].push_back(gameJson(i));
+        document["items"].push_back(itemJson(i));
+    }
+    const std::string body = document.dump();
+    // The first element of each section is well-formed, a later one is not
+    const std::string truncatedTail = R"({"users":[)" + userJson(0).dump() + "," + userJson(1).dump() +
+                                      R"(,{"userId":oops}],"games":[)" + gameJson(0).dump() +
+                                      R"(,{"gameId":"g","price":1x}],"items":[)" + itemJson(0).dump() +
+                                      R"(,{"itemId":"\q"}]})";
+
+    test::Server server([&](const test::Request& request) {
+        std::string prefix = "/api/search?q=";
+        if (request.target.rfind(prefix, 0) != 0) return test::Reply{404};
+        std::string query = request.target.substr(prefix.size());
+        if (query == "all") return test::Reply{200, {{"Content-Type", "application/json"}}, body};
+        if (query == "tail") return test::Reply{200, {{"Content-Type", "application/json"}}, truncatedTail};
+        if (query == "cut") return test::Reply{200, {}, body.substr(0, body.size() / 2)};
+        if (query == "boom") return test::Reply{500, {}, R"({"message":"boom"})"};
+        return test::Reply{200, {}, R"({"users":[],"games":[],"items":[]})"};
+    });
+
+    Client client;
+    client.setBaseUrl(server.url() + "/api");
+
+    // Serial and parallel parsing agree, on the whole response and when cut short
+    {
+        SearchOptions serial;
+        serial.parallelThreshold = SIZE_MAX;
+        SearchOptions parallel;
+        parallel.parallelThreshold = 0;
+
+        auto one = client.trySearch("all", serial);
+        auto other = client.trySearch("all", parallel);
+        CHECK(one && other);
+        if (one && other) {
+            CHECK(one->users.size() == count && one->games.size() == count && one->items.size() == count);
+            CHECK(same(*one, *other));
+            CHECK(one->users[3].username == "Player \"3\" é");
+            CHECK(one->users[3].verified);
+            CHECK(one->games[3].multiplayer);
+            CHECK(one->items[7].name == "Sword [7]");
+            CHECK(one->items[7].description == "line\nbreak");
+        }
+
+        serial.maxPerSection = 25;
+        parallel.maxPerSection = 25;
+        auto firstOne = client.trySearch("all", serial);
+        auto firstOther = client.trySearch("all", parallel);
+        CHECK(firstOne && firstOther);
+        if (firstOne && firstOther) {
+            CHECK(firstOne->users.size() == 25 && firstOne->games.size() == 25 && firstOne->items.size() == 25);
+            CHECK(same(*firstOne, *firstOther));
+            CHECK(firstOne->games.back().gameId == "game-24");
+        }
+    }
+
+    // maxPerSection stops before the malformed elements, which are never parsed
+    {
+        SearchOptions options;
+        options.maxPerSection = 1;
+        auto first = client.trySearch("tail", options);
+        CHECK(first);
+        if (first) {
+            CHECK(first->users.size() == 1 && first->games.size() == 1 && first->items.size() == 1);
+            CHECK(first->users[0].userId == "user-0");
+        }
+
+        options.maxPerSection = 2;
+        auto further = client.trySearch("tail", options);
+        CHECK(!further && further.error().code == ErrorCode::Parse);
+        CHECK(client.search("tail", options).users.empty());
+    }
+
+    // A body cut mid-way is a parse error however it is parsed
+    {
+        SearchOptions parallel;
+        parallel.parallelThreshold = 0;
+        auto cut = client.trySearch("cut");
+        auto cutParallel = client.trySearch("cut", parallel);
+        CHECK(!cut && cut.error().code == ErrorCode::Parse && cut.error().status == 200);
+        CHECK(!cutParallel && cutParallel.error().code == ErrorCode::Parse);
+    }
+
+    // HTTP and transport failures
+    {
+        auto failed = client.trySearch("boom");
+        CHECK(!failed);
+        if (!failed) {
+            CHECK(failed.error().code == ErrorCode::HttpStatus);
+            CHECK(failed.error().status == 500);
+            CHECK(failed.error().message == "boom");
+        }
+        CHECK(client.search("boom").games.empty());
+
+        auto none = client.trySearch("nothing");
+        CHECK(none && none->users.empty() && none->games.empty() && none->items.empty());
+
+        Client offline;
+        offline.setBaseUrl("http://127.0.0.1:1/api");
+        auto unreachable = offline.trySearch("all");
+        CHECK(!unreachable && unreachable.error().code == ErrorCode::Transport);
+    }
+
+    return test::result();
+}
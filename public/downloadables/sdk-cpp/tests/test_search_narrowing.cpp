@@ -0,0 +1,114 @@
+// Local narrowing of search answers must agree with the server's matching:
+// users by slug (NFKD-folded, letters and digits only, lowercase), games by
+// LOWER(name|description|genre) LIKE %q%, items by LOWER(name) LIKE %q%.
+
+#include "croissant_api.hpp"
+#include "test_util.hpp"
+
+using namespace CroissantAPI;
+
+namespace {
+
+User user(const std::string& name) {
+    User u;
+    u.userId = "id-" + name;
+    u.username = name;
+    u.verified = false;
+    return u;
+}
+
+Game game(const std::string& name, const std::string& description, std::optional<std::string> genre = std::nullopt) {
+    Game g;
+    g.gameId = "id-" + name;
+    g.name = name;
+    g.description = description;
+    g.genre = std::move(genre);
+    return g;
+}
+
+Item item(const std::string& name, const std::string& description = "") {
+    Item i;
+    i.itemId = "id-" + name;
+    i.name = name;
+    i.description = description;
+    return i;
+}
+
+template <typename T>
+std::vector<std::string> namesOf(const std::vector<T>& results) {
+    std::vector<std::string> names;
+    for (const auto& result : results) names.push_back(result.name);
+    return names;
+}
+
+std::vector<std::string> usernamesOf(const std::vector<User>& users) {
+    std::vector<std::string> names;
+    for (const auto& u : users) names.push_back(u.username);
+    return names;
+}
+
+} // namespace
+
+int main() {
+    // Keys arrive trimmed and ASCII-lowercased; LIKE wildcards and anything
+    // the server would fold need the server
+    CHECK(detail::narrowable("space quest 2"));
+    CHECK(detail::narrowable("a"));
+    CHECK(!detail::narrowable("50%"));
+    CHECK(!detail::narrowable("a_b"));
+    CHECK(!detail::narrowable("jean-luc"));
+    CHECK(!detail::narrowable("caf\xc3\xa9"));
+    CHECK(!detail::narrowable("\xce\xb1"));
+
+    // Slugs keep ASCII letters and digits only, like the server's slugify()
+    CHECK(detail::asciiSlug("Jean-Luc 42") == std::optional<std::string>("jeanluc42"));
+    CHECK(detail::asciiSlug("__x__") == std::optional<std::string>("x"));
+    CHECK(detail::asciiSlug("") == std::optional<std::string>(""));
+    CHECK(!detail::asciiSlug("Zo\xc3\xab"));
+
+    // Users match on the slug, so separators in names are skipped
+    {
+        SearchResults prefix;
+        prefix.users = {user("Jean-Luc"), user("Jeanne"), user("J_L_Cool"), user("Bob")};
+        auto narrowed = detail::narrowResults(prefix, "jeanl");
+        CHECK(narrowed);
+        CHECK(usernamesOf(narrowed->users) == std::vector<std::string>({"Jean-Luc"}));
+
+        // "j l" has the slug "jl", matched across the underscores
+        narrowed = detail::narrowResults(prefix, "j l");
+        CHECK(narrowed);
+        CHECK(usernamesOf(narrowed->users) == std::vector<std::string>({"J_L_Cool"}));
+
+        // A name that needs Unicode folding can't be matched locally
+        prefix.users.push_back(user("Zo\xc3\xab"));
+        CHECK(!detail::narrowResults(prefix, "zo"));
+    }
+
+    // Games match name, description or genre, case-insensitively
+    {
+        SearchResults prefix;
+        prefix.games = {game("Space Quest", "Point and click"), game("Starfield", "Open SPACE exploration"),
+                        game("Tetris", "Falling blocks", "Arcade"), game("Spacewar", "Duel", std::nullopt)};
+        auto narrowed = detail::narrowResults(prefix, "space");
+        CHECK(narrowed);
+        CHECK(namesOf(narrowed->games) == std::vector<std::string>({"Space Quest", "Starfield", "Spacewar"}));
+
+        narrowed = detail::narrowResults(prefix, "space q");
+        CHECK(namesOf(narrowed->games) == std::vector<std::string>({"Space Quest"}));
+
+        narrowed = detail::narrowResults(prefix, "arc");
+        CHECK(namesOf(narrowed->games) == std::vector<std::string>({"Tetris"}));
+        CHECK(narrowed->users.empty() && narrowed->items.empty());
+    }
+
+    // Items match on the name only
+    {
+        SearchResults prefix;
+        prefix.items = {item("Iron Sword", "sharp"), item("Shield", "blocks swords"), item("SWORDFISH")};
+        auto narrowed = detail::narrowResults(prefix, "sword");
+        CHECK(narrowed);
+        CHECK(namesOf(narrowed->items) == std::vector<std::string>({"Iron Sword", "SWORDFISH"}));
+    }
+
+    return test::result();
+}
@@ -0,0 +1,150 @@
+// SearchSession against a loopback stand-in: a query extending an answered
+// one is narrowed locally with no request, while queries the server would
+// match differently (non-ASCII, LIKE wildcards) and answers at the server's
+// result limit go back to the network.
+
+#include "croissant_api.hpp"
+#include "test_server.hpp"
+#include "test_util.hpp"
+
+using namespace CroissantAPI;
+
+namespace {
+
+json gameJson(const std::string& name) {
+    Game g;
+    g.gameId = "id-" + name;
+    g.name = name;
+    g.description = "";
+    g.price = 0;
+    g.owner_id = "owner";
+    g.showInStore = true;
+    g.rating = 0;
+    g.multiplayer = false;
+    return g.to_json();
+}
+
+json itemJson(const std::string& name) {
+    Item i;
+    i.itemId = "id-" + name;
+    i.name = name;
+    i.description = "";
+    i.owner = "owner";
+    i.price = 0;
+    i.iconHash = "";
+    return i.to_json();
+}
+
+template <typename Condition>
+bool waitFor(Condition condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    std::mutex mutex;
+    std::vector<std::string> queries;
+    std::vector<SearchUpdate> updates;
+
+    test::Server server([&](const test::Request& request) {
+        std::string prefix = "/api/search?q=";
+        if (request.target.rfind(prefix, 0) != 0) return test::Reply{404};
+        std::string query = request.target.substr(prefix.size());
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queries.push_back(query);
+        }
+        json body = {{"users", json::array()}, {"games", json::array()}, {"items", json::array()}};
+        if (query == "sp") {
+            body["games"] = {gameJson("Space Quest"), gameJson("Spark"), gameJson("Aspen")};
+        } else if (query == "ir") {
+            body["items"] = {itemJson("Iron"), itemJson("Iris"), itemJson("Irk"), itemJson("Mirror")};
+        } else if (query == "ir%25") {
+            body["items"] = {itemJson("Irk")};
+        }
+        test::Reply reply;
+        reply.headers.emplace_back("Content-Type", "application/json");
+        reply.body = body.dump();
+        return reply;
+    });
+    Client client;
+    client.setBaseUrl(server.url() + "/api");
+
+    SearchSessionOptions options;
+    options.debounce = std::chrono::milliseconds(1);
+    options.serverLimit = 4;
+    SearchSession session(client, [&](const SearchUpdate& update) {
+        std::lock_guard<std::mutex> lock(mutex);
+        updates.push_back(update);
+    }, options);
+
+    // Waits for the next answer and returns it
+    std::size_t seen = 0;
+    auto next = [&](const std::string& query) {
+        session.update(query);
+        CHECK(waitFor([&] {
+            std::lock_guard<std::mutex> lock(mutex);
+            return updates.size() > seen;
+        }));
+        std::lock_guard<std::mutex> lock(mutex);
+        return updates.at(seen++);
+    };
+    auto requestCount = [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return queries.size();
+    };
+
+    SearchUpdate answer = next("sp");
+    CHECK(answer.source == SearchSource::Network);
+    CHECK(answer.results->games.size() == 3);
+    CHECK(requestCount() == 1);
+
+    // Narrowed from "sp": "Aspen" does not contain "spa"
+    answer = next("Spa");
+    CHECK(answer.source == SearchSource::Narrowed);
+    CHECK(answer.query == "Spa");
+    CHECK(answer.results->games.size() == 2);
+    CHECK(requestCount() == 1);
+
+    answer = next("sp");
+    CHECK(answer.source == SearchSource::Cache);
+    CHECK(requestCount() == 1);
+
+    // Non-ASCII text is folded by the server, so it is asked
+    answer = next("sp\xc3\xa4");
+    CHECK(answer.source == SearchSource::Network);
+    CHECK(!answer.failed);
+    CHECK(requestCount() == 2);
+
+    // "ir" filled the section up to the server limit, so it may be cut short
+    answer = next("ir");
+    CHECK(answer.source == SearchSource::Network);
+    CHECK(answer.results->items.size() == 4);
+    answer = next("iro");
+    CHECK(answer.source == SearchSource::Network);
+    CHECK(requestCount() == 4);
+
+    // A LIKE wildcard is matched by the server
+    answer = next("ir%");
+    CHECK(answer.source == SearchSource::Network);
+    CHECK(answer.results->items.size() == 1);
+    CHECK(requestCount() == 5);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK(queries[3] == "iro");
+        CHECK(queries[4] == "ir%25");
+    }
+
+    SearchStats stats = session.stats();
+    CHECK(stats.requests == 5);
+    CHECK(stats.narrowed == 1);
+    CHECK(stats.cacheHits == 1);
+    CHECK(stats.failed == 0);
+    return test::result();
+}
@@ -0,0 +1,226 @@
+#pragma once
+// Loopback HTTP/1.1 stand-in for the Croissant API: every connection gets its
+// own thread, answers one request and is closed. POSIX sockets only.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace test {
+
+struct Request {
+    std::string method;
+    // Path and query, e.g. "/api/games?x=1"
+    std::string target;
+    // Lowercase names
+    std::map<std::string, std::string> headers;
+    std::string body;
+
+    std::string header(const std::string& name) const {
+        auto it = headers.find(name);
+        return it == headers.end() ? std::string() : it->second;
+    }
+};
+
+struct Reply {
+    int status = 200;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+    // When set, sent instead of `body` one write at a time with `pause` in
+    // between and no Content-Length, so the client sees them as they arrive
+    std::vector<std::string> parts;
+    std::chrono::milliseconds pause{20};
+};
+
+class Server {
+public:
+    using Handler = std::function<Reply(const Request&)>;
+
+    explicit Server(Handler handler) : handler(std::move(handler)) {
+        listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        int yes = 1;
+        ::setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t size = sizeof(address);
+        if (::bind(listener, reinterpret_cast<sockaddr*>(&address), size) != 0 || ::listen(listener, 64) != 0 ||
+            ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &size) != 0) {
+            std::abort();
+        }
+        port = ntohs(address.sin_port);
+        acceptor = std::thread([this] { acceptLoop(); });
+    }
+
+    ~Server() {
+        stopping = true;
+        acceptor.join();
+        std::vector<std::thread> running;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running.swap(connections);
+        }
+        for (auto& connection : running) {
+            connection.join();
+        }
+        ::close(listener);
+    }
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    // "http://127.0.0.1:<port>"
+    std::string url() const { return "http://127.0.0.1:" + std::to_string(port); }
+
+    // Requests answered so far
+    int requests() const { return served; }
+
+private:
+    void acceptLoop() {
+        while (!stopping) {
+            pollfd ready{listener, POLLIN, 0};
+            if (::poll(&ready, 1, 20) <= 0) continue;
+            int socket = ::accept(listener, nullptr, nullptr);
+            if (socket < 0) continue;
+            std::lock_guard<std::mutex> lock(mutex);
+            connections.emplace_back([this, socket] { serve(socket); });
+        }
+    }
+
+    void serve(int socket) {
+        Request request;
+        if (read(socket, request)) {
+            Reply reply = handler(request);
+            ++served;
+            write(socket, request, reply);
+        }
+        ::shutdown(socket, SHUT_RDWR);
+        ::close(socket);
+    }
+
+    // Reads more bytes into `buffer`; false on EOF, error or shutdown
+    bool fill(int socket, std::string& buffer) {
+        for (;;) {
+            if (stopping) return false;
+            pollfd ready{socket, POLLIN, 0};
+            int polled = ::poll(&ready, 1, 20);
+            if (polled < 0) return false;
+            if (polled == 0) continue;
+            char chunk[16384];
+            ssize_t got = ::recv(socket, chunk, sizeof(chunk), 0);
+            if (got <= 0) return false;
+            buffer.append(chunk, static_cast<std::size_t>(got));
+            return true;
+        }
+    }
+
+    bool read(int socket, Request& request) {
+        std::string buffer;
+        std::size_t end;
+        while ((end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            if (!fill(socket, buffer)) return false;
+        }
+
+        std::size_t lineEnd = buffer.find("\r\n");
+        std::string line = buffer.substr(0, lineEnd);
+        std::size_t first = line.find(' ');
+        std::size_t second = line.find(' ', first + 1);
+        request.method = line.substr(0, first);
+        request.target = line.substr(first + 1, second - first - 1);
+        for (std::size_t at = lineEnd + 2; at < end;) {
+            std::size_t next = buffer.find("\r\n", at);
+            std::string field = buffer.substr(at, next - at);
+            at = next + 2;
+            std::size_t colon = field.find(':');
+            if (colon == std::string::npos) continue;
+            std::string name = field.substr(0, colon);
+            std::transform(name.begin(), name.end(), name.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            std::size_t value = field.find_first_not_of(' ', colon + 1);
+            request.headers[name] = value == std::string::npos ? std::string() : field.substr(value);
+        }
+        buffer.erase(0, end + 4);
+
+        if (request.header("expect") == "100-continue") {
+            sendAll(socket, "HTTP/1.1 100 Continue\r\n\r\n");
+        }
+        if (request.header("transfer-encoding") == "chunked") {
+            for (;;) {
+                std::size_t sizeEnd;
+                while ((sizeEnd = buffer.find("\r\n")) == std::string::npos) {
+                    if (!fill(socket, buffer)) return false;
+                }
+                std::size_t size = std::stoul(buffer.substr(0, sizeEnd), nullptr, 16);
+                while (buffer.size() < sizeEnd + 2 + size + 2) {
+                    if (!fill(socket, buffer)) return false;
+                }
+                request.body.append(buffer, sizeEnd + 2, size);
+                buffer.erase(0, sizeEnd + 2 + size + 2);
+                if (size == 0) return true;
+            }
+        }
+        std::size_t length = std::stoul("0" + request.header("content-length"));
+        while (buffer.size() < length) {
+            if (!fill(socket, buffer)) return false;
+        }
+        request.body = buffer.substr(0, length);
+        return true;
+    }
+
+    void write(int socket, const Request& request, const Reply& reply) {
+        std::string head = "HTTP/1.1 " + std::to_string(reply.status) + " Stand-in\r\nConnection: close\r\n";
+        for (const auto& [name, value] : reply.headers) {
+            head += name + ": " + value + "\r\n";
+        }
+        bool bodyless = request.method == "HEAD" || reply.status == 204 || reply.status == 304;
+        if (reply.parts.empty() && !bodyless) {
+            head += "Content-Length: " + std::to_string(reply.body.size()) + "\r\n";
+        }
+        head += "\r\n";
+        if (!sendAll(socket, head) || bodyless) return;
+        if (reply.parts.empty()) {
+            sendAll(socket, reply.body);
+            return;
+        }
+        for (const auto& part : reply.parts) {
+            if (stopping || !sendAll(socket, part)) return;
+            std::this_thread::sleep_for(reply.pause);
+        }
+    }
+
+    static bool sendAll(int socket, const std::string& data) {
+        std::size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t written = ::send(socket, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (written <= 0) return false;
+            sent += static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+    Handler handler;
+    int listener = -1;
+    unsigned short port = 0;
+    std::atomic<bool> stopping{false};
+    std::atomic<int> served{0};
+    std::thread acceptor;
+    std::mutex mutex;
+    std::vector<std::thread> connections;
+};
+
+} // namespace test
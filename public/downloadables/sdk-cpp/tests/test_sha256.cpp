@@ -0,0 +1,44 @@
+// detail::Sha256 against the FIPS 180-2 known-answer vectors, fed in one go
+// and in uneven pieces that straddle the 64-byte block boundary.
+
+#include "croissant_api.hpp"
+#include "test_util.hpp"
+
+#include <algorithm>
+#include <string>
+
+using CroissantAPI::detail::Sha256;
+
+namespace {
+
+std::string digest(const std::string& message, std::size_t piece) {
+    Sha256 sha;
+    for (std::size_t at = 0; at < message.size(); at += piece) {
+        sha.update(message.data() + at, std::min(piece, message.size() - at));
+    }
+    return sha.hexDigest();
+}
+
+} // namespace
+
+int main() {
+    const std::string empty = "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+    const std::string abc = "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad";
+    const std::string twoBlocks = "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1";
+    const std::string millionA = "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0";
+
+    CHECK(Sha256().hexDigest() == empty);
+    CHECK(digest("abc", 3) == abc);
+    CHECK(digest("abc", 1) == abc);
+
+    // 56 bytes: the length no longer fits the first block's padding
+    const std::string pairs = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    CHECK(digest(pairs, pairs.size()) == twoBlocks);
+    CHECK(digest(pairs, 7) == twoBlocks);
+
+    const std::string million(1000000, 'a');
+    CHECK(digest(million, million.size()) == millionA);
+    CHECK(digest(million, 1000) == millionA);
+    CHECK(digest(million, 63) == millionA);
+    return test::result();
+}
@@ -0,0 +1,105 @@
+// detail::SseParser follows the HTML event-stream processing model whatever
+// the chunking: CR, LF and CRLF line ends (a CRLF may be split between two
+// chunks), a leading BOM, comments, multi-line data, id and retry fields.
+
+#include "croissant_api.hpp"
+#include "test_util.hpp"
+
+using namespace CroissantAPI;
+
+namespace {
+
+struct Parsed {
+    std::vector<PushEvent> events;
+    std::string lastId;
+    std::optional<std::chrono::milliseconds> retry;
+    std::uint64_t comments = 0;
+};
+
+// Feeds `stream` in pieces cut at `cuts`
+Parsed parse(std::string_view stream, const std::vector<std::size_t>& cuts, std::string lastId = "") {
+    detail::SseParser parser(std::move(lastId));
+    Parsed parsed;
+    std::size_t at = 0;
+    auto collect = [&parsed](PushEvent&& event) { parsed.events.push_back(std::move(event)); };
+    for (std::size_t cut : cuts) {
+        parser.feed(stream.substr(at, cut - at), collect);
+        at = cut;
+    }
+    parser.feed(stream.substr(at), collect);
+    parsed.lastId = parser.lastId;
+    parsed.retry = parser.retry;
+    parsed.comments = parser.comments;
+    return parsed;
+}
+
+bool same(const Parsed& a, const Parsed& b) {
+    if (a.events.size() != b.events.size() || a.lastId != b.lastId || a.retry != b.retry || a.comments != b.comments) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.events.size(); ++i) {
+        if (a.events[i].type != b.events[i].type || a.events[i].id != b.events[i].id ||
+            a.events[i].data != b.events[i].data) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool is(const PushEvent& event, const std::string& type, const std::string& id, const std::string& data) {
+    return event.type == type && event.id == id && event.data == data;
+}
+
+} // namespace
+
+int main() {
+    const char raw[] =
+        "\xEF\xBB\xBF"
+        "event: greet\r\ndata: hello\r\ndata:  world\r\nid: 7\r\n\r\n" // CRLF, two data lines
+        ": keep-alive\n"                                                // comment
+        "data:no space\rretry: 2500\r\r"                               // bare CR
+        "retry: soon\n"                                                // not a number: ignored
+        "event: empty\n\n"                                             // no data: nothing dispatched
+        "data\ndata: x\nid\n\n"                                        // field without colon
+        ":another\r\n"
+        "id: a\0b\ndata: y\n\n"                                        // id with NUL: ignored
+        "data: unfinished\n";                                          // no blank line yet
+    const std::string stream(raw, sizeof raw - 1);
+
+    std::string_view view(stream);
+    Parsed whole = parse(view, {});
+    CHECK(whole.events.size() == 4);
+    CHECK(is(whole.events[0], "greet", "7", "hello\n world"));
+    CHECK(is(whole.events[1], "message", "7", "no space"));
+    CHECK(is(whole.events[2], "message", "", "\nx"));
+    CHECK(is(whole.events[3], "message", "", "y"));
+    CHECK(whole.retry == std::optional<std::chrono::milliseconds>(2500));
+    CHECK(whole.comments == 2);
+    CHECK(whole.lastId.empty());
+
+    // Any split into two or three chunks, including inside "\r\n" and the BOM
+    for (std::size_t first = 0; first <= stream.size(); ++first) {
+        CHECK(same(parse(view, {first}), whole));
+        for (std::size_t second = first; second <= stream.size(); second += 7) {
+            CHECK(same(parse(view, {first, second}), whole));
+        }
+    }
+    // One byte at a time
+    std::vector<std::size_t> bytes;
+    for (std::size_t i = 1; i < stream.size(); ++i) bytes.push_back(i);
+    CHECK(same(parse(view, bytes), whole));
+
+    // The last ID of the previous connection carries over until the stream sends one
+    Parsed resumed = parse("data: a\n\nid: 9\ndata: b\n\n", {}, "41");
+    CHECK(resumed.events.size() == 2);
+    CHECK(is(resumed.events[0], "message", "41", "a"));
+    CHECK(is(resumed.events[1], "message", "9", "b"));
+    CHECK(resumed.lastId == "9");
+    CHECK(!resumed.retry);
+
+    // A BOM is only skipped at the start of the stream
+    Parsed bomLater = parse("data: a\n\n\xEF\xBB\xBF" "data: b\n\n", {});
+    CHECK(bomLater.events.size() == 1);
+
+    return test::result();
+}
@@ -0,0 +1,24 @@
+#pragma once
+// Minimal check macro for the regression tests: a failed CHECK is reported
+// and makes the test exit non-zero, without stopping the remaining checks.
+
+#include <cstdio>
+
+namespace test {
+
+inline int failures = 0;
+
+inline int result() {
+    if (failures) std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
+
+} // namespace test
+
+#define CHECK(condition)                                                            \
+    do {                                                                            \
+        if (!(condition)) {                                                         \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++test::failures;                                                       \
+        }                                                                           \
+    } while (false)
@@ -0,0 +1,107 @@
+// The diffs behind LobbyWatcher and TradeWatcher: players joining and leaving
+// a lobby, and per-item amount changes on each side of a trade, with
+// duplicate itemIds summed first.
+
+#include "croissant_api.hpp"
+#include "test_util.hpp"
+
+using namespace CroissantAPI;
+
+namespace {
+
+LobbyUser player(const std::string& id) {
+    LobbyUser user;
+    user.user_id = id;
+    user.username = "name-" + id;
+    user.verified = false;
+    return user;
+}
+
+TradeItemDetail item(const std::string& id, int amount, const std::string& name = "") {
+    TradeItemDetail detail;
+    detail.itemId = id;
+    detail.name = name.empty() ? id : name;
+    detail.amount = amount;
+    return detail;
+}
+
+bool is(const LobbyEvent& event, LobbyEventKind kind, const std::string& userId) {
+    return event.kind == kind && event.lobbyId == "L" && event.user.user_id == userId;
+}
+
+} // namespace
+
+int main() {
+    // diffUsers: a merge over both sorted lists
+    {
+        std::vector<LobbyEvent> events;
+        detail::diffUsers("L", {}, {player("a"), player("b")}, events);
+        CHECK(events.size() == 2);
+        CHECK(is(events[0], LobbyEventKind::Joined, "a"));
+        CHECK(is(events[1], LobbyEventKind::Joined, "b"));
+
+        events.clear();
+        detail::diffUsers("L", {player("a"), player("c"), player("d")}, {player("b"), player("c"), player("e")}, events);
+        CHECK(events.size() == 4);
+        CHECK(is(events[0], LobbyEventKind::Left, "a"));
+        CHECK(is(events[1], LobbyEventKind::Joined, "b"));
+        CHECK(is(events[2], LobbyEventKind::Left, "d"));
+        CHECK(is(events[3], LobbyEventKind::Joined, "e"));
+        CHECK(events[2].user.username == "name-d");
+
+        events.clear();
+        detail::diffUsers("L", {player("a"), player("b")}, {player("a"), player("b")}, events);
+        CHECK(events.empty());
+
+        detail::diffUsers("L", {player("a"), player("b")}, {}, events);
+        CHECK(events.size() == 2);
+        CHECK(is(events[0], LobbyEventKind::Left, "a"));
+        CHECK(is(events[1], LobbyEventKind::Left, "b"));
+    }
+
+    // itemsById: duplicates are summed and the last entry's details win
+    {
+        std::vector<TradeItemDetail> items = {item("sword", 2, "Old sword"), item("gem", 1), item("sword", 3, "Sword"),
+                                              item("gem", 1)};
+        auto byId = detail::itemsById(items);
+        CHECK(byId.size() == 2);
+        CHECK(byId["sword"].amount == 5);
+        CHECK(byId["sword"].name == "Sword");
+        CHECK(byId["gem"].amount == 2);
+
+        std::vector<TradeItemDetail> none;
+        CHECK(detail::itemsById(none).empty());
+    }
+
+    // diffItems: added, removed and re-counted items; unchanged ones are skipped
+    {
+        std::map<std::string, TradeItemDetail> previous = {
+            {"a", item("a", 1, "Apple")}, {"b", item("b", 2)}, {"c", item("c", 3)}};
+        std::map<std::string, TradeItemDetail> next = {{"b", item("b", 2)}, {"c", item("c", 5)}, {"d", item("d", 1)}};
+        std::vector<TradeItemChange> changes;
+        detail::diffItems(false, previous, next, changes);
+        CHECK(changes.size() == 3);
+
+        CHECK(changes[0].itemId == "a");
+        CHECK(changes[0].previousAmount == 1 && changes[0].amount == 0);
+        CHECK(changes[0].item.name == "Apple");
+        CHECK(changes[1].itemId == "c");
+        CHECK(changes[1].previousAmount == 3 && changes[1].amount == 5);
+        CHECK(changes[2].itemId == "d");
+        CHECK(changes[2].previousAmount == 0 && changes[2].amount == 1);
+        for (const auto& change : changes) {
+            CHECK(!change.fromUser);
+        }
+
+        changes.clear();
+        detail::diffItems(true, {}, previous, changes);
+        CHECK(changes.size() == 3);
+        CHECK(changes[0].fromUser && changes[0].amount == 1 && changes[0].previousAmount == 0);
+
+        changes.clear();
+        detail::diffItems(true, next, next, changes);
+        CHECK(changes.empty());
+    }
+
+    return test::result();
+}
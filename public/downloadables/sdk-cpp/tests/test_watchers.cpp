@@ -0,0 +1,243 @@
+// LobbyWatcher and TradeWatcher against a loopback stand-in: conditional
+// polls answered 304 leave the watched state alone, a 404 lobby reports its
+// players as Left and then Closed, and trade snapshots are diffed into
+// opened, item, approval and status changes.
+
+#include "croissant_api.hpp"
+#include "test_server.hpp"
+#include "test_util.hpp"
+
+using namespace CroissantAPI;
+
+namespace {
+
+// Polls `condition` for up to five seconds
+template <typename Condition>
+bool waitFor(Condition condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+LobbyUser player(const std::string& id) {
+    LobbyUser user;
+    user.user_id = id;
+    user.username = "name-" + id;
+    user.verified = true;
+    return user;
+}
+
+TradeItemDetail item(const std::string& id, int amount) {
+    TradeItemDetail detail;
+    detail.itemId = id;
+    detail.name = id;
+    detail.description = "";
+    detail.iconHash = "";
+    detail.amount = amount;
+    return detail;
+}
+
+Trade trade(const std::string& id, const std::string& status, const std::string& updatedAt) {
+    Trade t;
+    t.id = id;
+    t.fromUserId = "me";
+    t.toUserId = "them";
+    t.approvedFromUser = false;
+    t.approvedToUser = false;
+    t.status = status;
+    t.createdAt = "2026-01-01";
+    t.updatedAt = updatedAt;
+    return t;
+}
+
+// Answers with `body` and an ETag of `version`, or 304 when the client already has it
+test::Reply conditional(const test::Request& request, int version, std::string body) {
+    std::string etag = "\"" + std::to_string(version) + "\"";
+    test::Reply reply;
+    reply.headers.emplace_back("ETag", etag);
+    if (request.header("if-none-match") == etag) {
+        reply.status = 304;
+        return reply;
+    }
+    reply.headers.emplace_back("Content-Type", "application/json");
+    reply.body = std::move(body);
+    return reply;
+}
+
+void lobbies() {
+    std::mutex mutex;
+    int stage = 0;
+    std::vector<LobbyEvent> events;
+
+    test::Server server([&](const test::Request& request) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (request.target != "/api/lobbies/L" || stage == 2) return test::Reply{404};
+        Lobby lobby;
+        lobby.lobbyId = "L";
+        lobby.users = stage == 0 ? std::vector<LobbyUser>{player("u2"), player("u1")}
+                                 : std::vector<LobbyUser>{player("u3"), player("u2")};
+        return conditional(request, stage, lobby.to_json().dump());
+    });
+    Client client;
+    client.setBaseUrl(server.url() + "/api");
+
+    LobbyWatchOptions options;
+    options.minInterval = std::chrono::milliseconds(5);
+    options.maxInterval = std::chrono::milliseconds(20);
+    LobbyWatcher watcher(client, [&](const LobbyEvent& event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        events.push_back(event);
+    }, options);
+    watcher.watch("L");
+
+    auto eventCount = [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return events.size();
+    };
+
+    // Everyone already in the lobby joins, in user_id order
+    CHECK(waitFor([&] { return eventCount() == 2; }));
+    CHECK(waitFor([&] { return watcher.stats().notModified >= 3; }));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK(events.size() == 2);
+        CHECK(events[0].kind == LobbyEventKind::Joined && events[0].user.user_id == "u1");
+        CHECK(events[1].kind == LobbyEventKind::Joined && events[1].user.user_id == "u2");
+        stage = 1;
+    }
+
+    // u1 left and u3 joined; u2 stayed
+    CHECK(waitFor([&] { return eventCount() == 4; }));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK(events[2].kind == LobbyEventKind::Left && events[2].user.user_id == "u1");
+        CHECK(events[3].kind == LobbyEventKind::Joined && events[3].user.user_id == "u3");
+        stage = 2;
+    }
+
+    // The lobby is gone: its players leave, then it closes and is no longer watched
+    CHECK(waitFor([&] { return eventCount() == 7; }));
+    CHECK(waitFor([&] { return watcher.size() == 0; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK(events.size() == 7);
+    CHECK(events[4].kind == LobbyEventKind::Left && events[4].user.user_id == "u2");
+    CHECK(events[5].kind == LobbyEventKind::Left && events[5].user.user_id == "u3");
+    CHECK(events[6].kind == LobbyEventKind::Closed && events[6].user.user_id.empty());
+    CHECK(watcher.stats().failed == 0);
+}
+
+void trades() {
+    std::mutex mutex;
+    int version = 0;
+    std::vector<Trade> listed;
+    std::vector<TradeChange> changes;
+
+    Trade done = trade("T0", "completed", "1");
+    Trade open = trade("T1", "pending", "1");
+    open.fromUserItems = {item("sword", 1), item("gem", 1), item("sword", 2)};
+    listed = {done, open};
+
+    test::Server server([&](const test::Request& request) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (request.target != "/api/trades/user/me" || request.header("authorization") != "Bearer secret") {
+            return test::Reply{404};
+        }
+        json body = json::array();
+        for (const Trade& t : listed) body.push_back(t.to_json());
+        return conditional(request, version, body.dump());
+    });
+    Client client("secret");
+    client.setBaseUrl(server.url() + "/api");
+
+    TradeWatchOptions options;
+    options.minInterval = std::chrono::milliseconds(5);
+    options.maxInterval = std::chrono::milliseconds(20);
+    TradeWatcher watcher(client, "me", [&](const TradeChange& change) {
+        std::lock_guard<std::mutex> lock(mutex);
+        changes.push_back(change);
+    }, options);
+
+    auto changeCount = [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return changes.size();
+    };
+    auto publish = [&](const Trade& t) {
+        std::lock_guard<std::mutex> lock(mutex);
+        listed = {done, t};
+        ++version;
+    };
+
+    // The completed trade is recorded silently; the pending one opens with
+    // its duplicate swords summed
+    CHECK(waitFor([&] { return changeCount() == 1; }));
+    CHECK(waitFor([&] { return watcher.stats().notModified >= 3; }));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK(changes.size() == 1);
+        const TradeChange& opened = changes[0];
+        CHECK(opened.tradeId == "T1");
+        CHECK(opened.opened);
+        CHECK(opened.status == std::optional<std::string>("pending"));
+        CHECK(opened.approvedFromUser == std::optional<bool>(false));
+        CHECK(opened.approvedToUser == std::optional<bool>(false));
+        CHECK(opened.items.size() == 2);
+        CHECK(opened.items[0].itemId == "gem" && opened.items[0].amount == 1);
+        CHECK(opened.items[1].itemId == "sword" && opened.items[1].amount == 3 && opened.items[1].previousAmount == 0);
+        CHECK(opened.items[1].fromUser);
+    }
+    CHECK(watcher.stats().diffed == 2);
+
+    // Items move on both sides and one approval flips
+    open.updatedAt = "2";
+    open.fromUserItems = {item("sword", 3)};
+    open.toUserItems = {item("coin", 5)};
+    open.approvedFromUser = true;
+    publish(open);
+    CHECK(waitFor([&] { return changeCount() == 2; }));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const TradeChange& change = changes[1];
+        CHECK(!change.opened);
+        CHECK(change.items.size() == 2);
+        CHECK(change.items[0].fromUser && change.items[0].itemId == "gem");
+        CHECK(change.items[0].previousAmount == 1 && change.items[0].amount == 0);
+        CHECK(!change.items[1].fromUser && change.items[1].itemId == "coin");
+        CHECK(change.items[1].previousAmount == 0 && change.items[1].amount == 5);
+        CHECK(change.approvedFromUser == std::optional<bool>(true));
+        CHECK(!change.approvedToUser);
+        CHECK(!change.status);
+    }
+
+    // A trade whose updatedAt did not move is not diffed
+    std::uint64_t diffed = watcher.stats().diffed;
+    open.approvedToUser = true;
+    publish(open);
+    std::uint64_t requests = watcher.stats().requests;
+    CHECK(waitFor([&] { return watcher.stats().requests >= requests + 3; }));
+    CHECK(changeCount() == 2);
+    CHECK(watcher.stats().diffed == diffed);
+
+    // Status and the second approval
+    open.updatedAt = "3";
+    open.status = "completed";
+    publish(open);
+    CHECK(waitFor([&] { return changeCount() == 3; }));
+    std::lock_guard<std::mutex> lock(mutex);
+    const TradeChange& closed = changes[2];
+    CHECK(closed.items.empty());
+    CHECK(closed.status == std::optional<std::string>("completed"));
+    CHECK(closed.approvedToUser == std::optional<bool>(true));
+    CHECK(!closed.approvedFromUser);
+}
+
+} // namespace
+
+int main() {
+    lobbies();
+    trades();
+    return test::result();
+}
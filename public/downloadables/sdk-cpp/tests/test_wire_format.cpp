@@ -0,0 +1,196 @@
+// Wire format negotiation against a loopback stand-in: Accept is only sent
+// once a binary format is selected, MessagePack and CBOR answers are decoded
+// by Content-Type, request bodies turn binary only after the server answered
+// in that format, and a 415 sends the body again as JSON.
+
+#include "croissant_api.hpp"
+#include "test_server.hpp"
+#include "test_util.hpp"
+
+using namespace CroissantAPI;
+
+namespace {
+
+Game sample() {
+    Game g;
+    g.gameId = "g1";
+    g.name = "Space Quest";
+    g.description = "Point and click";
+    g.price = 12.5;
+    g.owner_id = "owner";
+    g.showInStore = true;
+    g.genre = "Adventure";
+    g.rating = 4.5;
+    g.multiplayer = false;
+    return g;
+}
+
+struct Seen {
+    std::string method;
+    std::string accept;
+    std::string contentType;
+    std::string body;
+};
+
+// Answers in the first format the client accepts, unless `jsonOnly`; binary
+// request bodies are refused with 415 while `refuseBinary` is set
+struct Api {
+    std::mutex mutex;
+    std::vector<Seen> seen;
+    std::atomic<bool> jsonOnly{false};
+    std::atomic<bool> refuseBinary{false};
+    std::atomic<bool> corrupt{false};
+
+    test::Reply operator()(const test::Request& request) {
+        std::string contentType = request.header("content-type");
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            seen.push_back(Seen{request.method, request.header("accept"), contentType, request.body});
+        }
+        bool binaryBody = contentType != "application/json";
+        if (binaryBody && refuseBinary) return test::Reply{415};
+
+        json data;
+        if (request.target == "/api/games/g1") {
+            data = sample().to_json();
+        } else if (request.target == "/api/studios" && request.method == "POST") {
+            json body = contentType == "application/msgpack" ? json::from_msgpack(request.body, true, false)
+                        : contentType == "application/cbor"  ? json::from_cbor(request.body, true, false)
+                                                             : json::parse(request.body, nullptr, false);
+            data = {{"message", "Studio " + body.value("studioName", std::string("?")) + " created"}};
+        } else {
+            return test::Reply{404};
+        }
+
+        test::Reply reply;
+        std::string accept = request.header("accept");
+        if (!jsonOnly && accept.rfind("application/msgpack", 0) == 0) {
+            auto bytes = json::to_msgpack(data);
+            reply.body.assign(bytes.begin(), bytes.end());
+            reply.headers.emplace_back("Content-Type", "application/msgpack");
+        } else if (!jsonOnly && accept.rfind("application/cbor", 0) == 0) {
+            auto bytes = json::to_cbor(data);
+            reply.body.assign(bytes.begin(), bytes.end());
+            reply.headers.emplace_back("Content-Type", "application/cbor");
+        } else {
+            reply.body = data.dump();
+            reply.headers.emplace_back("Content-Type", "application/json; charset=utf-8");
+        }
+        if (corrupt) reply.body.resize(reply.body.size() / 2);
+        return reply;
+    }
+
+    Seen last() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return seen.back();
+    }
+
+    std::size_t count() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return seen.size();
+    }
+};
+
+bool isSample(const Game& game) {
+    return game.gameId == "g1" && game.name == "Space Quest" && game.price == 12.5 && game.genre == std::optional<std::string>("Adventure") &&
+           game.rating == 4.5;
+}
+
+} // namespace
+
+int main() {
+    Api api;
+    test::Server server([&api](const test::Request& request) { return api(request); });
+    Client client("secret");
+    client.setBaseUrl(server.url() + "/api");
+
+    // JSON by default: nothing to negotiate
+    {
+        auto game = client.games.get("g1");
+        CHECK(game && isSample(*game));
+        CHECK(api.last().accept.find("msgpack") == std::string::npos);
+        CHECK(api.last().accept.find("cbor") == std::string::npos);
+
+        auto created = client.studios.create("Alpha");
+        CHECK(created.success);
+        CHECK(api.last().contentType == "application/json");
+        CHECK(json::parse(api.last().body) == json({{"studioName", "Alpha"}}));
+    }
+
+    // MessagePack: the answer is decoded by its Content-Type, and once the
+    // server has answered in it, request bodies follow
+    {
+        client.setWireFormat(WireFormat::MessagePack);
+        CHECK(client.getWireFormat() == WireFormat::MessagePack);
+
+        auto created = client.studios.create("Beta");
+        CHECK(created.success);
+        CHECK(created.message == "Studio Beta created");
+        CHECK(api.last().accept == "application/msgpack, application/json;q=0.5");
+        CHECK(api.last().contentType == "application/json");
+
+        auto game = client.games.get("g1");
+        CHECK(game && isSample(*game));
+        auto tried = client.games.tryGet("g1");
+        CHECK(tried && isSample(tried.value()));
+
+        created = client.studios.create("Gamma");
+        CHECK(created.success);
+        CHECK(created.message == "Studio Gamma created");
+        CHECK(api.last().contentType == "application/msgpack");
+        CHECK(json::from_msgpack(api.last().body) == json({{"studioName", "Gamma"}}));
+    }
+
+    // 415: the same request goes out again as JSON, and later bodies stay JSON
+    // until the server answers in MessagePack again
+    {
+        api.refuseBinary = true;
+        api.jsonOnly = true;
+        std::size_t before = api.count();
+        auto created = client.studios.create("Delta");
+        CHECK(created.success);
+        CHECK(created.message == "Studio Delta created");
+        CHECK(api.count() == before + 2);
+        CHECK(api.last().contentType == "application/json");
+        {
+            std::lock_guard<std::mutex> lock(api.mutex);
+            CHECK(api.seen[before].contentType == "application/msgpack");
+        }
+
+        created = client.studios.create("Epsilon");
+        CHECK(created.success);
+        CHECK(api.count() == before + 3);
+        CHECK(api.last().contentType == "application/json");
+        api.refuseBinary = false;
+        api.jsonOnly = false;
+    }
+
+    // CBOR, through both the APIResponse and the Result paths; selecting a
+    // format starts over with JSON bodies
+    {
+        client.setWireFormat(WireFormat::Cbor);
+        auto game = client.games.get("g1");
+        CHECK(game && isSample(*game));
+        CHECK(api.last().accept == "application/cbor, application/json;q=0.5");
+        auto tried = client.games.tryGet("g1");
+        CHECK(tried && isSample(tried.value()));
+
+        client.setWireFormat(WireFormat::Cbor);
+        client.studios.create("Zeta");
+        CHECK(api.last().contentType == "application/json");
+        client.studios.create("Eta");
+        CHECK(api.last().contentType == "application/cbor");
+        CHECK(json::from_cbor(api.last().body) == json({{"studioName", "Eta"}}));
+    }
+
+    // A truncated binary answer is a Parse error, not an exception
+    {
+        api.corrupt = true;
+        auto tried = client.games.tryGet("g1");
+        CHECK(!tried);
+        CHECK(!tried && tried.error().code == ErrorCode::Parse);
+        api.corrupt = false;
+    }
+
+    return test::result();
+}